@@ -186,9 +186,49 @@ def Plotline(LD, dir=0, pos=(0,0,0), comp=0,filename=None, title=''):
                 plt.savefig(filename)
                 plt.close()
 
-    
-
-
-
-
 
+def ReadProbe(filename):
+    """
+    Reads the slice, line or points written in situ by SOMAR (see the
+    output.probe* options). filename is the .dat or .hdr file.
+    Returns a dictionary with the header entries and
+        'step', 'time' -- one entry per record,
+        'data'         -- data[record, comp, ...], where ... is the shape of
+                          the slice, line or list of points.
+    The files are appended to across restarts, so a step can appear more than
+    once. Only its last record is kept.
+    """
+    base=filename[:-4] if filename.endswith(('.dat','.hdr')) else filename
+
+    hdr={}
+    with open(base+'.hdr') as f:
+        for line in f:
+            if line.startswith('#') or '=' not in line:
+                continue
+            key,val=[s.strip() for s in line.split('=',1)]
+            hdr.setdefault(key,[]).append(val)
+    hdr={k:(v[0] if len(v)==1 else v) for k,v in hdr.items()}
+
+    comps=hdr['comps'].split()
+    shape=tuple(int(n) for n in hdr['shape'].split())
+    dtype=np.float64 if int(hdr['bytesPerReal'])==8 else np.float32
+
+    recSize=2+len(comps)*int(np.prod(shape))
+    raw=np.fromfile(base+'.dat',dtype=dtype)
+    raw=raw[:(raw.size//recSize)*recSize].reshape(-1,recSize)
+
+    # Keep the last record of each step.
+    step=raw[:,0].astype(int)
+    last=np.sort(len(step)-1-np.unique(step[::-1],return_index=True)[1])
+    raw=raw[last]
+
+    # The samples were written with the first direction fastest.
+    data=raw[:,2:].reshape((len(raw),len(comps))+shape[::-1])
+    data=data.transpose((0,1)+tuple(range(len(shape)+1,1,-1)))
+
+    hdr['comps']=comps
+    hdr['shape']=shape
+    hdr['step']=step[last]
+    hdr['time']=raw[:,1]
+    hdr['data']=data
+    return hdr
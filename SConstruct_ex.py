@@ -95,6 +95,9 @@ OtherLibs.append('lapack')
 OtherLibs.append('m')
 if Flags.OpenMP:
     OtherLibs.append('gomp')
+if Flags.HDF5:
+    OtherLibs.append('hdf5')
+    OtherLibs.append('pthread') # for output.asyncPlot
 
 # This is needed whenever a ChF file is in the exec folder. -ES
 # if Flags.StaticLib or Flags.Debug:
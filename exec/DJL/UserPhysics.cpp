@@ -28,6 +28,7 @@
 #include "IO.H"
 #include "Subspace.H"
 #include "Comm.H"
+#include "ThreadTools.H"
 
 
 // Static members
@@ -242,187 +243,202 @@ UserPhysics::getLayer_eta_z(const Real a_z)
 
 // -----------------------------------------------------------------------------
 void
-UserPhysics::computeVelSoln(LevelData<FluxBox>& a_vel, const Real a_time) const
+UserPhysics::defineLayerSplines() const
 {
-    const auto&     grids  = m_levGeoPtr->getBoxes();
-    const auto&     domBox = m_levGeoPtr->getDomainBox();
-    const Real      minX   = s_src.x.front();
-    const Real      maxX   = s_src.x.back();
-
-    if constexpr (SpaceDim == 2) {
-
-        IntVect iv = domBox.smallEnd();
-        for (size_t k = 0; k < (size_t)domBox.size(SpaceDim-1); ++k, ++iv[SpaceDim - 1]) {
-
-            // Create spline of this layer's eta
-            const Real z = m_levGeoPtr->getCellX(SpaceDim - 1, iv);
-
-            CubicSpline eta_z;
-            eta_z.solve(UserPhysics::getLayer_eta_z(z), s_src.x, 0.0, 0.0);
-
-            for (DataIterator dit(grids); dit.ok(); ++dit) {
-                const Box ccValid = grids[dit];
-                if (iv[SpaceDim - 1] < ccValid.smallEnd(SpaceDim - 1)) continue;
-                if (ccValid.bigEnd(SpaceDim - 1) < iv[SpaceDim - 1]) continue;
-
-                // Compute u = cos(theta) * c * eta_z
-                iv[0] = ccValid.smallEnd(0);
-                size_t i = iv[0] - domBox.smallEnd(0);
-                for (; iv[0] <= ccValid.bigEnd(0) + 1; ++iv[0], ++i) {
-                    const Real x      = m_levGeoPtr->getFaceX(0, iv, 0) - s_xOffset - s_src.c * a_time;
-                    const Real interp = (minX <= x && x <= maxX) ? eta_z.interp(x) : 0.0;
-
-                    a_vel[dit][0](iv) = s_src.c * interp;
-                } // i
+    const auto&   grids  = m_levGeoPtr->getBoxes();
+    const auto&   domBox = m_levGeoPtr->getDomainBox();
+    constexpr int zdir   = SpaceDim - 1;
+
+    // A new domain means new layer positions.
+    if (m_layerSplineDomBox != domBox) {
+        m_ccLayerSplines.clear();
+        m_fcLayerSplines.clear();
+        m_layerSplineDomBox = domBox;
+    }
 
-                if constexpr (SpaceDim == 3) {
-                    a_vel[dit][1].setVal(0.0);
-                }
-            } // dit
-        } // k
+    // Collect the layers that our boxes touch, but have not been built yet.
+    // The map insertions must be done serially.
+    std::vector<LayerSplines*> newCCLayers, newFCLayers;
+    for (DataIterator dit(grids); dit.ok(); ++dit) {
+        const Box& ccValid = grids[dit];
+        IntVect    iv      = domBox.smallEnd();
+
+        for (iv[zdir] = ccValid.smallEnd(zdir);
+             iv[zdir] <= ccValid.bigEnd(zdir) + 1;
+             ++iv[zdir]) {
+            if (iv[zdir] <= ccValid.bigEnd(zdir) &&
+                m_ccLayerSplines.count(iv[zdir]) == 0) {
+                LayerSplines& layer = m_ccLayerSplines[iv[zdir]];
+                layer.z = m_levGeoPtr->getCellX(zdir, iv);
+                newCCLayers.push_back(&layer);
+            }
 
-        // Loop over each nodal vertical layer to compute w.
-        iv = domBox.smallEnd();
-        for (size_t k = 0; k < (size_t)domBox.size(SpaceDim-1) + 1; ++k, ++iv[SpaceDim - 1]) {
-            // Create spline of this layer's eta
-            const Real z = m_levGeoPtr->getFaceX(SpaceDim - 1, iv, SpaceDim - 1);
-
-            CubicSpline eta;
-            eta.solve(UserPhysics::getLayer_eta(z), s_src.x, 0.0, 0.0);
-
-            for (DataIterator dit(grids); dit.ok(); ++dit) {
-                const Box fcValid = grids[dit].surroundingNodes(SpaceDim - 1);
-                if (iv[SpaceDim - 1] < fcValid.smallEnd(SpaceDim - 1)) continue;
-                if (fcValid.bigEnd(SpaceDim - 1) < iv[SpaceDim - 1]) continue;
-
-                // Compute w = -c * eta_x
-                iv[0] = fcValid.smallEnd(0);
-                size_t i = iv[0] - domBox.smallEnd(0);
-                for (; iv[0] <= fcValid.bigEnd(0); ++iv[0], ++i) {
-                    const Real x      = m_levGeoPtr->getFaceX(0, iv, SpaceDim - 1) - s_xOffset - s_src.c * a_time;
-                    const Real interp = (minX <= x && x <= maxX) ? eta.interpFirstDeriv(x) : 0.0;
-
-                    a_vel[dit][SpaceDim - 1](iv) = -s_src.c * interp;
-                } // i
-            } // dit
+            if (m_fcLayerSplines.count(iv[zdir]) == 0) {
+                LayerSplines& layer = m_fcLayerSplines[iv[zdir]];
+                layer.z = m_levGeoPtr->getFaceX(zdir, iv, zdir);
+                newFCLayers.push_back(&layer);
+            }
         } // k
+    } // dit
+
+    // Solve for the new splines. Each layer is independent.
+    const int numNewCC = newCCLayers.size();
+    OMP_PARALLEL_FOR
+    for (int idx = 0; idx < numNewCC; ++idx) {
+        LayerSplines& layer = *newCCLayers[idx];
+        layer.eta.solve(UserPhysics::getLayer_eta(layer.z), s_src.x, 0.0, 0.0);
+        layer.eta_z.solve(UserPhysics::getLayer_eta_z(layer.z), s_src.x, 0.0, 0.0);
+    }
 
-    } else {
+    const int numNewFC = newFCLayers.size();
+    OMP_PARALLEL_FOR
+    for (int idx = 0; idx < numNewFC; ++idx) {
+        LayerSplines& layer = *newFCLayers[idx];
+        layer.eta.solve(UserPhysics::getLayer_eta(layer.z), s_src.x, 0.0, 0.0);
+    }
+}
 
-        const Real  cosTheta = cos(s_rotAngle);
-        const Real  sinTheta = sin(s_rotAngle);
 
-        IntVect iv = domBox.smallEnd();
-        for (size_t k = 0; k < (size_t)domBox.size(SpaceDim-1); ++k, ++iv[SpaceDim - 1]) {
+// -----------------------------------------------------------------------------
+void
+UserPhysics::getLayerCoords(std::vector<Real>& a_xprime,
+                            std::vector<Real>& a_env,
+                            const Box&         a_layer,
+                            const int          a_fcDir,
+                            const Real         a_time) const
+{
+    const size_t numPts = a_layer.numPts();
+    a_xprime.resize(numPts);
+    a_env.resize(numPts);
 
-            // Create spline of this layer's eta
-            const Real z = m_levGeoPtr->getCellX(SpaceDim - 1, iv);
+#if CH_SPACEDIM == 2
+    size_t idx = 0;
+    for (BoxIterator bit(a_layer); bit.ok(); ++bit, ++idx) {
+        const IntVect& iv = bit();
+        const Real x = ((a_fcDir < 0) ? m_levGeoPtr->getCellX(0, iv)
+                                      : m_levGeoPtr->getFaceX(0, iv, a_fcDir));
+
+        a_xprime[idx] = x - s_xOffset - s_src.c * a_time;
+        a_env[idx]    = 1.0;
+    }
+#else
+    const Real cosTheta = cos(s_rotAngle);
+    const Real sinTheta = sin(s_rotAngle);
+
+    size_t idx = 0;
+    for (BoxIterator bit(a_layer); bit.ok(); ++bit, ++idx) {
+        const IntVect& iv = bit();
+
+        Real x, y;
+        if (a_fcDir < 0) {
+            x = m_levGeoPtr->getCellX(0, iv) - s_xOffset;
+            y = m_levGeoPtr->getCellX(1, iv) - s_yOffset;
+        } else {
+            x = m_levGeoPtr->getFaceX(0, iv, a_fcDir) - s_xOffset;
+            y = m_levGeoPtr->getFaceX(1, iv, a_fcDir) - s_yOffset;
+        }
 
-            CubicSpline eta;
-            eta.solve(UserPhysics::getLayer_eta(z), s_src.x, 0.0, 0.0);
+        const Real yprime = -x * sinTheta + y * cosTheta;
 
-            CubicSpline eta_z;
-            eta_z.solve(UserPhysics::getLayer_eta_z(z), s_src.x, 0.0, 0.0);
+        a_xprime[idx] = x * cosTheta + y * sinTheta;
+        a_env[idx]    = UserPhysics::extrusionEnvelope(yprime);
+    }
+#endif
+}
 
-            for (DataIterator dit(grids); dit.ok(); ++dit) {
-                const Box ccValid = grids[dit];
-                if (iv[SpaceDim - 1] < ccValid.smallEnd(SpaceDim - 1)) continue;
-                if (ccValid.bigEnd(SpaceDim - 1) < iv[SpaceDim - 1]) continue;
 
-                // Compute u = cos(theta) * c * eta_z
-                iv[1] = ccValid.smallEnd(1);
-                int j = iv[1] - domBox.smallEnd(1);
-                for (; iv[1] <= ccValid.bigEnd(1); ++iv[1], ++j) {
+// -----------------------------------------------------------------------------
+// Evaluates a layer's spline (or its derivative) at each a_x. Points outside
+// of [a_minX, a_maxX] are set to zero.
+// -----------------------------------------------------------------------------
+static void
+interpLayer(std::vector<Real>&       a_f,
+            const CubicSpline&       a_spline,
+            const std::vector<Real>& a_x,
+            const Real               a_minX,
+            const Real               a_maxX,
+            const bool               a_firstDeriv)
+{
+    if (a_firstDeriv) {
+        a_spline.interpFirstDeriv(a_f, a_x);
+    } else {
+        a_spline.interp(a_f, a_x);
+    }
 
-                    iv[0] = ccValid.smallEnd(0);
-                    size_t i = iv[0] - domBox.smallEnd(0);
-                    for (; iv[0] <= ccValid.bigEnd(0) + 1; ++iv[0], ++i) {
+    for (size_t idx = 0; idx < a_x.size(); ++idx) {
+        if (a_x[idx] < a_minX || a_maxX < a_x[idx]) a_f[idx] = 0.0;
+    }
+}
 
-                        const Real x = m_levGeoPtr->getFaceX(0, iv, 0) - s_xOffset;
-                        const Real y = m_levGeoPtr->getFaceX(1, iv, 0) - s_yOffset;
 
-                        const Real xprime =  x * cosTheta + y * sinTheta;
-                        const Real yprime = -x * sinTheta + y * cosTheta;
+// -----------------------------------------------------------------------------
+void
+UserPhysics::computeVelSoln(LevelData<FluxBox>& a_vel, const Real a_time) const
+{
+    const auto&   grids = m_levGeoPtr->getBoxes();
+    const Real    minX  = s_src.x.front();
+    const Real    maxX  = s_src.x.back();
+    constexpr int zdir  = SpaceDim - 1;
 
-                        const Real env    = UserPhysics::extrusionEnvelope(yprime);
-                        const Real interp =
-                            (minX <= xprime && xprime <= maxX)
-                                ? eta_z.interp(xprime)
-                                : 0.0;
+    this->defineLayerSplines();
 
-                        a_vel[dit][0](iv) = env * cosTheta * s_src.c * interp;
-                    }  // i
-                } // j
+    std::vector<Real> xprime, env, interp;
 
-                // Compute v = -sin(theta) * c * eta_z
-                iv[1] = ccValid.smallEnd(1);
-                j = iv[1] - domBox.smallEnd(1);
-                for (; iv[1] <= ccValid.bigEnd(1) + 1; ++iv[1], ++j) {
+    for (DataIterator dit(grids); dit.ok(); ++dit) {
+        const Box& ccValid = grids[dit];
 
-                    iv[0] = ccValid.smallEnd(0);
-                    size_t i = iv[0] - domBox.smallEnd(0);
-                    for (; iv[0] <= ccValid.bigEnd(0); ++iv[0], ++i) {
+        // Horizontal velocities use eta_z from each CC layer.
+        for (int k = ccValid.smallEnd(zdir); k <= ccValid.bigEnd(zdir); ++k) {
+            const LayerSplines& layer = m_ccLayerSplines.at(k);
 
-                        const Real x = m_levGeoPtr->getFaceX(0, iv, 1) - s_xOffset;
-                        const Real y = m_levGeoPtr->getFaceX(1, iv, 1) - s_yOffset;
+            Box ccLayer = ccValid;
+            ccLayer.setRange(zdir, k);
 
-                        const Real xprime =  x * cosTheta + y * sinTheta;
-                        const Real yprime = -x * sinTheta + y * cosTheta;
+            for (int velComp = 0; velComp < SpaceDim - 1; ++velComp) {
+                const Box fcLayer = surroundingNodes(ccLayer, velComp);
 
-                        const Real env = UserPhysics::extrusionEnvelope(yprime);
-                        const Real interp =
-                            (minX <= xprime && xprime <= maxX)
-                                ? eta_z.interp(xprime)
-                                : 0.0;
+                this->getLayerCoords(xprime, env, fcLayer, velComp, a_time);
+                interpLayer(interp, layer.eta_z, xprime, minX, maxX, false);
 
-                        a_vel[dit][1](iv) = env * sinTheta * s_src.c * interp;
-                    }  // i
-                } // j
-            } // dit
+                // 2D: u = c * eta_z
+                // 3D: u = cos(theta) * c * eta_z, v = sin(theta) * c * eta_z
+#if CH_SPACEDIM == 2
+                const Real scale = s_src.c;
+#else
+                const Real scale = s_src.c * ((velComp == 0) ? cos(s_rotAngle)
+                                                             : sin(s_rotAngle));
+#endif
+                FArrayBox& velFAB = a_vel[dit][velComp];
+                size_t     idx    = 0;
+                for (BoxIterator bit(fcLayer); bit.ok(); ++bit, ++idx) {
+#if CH_SPACEDIM == 2
+                    velFAB(bit()) = scale * interp[idx];
+#else
+                    velFAB(bit()) = env[idx] * scale * interp[idx];
+#endif
+                }
+            } // velComp
         } // k
 
-        // Loop over each nodal vertical layer to compute w.
-        iv = domBox.smallEnd();
-        for (size_t k = 0; k < (size_t)domBox.size(SpaceDim-1) + 1; ++k, ++iv[SpaceDim - 1]) {
-
-            // Create spline of this layer's eta
-            const Real z = m_levGeoPtr->getFaceX(SpaceDim - 1, iv, SpaceDim - 1);
-
-            CubicSpline eta;
-            eta.solve(UserPhysics::getLayer_eta(z), s_src.x, 0.0, 0.0);
-
-            for (DataIterator dit(grids); dit.ok(); ++dit) {
-                const Box fcValid = grids[dit].surroundingNodes(SpaceDim - 1);
-                if (iv[SpaceDim - 1] < fcValid.smallEnd(SpaceDim - 1)) continue;
-                if (fcValid.bigEnd(SpaceDim - 1) < iv[SpaceDim - 1]) continue;
-
-                // Compute w = -c * eta_x
-                iv[1] = fcValid.smallEnd(1);
-                int j = iv[1] - domBox.smallEnd(1);
-                for (; iv[1] <= fcValid.bigEnd(1); ++iv[1], ++j) {
+        // The vertical velocity uses eta from each nodal layer.
+        // w = -c * eta_x
+        const Box fcValid = surroundingNodes(ccValid, zdir);
+        for (int k = fcValid.smallEnd(zdir); k <= fcValid.bigEnd(zdir); ++k) {
+            const LayerSplines& layer = m_fcLayerSplines.at(k);
 
-                    iv[0] = fcValid.smallEnd(0);
-                    size_t i = iv[0] - domBox.smallEnd(0);
-                    for (; iv[0] <= fcValid.bigEnd(0); ++iv[0], ++i) {
+            Box fcLayer = fcValid;
+            fcLayer.setRange(zdir, k);
 
-                        const Real x = m_levGeoPtr->getFaceX(0, iv, SpaceDim - 1) - s_xOffset;
-                        const Real y = m_levGeoPtr->getFaceX(1, iv, SpaceDim - 1) - s_yOffset;
+            this->getLayerCoords(xprime, env, fcLayer, zdir, a_time);
+            interpLayer(interp, layer.eta, xprime, minX, maxX, true);
 
-                        const Real xprime =  x * cosTheta + y * sinTheta;
-                        const Real yprime = -x * sinTheta + y * cosTheta;
-
-                        const Real env = UserPhysics::extrusionEnvelope(yprime);
-                        const Real interp =
-                            (minX <= xprime && xprime <= maxX)
-                                ? eta.interpFirstDeriv(xprime)
-                                : 0.0;
-
-                        a_vel[dit][SpaceDim - 1](iv) = -env * s_src.c * interp;
-                    }  // i
-                } // j
-            } // dit
+            FArrayBox& velFAB = a_vel[dit][zdir];
+            size_t     idx    = 0;
+            for (BoxIterator bit(fcLayer); bit.ok(); ++bit, ++idx) {
+                velFAB(bit()) = -env[idx] * s_src.c * interp[idx];
+            }
         } // k
-    }
+    } // dit
 }
 
 
@@ -430,68 +446,49 @@ UserPhysics::computeVelSoln(LevelData<FluxBox>& a_vel, const Real a_time) const
 void
 UserPhysics::computeBSoln(LevelData<FArrayBox>& a_b, const Real a_time) const
 {
-    const auto&     grids  = m_levGeoPtr->getBoxes();
-    const auto&     domBox = m_levGeoPtr->getDomainBox();
-    const Real      minX   = s_src.x.front();
-    const Real      maxX   = s_src.x.back();
+    const auto&   grids = m_levGeoPtr->getBoxes();
+    const Real    minX  = s_src.x.front();
+    const Real    maxX  = s_src.x.back();
+    constexpr int zdir  = SpaceDim - 1;
 
-    // Loop over each zonal vertical layer to compute T = b.
-    IntVect iv = domBox.smallEnd();
-    for (size_t k = 0; k < (size_t)domBox.size(SpaceDim-1); ++k, ++iv[SpaceDim - 1]) {
+    this->defineLayerSplines();
 
-        // Create spline of this layer's eta
-        const Real z = m_levGeoPtr->getCellX(SpaceDim - 1, iv);
+    std::vector<Real> xprime, env, eta, interp;
 
-        CubicSpline eta;
-        eta.solve(UserPhysics::getLayer_eta(z), s_src.x, 0.0, 0.0);
+    for (DataIterator dit(grids); dit.ok(); ++dit) {
+        const Box& ccValid = grids[dit];
+        FArrayBox& bFAB    = a_b[dit];
 
-        CubicSpline eta_z;
-        eta_z.solve(UserPhysics::getLayer_eta_z(z), s_src.x, 0.0, 0.0);
+        for (int k = ccValid.smallEnd(zdir); k <= ccValid.bigEnd(zdir); ++k) {
+            const LayerSplines& layer = m_ccLayerSplines.at(k);
 
-        for (DataIterator dit(grids); dit.ok(); ++dit) {
-            const Box ccValid = grids[dit];
-            if (iv[SpaceDim - 1] < ccValid.smallEnd(SpaceDim - 1)) continue;
-            if (ccValid.bigEnd(SpaceDim - 1) < iv[SpaceDim - 1]) continue;
+            Box ccLayer = ccValid;
+            ccLayer.setRange(zdir, k);
+
+            this->getLayerCoords(xprime, env, ccLayer, -1, a_time);
+            interpLayer(eta, layer.eta, xprime, minX, maxX, false);
 
             // Compute T = bbar(z-eta(x'))
+            for (size_t idx = 0; idx < eta.size(); ++idx) {
+                eta[idx] = layer.z - eta[idx];
+            }
+            m_TbarSplinePtr->interp(interp, eta);
+
 #if CH_SPACEDIM == 2
-            iv[0] = ccValid.smallEnd(0);
-            size_t i = iv[0] - domBox.smallEnd(0);
-            for (; iv[0] <= ccValid.bigEnd(0); ++iv[0], ++i) {
-                const Real x      = m_levGeoPtr->getCellX(0, iv) - s_xOffset - s_src.c * a_time;
-                const Real etaVal = (minX <= x && x <= maxX) ? eta.interp(x) : 0.0;
-
-                a_b[dit](iv) = m_TbarSplinePtr->interp(z - etaVal);
-            } // i
+            size_t idx = 0;
+            for (BoxIterator bit(ccLayer); bit.ok(); ++bit, ++idx) {
+                bFAB(bit()) = interp[idx];
+            }
 #else
-            const Real cosTheta = cos(s_rotAngle);
-            const Real sinTheta = sin(s_rotAngle);
-
-            iv[1] = ccValid.smallEnd(1);
-            int j = iv[1] - domBox.smallEnd(1);
-            for (; iv[1] <= ccValid.bigEnd(1); ++iv[1], ++j) {
-
-                iv[0] = ccValid.smallEnd(0);
-                size_t i = iv[0] - domBox.smallEnd(0);
-                for (; iv[0] <= ccValid.bigEnd(0); ++iv[0], ++i) {
-
-                    const Real x = m_levGeoPtr->getCellX(0, iv) - s_xOffset;
-                    const Real y = m_levGeoPtr->getCellX(1, iv) - s_yOffset;
+            const Real Tbar = (*m_TbarPtr)(k * BASISV(zdir));
 
-                    const Real xprime =  x * cosTheta + y * sinTheta;
-                    const Real yprime = -x * sinTheta + y * cosTheta;
-
-                    const Real env    = UserPhysics::extrusionEnvelope(yprime);
-                    const Real Tbar   = (*m_TbarPtr)(iv * BASISV(SpaceDim - 1));
-                    const Real etaVal = (minX <= xprime && xprime <= maxX) ? eta.interp(xprime) : 0.0;
-                    const Real interp = m_TbarSplinePtr->interp(z - etaVal);
-
-                    a_b[dit](iv) = env * interp + (1.0 - env) * Tbar;
-                }  // i
-            } // j
+            size_t idx = 0;
+            for (BoxIterator bit(ccLayer); bit.ok(); ++bit, ++idx) {
+                bFAB(bit()) = env[idx] * interp[idx] + (1.0 - env[idx]) * Tbar;
+            }
 #endif
-        } // dit
-    } // k
+        } // k
+    } // dit
 }
 
 
@@ -29,6 +29,7 @@
 #ifdef CH_USE_CUDA_PROJECTOR
 #include <cusp/multiply.h>  // leave this at first line. There are macros in CHOMBO that interfere with it.
 #endif
+#include <sys/resource.h>
 #include <sys/utsname.h>
 #include <chrono>
 #include <iostream>
@@ -38,7 +39,9 @@
 
 // Chombo headers
 #include "AnisotropicMeshRefine.H"
+#include "Arena.H"
 #include "CH_Attach.H"
+#include "FArrayBox.H"
 #include "MayDay.H"
 #include "ParmParse.H"
 #include "memusage.H"
@@ -59,7 +62,9 @@
 #include "Debug.H"
 #include "Format.H"
 #include "IO.H"
+#include "PhaseTimer.H"
 #include "ProblemContext.H"
+#include "ThreadTools.H"
 #if CH_USE_PYTHON
 #include "PyGlue.H"
 #endif
@@ -110,8 +115,35 @@
 int
 main(int argc, char* argv[])
 {
+    // Open the input file. ParmParse reads it on each rank without MPI, so
+    // we can use it to decide how to initialize MPI.
+    char*     in_file = argv[1];
+    ParmParse pp(argc - 2, argv + 2, NULL, in_file);
+
 #ifdef CH_MPI
-    MPI_Init(&argc, &argv);
+    {
+        // output.asyncPlot writes plotfiles from a second thread, which makes
+        // MPI calls of its own. Only ask for MPI_THREAD_MULTIPLE when it is
+        // needed since some MPI builds are slower or refuse to start at that
+        // level. OutputParameters checks what we actually got.
+        bool asyncPlot = false;
+#ifdef SOMAR_USE_HDF5
+        ParmParse("output").query("asyncPlot", asyncPlot);
+#endif
+        int mpiThreadSupport;
+        if (asyncPlot) {
+            MPI_Init_thread(
+                &argc, &argv, MPI_THREAD_MULTIPLE, &mpiThreadSupport);
+        } else {
+#ifdef _OPENMP
+            // Only the master thread makes MPI calls.
+            MPI_Init_thread(
+                &argc, &argv, MPI_THREAD_FUNNELED, &mpiThreadSupport);
+#else
+            MPI_Init(&argc, &argv);
+#endif
+        }
+    }
 #endif
 #ifdef CH_USE_PYTHON
     std::vector<std::string> InitCommands{
@@ -129,9 +161,6 @@ main(int argc, char* argv[])
     // Reset the stdout color
     std::cout << Format::none << std::flush;
 
-    // Open the input file
-    char*     in_file = argv[1];
-    ParmParse pp(argc - 2, argv + 2, NULL, in_file);
     pout() << "Input file: " << in_file << endl;
 #ifdef CH_USE_PYTHON
     const std::string inputFile = std::string(in_file);
@@ -165,6 +194,11 @@ main(int argc, char* argv[])
     pout() << "Not using MPI." << endl;
 #endif
 
+#ifdef _OPENMP
+    pout() << "Using OpenMP with " << omp_get_max_threads()
+           << " threads per rank." << endl;
+#endif
+
     // Make sure the user knows if we are in debug mode.
     if (debugMode) {
         pout() << "*** DEBUG MODE ***" << endl;
@@ -198,6 +232,20 @@ main(int argc, char* argv[])
         // read from the input file.
         const ProblemContext* ctx = ProblemContext::getInstance();
 
+        // This must happen before the first FAB is defined. It is never
+        // deleted because FABs with static storage may outlive main().
+        PoolArena* poolArenaPtr = nullptr;
+        if (ctx->amr.usePoolArena) {
+            const size_t maxCachedBytes =
+                size_t(ctx->amr.poolArenaMaxCachedMB) * 1024 * 1024;
+            poolArenaPtr = new PoolArena("FArrayBox", true, maxCachedBytes);
+            BaseFab<Real>::setArena(poolArenaPtr);
+            if (BaseFab<Real>::getArena() != poolArenaPtr) {
+                delete poolArenaPtr;
+                poolArenaPtr = nullptr;
+            }
+        }
+
         // The AMR driver...
         AnisotropicAMR amr(std::make_unique<AMRNSLevelFactory>(),
                            ctx->base,
@@ -207,6 +255,24 @@ main(int argc, char* argv[])
         amr.verbosity(ctx->output.verbosity);
         amr.run();  // We don't want to run when testing.
         amr.conclude();
+
+        // Collective. All ranks must call this.
+        if (!ctx->output.timingReportFile.empty()) {
+            PhaseTimer::writeReport(ctx->output.timingReportFile);
+
+            // Compare runs with amr.usePoolArena = 0 and 1 to see how many
+            // first-touch faults recycling FAB memory saves.
+            struct rusage usage;
+            if (getrusage(RUSAGE_SELF, &usage) == 0) {
+                pout() << "Page faults on this rank: minor = " << usage.ru_minflt
+                       << ", major = " << usage.ru_majflt << "\n";
+            }
+        }
+
+        if (poolArenaPtr) {
+            pout() << "\n";
+            poolArenaPtr->report(pout());
+        }
     }
     pout() << endl;
     barrier();
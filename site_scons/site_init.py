@@ -132,6 +132,16 @@ class processFlags:
                     action='store_true',
                     metavar='OpenMP',
                     help='turn on the options to compile with OpenMP support')
+        AddOption('--Timers',
+                    dest='Timers',
+                    action='store_true',
+                    metavar='Timers',
+                    help='turn on the Chombo CH_TIME instrumentation (time.table.* reports)')
+        AddOption('--HDF5',
+                    dest='HDF5',
+                    action='store_true',
+                    metavar='HDF5',
+                    help='link against (parallel) HDF5 and write checkpoints natively instead of through Python')
         AddOption('--noPython',
                     dest='noPython',
                     action='store_true',
@@ -161,6 +171,8 @@ class processFlags:
         self.StaticLib=GetOption('StaticLib') if GetOption('StaticLib') is not None else False
         self.Profile=GetOption('Profile') if GetOption('Profile') is not None else False
         self.OpenMP=GetOption('OpenMP') if GetOption('OpenMP') is not None else False
+        self.Timers=GetOption('Timers') if GetOption('Timers') is not None else False
+        self.HDF5=GetOption('HDF5') if GetOption('HDF5') is not None else False
         self.noPython=GetOption('noPython') if GetOption('noPython') is not None else False
         self.IntelCompiler=GetOption('IntelC') if GetOption('IntelC') is not None else False
         self.ClangCompiler=GetOption('Clang') if GetOption('Clang') is not None else False
@@ -269,6 +281,13 @@ def setEnvOptions(Flags, src_dir='src', root_dir='.'):
     if Flags.MPI:
         CPPSwitches['CH_MPI']=None
 
+    if Flags.Timers:
+        del CPPSwitches['CH_NTIMER']
+
+    if Flags.HDF5:
+        CPPSwitches['SOMAR_USE_HDF5']=None
+        CXXFLAGS+=['-pthread']
+
     if Flags.OpenMP:
         if Flags.IntelCompiler or Flags.ClangCompiler:
             raise ValueError("OpenMP not supported yet for intel or clang")
@@ -333,10 +352,24 @@ def setEnvOptions(Flags, src_dir='src', root_dir='.'):
         except:
             PythonIncludePath= '/usr/include/python'+PYTHON_VER if os.path.isdir('/usr/include/python'+PYTHON_VER) else None
 
+    # Same idea for HDF5. Debian/Ubuntu put the parallel build under hdf5/openmpi.
+    if Flags.HDF5:
+        try:
+            HDF5IncludePath=os.environ['HDF5_INCLUDE_PATH']
+        except:
+            HDF5IncludePath='/usr/include/hdf5/openmpi' if os.path.isdir('/usr/include/hdf5/openmpi') else None
+        try:
+            HDF5LibPath=os.environ['HDF5_LIB_PATH']
+        except:
+            HDF5LibPath='/usr/lib/x86_64-linux-gnu/hdf5/openmpi' if os.path.isdir('/usr/lib/x86_64-linux-gnu/hdf5/openmpi') else None
+    else:
+        HDF5IncludePath=None
+        HDF5LibPath=None
+
     # finally all the information is packaged into a dictionary which will be passed to SCons
     env_options = {
-        "CPPPATH" : IncDirs + [PythonIncludePath or str('')],
-        "LIBPATH" : ['.',root_dir+buildName('/lib/',Flags), PythonLibPath or str('')],
+        "CPPPATH" : IncDirs + [PythonIncludePath or str(''), HDF5IncludePath or str('')],
+        "LIBPATH" : ['.',root_dir+buildName('/lib/',Flags), PythonLibPath or str(''), HDF5LibPath or str('')],
         "FORTRANFLAGS" : F77FLAGS,
         "SHF77FLAGS" : F77FLAGS,
         "CPPDEFINES" : CPPSwitches,
@@ -376,6 +409,8 @@ def buildName(prefix,Flags):
     if Flags.Debug: prefix+='.debug'
     if Flags.Profile: prefix+='.profile'
     if Flags.OpenMP: prefix+='.OpenMP'
+    if Flags.Timers: prefix+='.timers'
+    if Flags.HDF5: prefix+='.hdf5'
     if Flags.noPython: prefix+='.noPython'
     if Flags.StaticLib: prefix+='.static'
     if Flags.IntelCompiler: prefix+='.intel'
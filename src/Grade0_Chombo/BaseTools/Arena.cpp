@@ -349,4 +349,297 @@ void* CArena::realloc(void*  a_ptr,
 }
 #endif
 
+// -----------------------------------------------------------------------------
+// PoolArena
+// -----------------------------------------------------------------------------
+
+std::atomic<int> PoolArena::s_subsystem(0);
+
+namespace
+{
+  // Every block starts with one of these, padded to PoolArena::HeaderSize.
+  struct PoolHeader
+  {
+    int m_cls;
+    int m_subsystem;
+  };
+
+  std::mutex& poolRegistryMutex()
+  {
+    static std::mutex s_mutex;
+    return s_mutex;
+  }
+
+  std::vector<std::string>& poolRegistry()
+  {
+    static std::vector<std::string> s_names(1, std::string("other"));
+    return s_names;
+  }
+}
+
+PoolArena::PoolArena(const char* a_name,
+                     bool        a_zeroFill,
+                     size_t      a_maxCachedBytes)
+  :
+  m_freeList(NumClasses),
+  m_account(MaxSubsystems),
+  m_live(0),
+  m_peak(0),
+  m_cached(0),
+  m_maxCached(a_maxCachedBytes),
+  m_zeroFill(a_zeroFill)
+{
+  CH_assert(sizeof(PoolHeader) <= HeaderSize);
+  for (unsigned int i = 0; i < m_account.size(); i++)
+  {
+    m_account[i].live   = 0;
+    m_account[i].peak   = 0;
+    m_account[i].fresh  = 0;
+    m_account[i].reused = 0;
+  }
+#ifdef CH_USE_MEMORY_TRACKING
+  strncpy(name_, a_name, NSIZE);
+  name_[NSIZE-1]=0;
+#else
+  (void)a_name;
+#endif
+}
+
+PoolArena::~PoolArena()
+{
+  release();
+}
+
+int PoolArena::sizeClass(size_t a_sz)
+{
+  int    cls  = 0;
+  size_t base = MinBlockSize;
+  while (2*base < a_sz)
+  {
+    base *= 2;
+    cls  += ClassesPerOctave;
+  }
+  while (classSize(cls) < a_sz)
+  {
+    cls++;
+  }
+
+  if (cls >= NumClasses)
+  {
+    pout() << " Trying to allocate " << a_sz << " bytes in PoolArena::alloc()" << std::endl;
+    MayDay::Error("Request is larger than the largest size class in PoolArena::alloc");
+  }
+  return cls;
+}
+
+size_t PoolArena::classSize(int a_cls)
+{
+  const size_t base = size_t(MinBlockSize) << (a_cls / ClassesPerOctave);
+  return base + (a_cls % ClassesPerOctave) * (base / ClassesPerOctave);
+}
+
+void* PoolArena::alloc(size_t a_sz)
+{
+  const int    cls    = sizeClass(a_sz + HeaderSize);
+  const size_t clsSz  = classSize(cls);
+  const int    sub    = s_subsystem.load(std::memory_order_relaxed);
+  char*        block  = NULL;
+
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    std::vector<void*>& freeList = m_freeList[cls];
+    Account&            acct     = m_account[sub];
+    if (freeList.empty())
+    {
+      acct.fresh++;
+    }
+    else
+    {
+      block = static_cast<char*>(freeList.back());
+      freeList.pop_back();
+      m_cached -= clsSz;
+      acct.reused++;
+    }
+
+    acct.live += clsSz;
+    if (acct.live > acct.peak)
+    {
+      acct.peak = acct.live;
+    }
+    m_live += clsSz;
+    if (m_live > m_peak)
+    {
+      m_peak = m_live;
+    }
+  }
+
+  if (block == NULL)
+  {
+    // See the comment in BArena::alloc about initialized memory.  calloc
+    // gets fresh pages already zeroed from the OS, so this costs nothing.
+    block = static_cast<char*>(m_zeroFill ? calloc(1, clsSz) : malloc(clsSz));
+    if (block == NULL)
+    {
+      print_memory_line("Out of memory");
+      pout() << " Trying to allocate " << clsSz << " bytes in PoolArena::alloc()" << std::endl;
+      MayDay::Error("Out of memory in PoolArena::alloc (BaseFab) ");
+    }
+  }
+  else if (m_zeroFill)
+  {
+    memset(block + HeaderSize, 0, a_sz);
+  }
+
+  PoolHeader* header  = reinterpret_cast<PoolHeader*>(block);
+  header->m_cls       = cls;
+  header->m_subsystem = sub;
+
+  return block + HeaderSize;
+}
+
+void PoolArena::free(void* a_pt)
+{
+  if (a_pt == NULL)
+  {
+    return;
+  }
+
+  char*             block  = static_cast<char*>(a_pt) - HeaderSize;
+  const PoolHeader* header = reinterpret_cast<const PoolHeader*>(block);
+  const int         cls    = header->m_cls;
+  const size_t      clsSz  = classSize(cls);
+  CH_assert(0 <= cls && cls < NumClasses);
+  CH_assert(0 <= header->m_subsystem && header->m_subsystem < MaxSubsystems);
+
+  bool keep = true;
+  {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    m_account[header->m_subsystem].live -= clsSz;
+    m_live -= clsSz;
+
+    if (m_maxCached > 0 && m_cached + clsSz > m_maxCached)
+    {
+      keep = false;
+    }
+    else
+    {
+      m_freeList[cls].push_back(block);
+      m_cached += clsSz;
+    }
+  }
+
+  if (!keep)
+  {
+    ::free(block);
+  }
+}
+
+void PoolArena::release()
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  for (unsigned int cls = 0; cls < m_freeList.size(); cls++)
+  {
+    std::vector<void*>& freeList = m_freeList[cls];
+    for (unsigned int i = 0; i < freeList.size(); i++)
+    {
+      ::free(freeList[i]);
+    }
+    // Give back the list's own storage too.
+    std::vector<void*>().swap(freeList);
+  }
+  m_cached = 0;
+}
+
+size_t PoolArena::liveBytes() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_live;
+}
+
+size_t PoolArena::peakBytes() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_peak;
+}
+
+size_t PoolArena::cachedBytes() const
+{
+  std::lock_guard<std::mutex> lock(m_mutex);
+  return m_cached;
+}
+
+void PoolArena::report(std::ostream& a_os) const
+{
+  std::vector<std::string> names;
+  {
+    std::lock_guard<std::mutex> lock(poolRegistryMutex());
+    names = poolRegistry();
+  }
+
+  std::lock_guard<std::mutex> lock(m_mutex);
+
+  const std::ios_base::fmtflags oldFlags = a_os.flags();
+  const std::streamsize         oldPrec  = a_os.precision();
+
+  const double MB = 1024.0 * 1024.0;
+  a_os << "PoolArena: live = " << m_live / MB
+       << " MB, peak = " << m_peak / MB
+       << " MB, cached = " << m_cached / MB << " MB\n";
+  a_os << std::setw(32) << std::left << "  subsystem" << std::right
+       << std::setw(14) << "live (MB)"
+       << std::setw(14) << "peak (MB)"
+       << std::setw(14) << "allocs"
+       << std::setw(10) << "reused" << "\n";
+
+  for (unsigned int id = 0; id < names.size(); id++)
+  {
+    const Account&  acct   = m_account[id];
+    const long long allocs = acct.fresh + acct.reused;
+    if (allocs == 0)
+    {
+      continue;
+    }
+
+    a_os << "  " << std::setw(30) << std::left << names[id] << std::right
+         << std::setw(14) << std::fixed << std::setprecision(2) << acct.live / MB
+         << std::setw(14) << acct.peak / MB
+         << std::setw(14) << allocs
+         << std::setw(9)  << std::setprecision(1)
+         << 100.0 * double(acct.reused) / double(allocs) << "%\n";
+  }
+  a_os.flags(oldFlags);
+  a_os.precision(oldPrec);
+  a_os << std::flush;
+}
+
+int PoolArena::subsystemID(const std::string& a_name)
+{
+  std::lock_guard<std::mutex> lock(poolRegistryMutex());
+
+  std::vector<std::string>& names = poolRegistry();
+  for (unsigned int id = 0; id < names.size(); id++)
+  {
+    if (names[id] == a_name)
+    {
+      return id;
+    }
+  }
+
+  if (names.size() >= MaxSubsystems)
+  {
+    return 0;
+  }
+  names.push_back(a_name);
+  return names.size() - 1;
+}
+
+int PoolArena::setSubsystem(int a_id)
+{
+  CH_assert(0 <= a_id && a_id < MaxSubsystems);
+  return s_subsystem.exchange(a_id, std::memory_order_relaxed);
+}
+
 #include "BaseNamespaceFooter.H"
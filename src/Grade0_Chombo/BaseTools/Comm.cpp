@@ -51,4 +51,134 @@ reduce (Real&  a_val,
 }
 
 
+// -----------------------------------------------------------------------------
+// Completes any outstanding communication.
+// -----------------------------------------------------------------------------
+ReductionBatch::~ReductionBatch()
+{
+    if (m_inFlight) this->end();
+}
+
+
+// -----------------------------------------------------------------------------
+// Queues a_val for reduction. a_val must stay alive until end() is
+// called, at which point it will be overwritten with the global result.
+// Only MPI_SUM, MPI_MIN, and MPI_MAX are supported.
+// -----------------------------------------------------------------------------
+void
+ReductionBatch::add(Real& a_val, MPI_Op a_mpiOp)
+{
+    if (m_inFlight) {
+        MayDay::Error("ReductionBatch::add called while a batch is in flight");
+    }
+
+#ifdef CH_MPI
+    if (a_mpiOp == MPI_SUM) {
+        m_sumPtrs.push_back(&a_val);
+    } else if (a_mpiOp == MPI_MAX || a_mpiOp == MPI_MIN) {
+        m_maxPtrs.push_back(&a_val);
+        m_isMin.push_back(a_mpiOp == MPI_MIN);
+    } else {
+        MayDay::Error("ReductionBatch::add only supports MPI_SUM, MPI_MIN, "
+                      "and MPI_MAX");
+    }
+#else
+    // With one rank, the local value is the global value.
+    (void)a_val;
+    (void)a_mpiOp;
+#endif
+}
+
+
+// -----------------------------------------------------------------------------
+// Packs the queued values and starts the non-blocking reductions.
+// -----------------------------------------------------------------------------
+void
+ReductionBatch::begin()
+{
+    if (m_inFlight) {
+        MayDay::Error("ReductionBatch::begin called twice");
+    }
+    m_inFlight    = true;
+    m_numRequests = 0;
+
+#ifdef CH_MPI
+    if (!m_sumPtrs.empty()) {
+        m_sumBuf.resize(m_sumPtrs.size());
+        for (size_t i = 0; i < m_sumPtrs.size(); ++i) {
+            m_sumBuf[i] = *m_sumPtrs[i];
+        }
+
+        const int result = MPI_Iallreduce(MPI_IN_PLACE,
+                                          m_sumBuf.data(),
+                                          m_sumBuf.size(),
+                                          MPI_CH_REAL,
+                                          MPI_SUM,
+                                          Chombo_MPI::comm,
+                                          &m_requests[m_numRequests++]);
+        if (result != MPI_SUCCESS) {
+            MayDay::Error("Sorry, but I had a communication error in "
+                          "ReductionBatch::begin");
+        }
+    }
+
+    if (!m_maxPtrs.empty()) {
+        m_maxBuf.resize(m_maxPtrs.size());
+        for (size_t i = 0; i < m_maxPtrs.size(); ++i) {
+            m_maxBuf[i] = (m_isMin[i] ? -*m_maxPtrs[i] : *m_maxPtrs[i]);
+        }
+
+        const int result = MPI_Iallreduce(MPI_IN_PLACE,
+                                          m_maxBuf.data(),
+                                          m_maxBuf.size(),
+                                          MPI_CH_REAL,
+                                          MPI_MAX,
+                                          Chombo_MPI::comm,
+                                          &m_requests[m_numRequests++]);
+        if (result != MPI_SUCCESS) {
+            MayDay::Error("Sorry, but I had a communication error in "
+                          "ReductionBatch::begin");
+        }
+    }
+#endif
+}
+
+
+// -----------------------------------------------------------------------------
+// Waits for the reductions to complete and unpacks the results.
+// The batch is emptied and can be reused.
+// -----------------------------------------------------------------------------
+void
+ReductionBatch::end()
+{
+    if (!m_inFlight) {
+        MayDay::Error("ReductionBatch::end called without begin");
+    }
+
+#ifdef CH_MPI
+    if (m_numRequests > 0) {
+        MPI_Status statuses[2];
+        const int  result = MPI_Waitall(m_numRequests, m_requests, statuses);
+        if (result != MPI_SUCCESS) {
+            MayDay::Error("Sorry, but I had a communication error in "
+                          "ReductionBatch::end");
+        }
+    }
+
+    for (size_t i = 0; i < m_sumPtrs.size(); ++i) {
+        *m_sumPtrs[i] = m_sumBuf[i];
+    }
+    for (size_t i = 0; i < m_maxPtrs.size(); ++i) {
+        *m_maxPtrs[i] = (m_isMin[i] ? -m_maxBuf[i] : m_maxBuf[i]);
+    }
+#endif
+
+    m_sumPtrs.clear();
+    m_maxPtrs.clear();
+    m_isMin.clear();
+    m_numRequests = 0;
+    m_inFlight    = false;
+}
+
+
 }; // end namespace Comm
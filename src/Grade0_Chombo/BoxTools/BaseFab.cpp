@@ -88,8 +88,16 @@ m_truesize = m_nvar * m_numpts;
     s_Arena->peak = s_Arena->bytes;
   }
 #else
-m_varr.resize(m_truesize);
-m_dptr = static_cast<Real *>(&(m_varr[0]));
+  if (s_Arena != NULL)
+  {
+    // Chosen by setArena().
+    m_dptr = static_cast<Real*>(s_Arena->alloc(m_truesize * sizeof(Real)));
+  }
+  else
+  {
+    m_varr.resize(m_truesize);
+    m_dptr = static_cast<Real *>(&(m_varr[0]));
+  }
 //nonstd::span<Real> v(m_dptr, m_truesize);
 //m_view=v;
 #endif
@@ -157,7 +165,14 @@ s_Arena->free(m_dptr);
   s_Arena->bytes -= m_truesize * sizeof(Real) + sizeof(BaseFab<Real>);
   CH_assert(s_Arena->bytes >= 0);
 #else
-  m_varr.resize(0);
+  if (m_varr.empty())
+  {
+    s_Arena->free(m_dptr);
+  }
+  else
+  {
+    m_varr.resize(0);
+  }
 #endif
   
   m_dptr = 0;
@@ -0,0 +1,267 @@
+/*******************************************************************************
+ *  SOMAR - Stratified Ocean Model with Adaptive Refinement
+ *  Developed by Ed Santilli & Alberto Scotti
+ *  Copyright (C) 2024 Thomas Jefferson University and Arizona State University
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ *
+ *  For up-to-date contact information, please visit the repository homepage,
+ *  https://github.com/MUON-CFD/SOMAR.
+ ******************************************************************************/
+#include "CopierCache.H"
+
+
+namespace {
+
+std::mutex&
+getMutex()
+{
+    static std::mutex s_mutex;
+    return s_mutex;
+}
+
+std::map<CopierCache::Key, std::pair<std::shared_ptr<Copier>, unsigned long>>&
+getRegistry()
+{
+    static std::map<CopierCache::Key,
+                    std::pair<std::shared_ptr<Copier>, unsigned long>>
+        s_registry;
+    return s_registry;
+}
+
+size_t        s_capacity = 512;
+unsigned long s_clock    = 0;
+long          s_hits     = 0;
+long          s_misses   = 0;
+
+};  // namespace
+
+
+// -----------------------------------------------------------------------------
+CopierCache::Key::Key(const BoxLayout&     a_srcLayout,
+                      const BoxLayout&     a_destLayout,
+                      const ProblemDomain& a_domain,
+                      const IntVect&       a_srcGhost,
+                      const IntVect&       a_destGhost,
+                      const Kind           a_kind,
+                      const int            a_fcDir)
+: srcLayout(a_srcLayout)
+, destLayout(a_destLayout)
+, srcGhost(a_srcGhost)
+, destGhost(a_destGhost)
+, periodic(0)
+, kind(a_kind)
+, fcDir(a_fcDir)
+{
+    for (int d = 0; d < SpaceDim; ++d) {
+        if (a_domain.isPeriodic(d)) periodic |= (1 << d);
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+CopierCache::Key::operator<(const Key& a_rhs) const
+{
+    if (kind != a_rhs.kind) return kind < a_rhs.kind;
+    if (fcDir != a_rhs.fcDir) return fcDir < a_rhs.fcDir;
+    if (periodic != a_rhs.periodic) return periodic < a_rhs.periodic;
+    if (srcGhost != a_rhs.srcGhost) return srcGhost.lexLT(a_rhs.srcGhost);
+    if (destGhost != a_rhs.destGhost) return destGhost.lexLT(a_rhs.destGhost);
+    if (!(srcLayout == a_rhs.srcLayout)) return srcLayout < a_rhs.srcLayout;
+    return destLayout < a_rhs.destLayout;
+}
+
+
+// -----------------------------------------------------------------------------
+std::shared_ptr<const Copier>
+CopierCache::exchangeCopier(const DisjointBoxLayout& a_grids,
+                            const IntVect&           a_ghost)
+{
+    const Key key(a_grids, a_grids, a_grids.physDomain(), a_ghost, a_ghost,
+                  Exchange);
+    return get<Copier>(key, [&](Copier& a_cp) {
+        a_cp.define(a_grids, a_grids, a_ghost, true);
+    });
+}
+
+
+// -----------------------------------------------------------------------------
+std::shared_ptr<const Copier>
+CopierCache::exchangeDefineCopier(const DisjointBoxLayout& a_grids,
+                                  const IntVect&           a_ghost)
+{
+    const Key key(a_grids, a_grids, a_grids.physDomain(), a_ghost, a_ghost,
+                  ExchangeDefine);
+    return get<Copier>(key, [&](Copier& a_cp) {
+        a_cp.exchangeDefine(a_grids, a_ghost);
+    });
+}
+
+
+// -----------------------------------------------------------------------------
+std::shared_ptr<const Copier>
+CopierCache::trimmedExchangeCopier(const DisjointBoxLayout& a_grids,
+                                   const IntVect&           a_ghost)
+{
+    const Key key(a_grids, a_grids, a_grids.physDomain(), a_ghost, a_ghost,
+                  TrimmedExchangeDefine);
+    return get<Copier>(key, [&](Copier& a_cp) {
+        a_cp.exchangeDefine(a_grids, a_ghost);
+        a_cp.trimEdges(a_grids, a_ghost);
+    });
+}
+
+
+// -----------------------------------------------------------------------------
+std::shared_ptr<const StaggeredCopier>
+CopierCache::validExchangeCopier(const DisjointBoxLayout& a_grids,
+                                 const IntVect&           a_ghost,
+                                 const int                a_fcDir,
+                                 const bool               a_doValidCorners)
+{
+    const Key key(a_grids, a_grids, a_grids.physDomain(), a_ghost, a_ghost,
+                  (a_doValidCorners ? ValidExchange : ValidExchangeNoCorners),
+                  a_fcDir);
+    return get<StaggeredCopier>(key, [&](StaggeredCopier& a_cp) {
+        a_cp.defineValidExchange(a_grids, a_ghost, a_fcDir, a_doValidCorners);
+    });
+}
+
+
+// -----------------------------------------------------------------------------
+std::shared_ptr<const StaggeredCopier>
+CopierCache::invalidCornerExchangeCopier1(const DisjointBoxLayout& a_grids,
+                                          const IntVect&           a_ghost,
+                                          const int                a_fcDir)
+{
+    const Key key(a_grids, a_grids, a_grids.physDomain(), a_ghost, a_ghost,
+                  InvalidCornerExchange1, a_fcDir);
+    return get<StaggeredCopier>(key, [&](StaggeredCopier& a_cp) {
+        a_cp.defineInvalidCornerExchange1(a_grids, a_ghost, a_fcDir);
+    });
+}
+
+
+// -----------------------------------------------------------------------------
+std::shared_ptr<const StaggeredCopier>
+CopierCache::invalidCornerExchangeCopier2(const DisjointBoxLayout& a_grids,
+                                          const IntVect&           a_ghost,
+                                          const int                a_fcDir)
+{
+    const Key key(a_grids, a_grids, a_grids.physDomain(), a_ghost, a_ghost,
+                  InvalidCornerExchange2, a_fcDir);
+    return get<StaggeredCopier>(key, [&](StaggeredCopier& a_cp) {
+        a_cp.defineInvalidCornerExchange2(a_grids, a_ghost, a_fcDir);
+    });
+}
+
+
+// -----------------------------------------------------------------------------
+void
+CopierCache::clear()
+{
+    std::lock_guard<std::mutex> lock(getMutex());
+    getRegistry().clear();
+}
+
+
+// -----------------------------------------------------------------------------
+size_t
+CopierCache::capacity()
+{
+    std::lock_guard<std::mutex> lock(getMutex());
+    return s_capacity;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+CopierCache::setCapacity(const size_t a_capacity)
+{
+    std::lock_guard<std::mutex> lock(getMutex());
+    s_capacity = a_capacity;
+
+    auto& registry = getRegistry();
+    while (registry.size() > s_capacity) {
+        auto oldestIt = registry.begin();
+        for (auto it = registry.begin(); it != registry.end(); ++it) {
+            if (it->second.second < oldestIt->second.second) oldestIt = it;
+        }
+        registry.erase(oldestIt);
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+size_t
+CopierCache::size()
+{
+    std::lock_guard<std::mutex> lock(getMutex());
+    return getRegistry().size();
+}
+
+
+// -----------------------------------------------------------------------------
+void
+CopierCache::getStats(long& a_hits, long& a_misses)
+{
+    std::lock_guard<std::mutex> lock(getMutex());
+    a_hits   = s_hits;
+    a_misses = s_misses;
+}
+
+
+// -----------------------------------------------------------------------------
+std::shared_ptr<Copier>
+CopierCache::find(const Key& a_key)
+{
+    std::lock_guard<std::mutex> lock(getMutex());
+
+    auto& registry = getRegistry();
+    auto  it       = registry.find(a_key);
+    if (it == registry.end()) {
+        ++s_misses;
+        return std::shared_ptr<Copier>();
+    }
+
+    ++s_hits;
+    it->second.second = ++s_clock;
+    return it->second.first;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+CopierCache::insert(const Key& a_key, const std::shared_ptr<Copier>& a_copierPtr)
+{
+    std::lock_guard<std::mutex> lock(getMutex());
+    if (s_capacity == 0) return;
+
+    auto& registry = getRegistry();
+    if (registry.size() >= s_capacity && registry.count(a_key) == 0) {
+        // Evict the least recently used entry. This is a linear search, but
+        // it only happens on a miss, and a miss means we just defined a
+        // Copier, which is far more expensive.
+        auto oldestIt = registry.begin();
+        for (auto it = registry.begin(); it != registry.end(); ++it) {
+            if (it->second.second < oldestIt->second.second) oldestIt = it;
+        }
+        registry.erase(oldestIt);
+    }
+
+    registry[a_key] = std::make_pair(a_copierPtr, ++s_clock);
+}
@@ -15,6 +15,7 @@
 
 #include "NeighborIterator.H"
 #include "Comm.H"
+#include "CopierCache.H"
 
 #include "NamespaceHeader.H"
 
@@ -45,8 +46,9 @@ LevelData<FluxBox>::clear()
     m_exCopier[1].clear();,
     m_exCopier[2].clear();)
 
-    m_ghost             = IntVect(D_DECL(-1, -1, -1));
-    m_disjointBoxLayout = DisjointBoxLayout();
+    m_ghost                 = IntVect(D_DECL(-1, -1, -1));
+    m_disjointBoxLayout     = DisjointBoxLayout();
+    m_cornerExchangePending = false;
     BoxLayoutData<FluxBox>::clear();
 }
 
@@ -93,13 +95,14 @@ LevelData<FluxBox>::LevelData(const DisjointBoxLayout&    dp,
 
     for (int d = 0; d < SpaceDim; ++d) {
         constexpr bool doValidCorners = true;
-        m_exCopier[d].defineValidExchange(
+        // Copying a cached Copier is much cheaper than defining a new one.
+        m_exCopier[d] = *CopierCache::validExchangeCopier(
             m_disjointBoxLayout, m_ghost, d, doValidCorners);
 
-        m_exCornerCopier1[d].defineInvalidCornerExchange1(
+        m_exCornerCopier1[d] = *CopierCache::invalidCornerExchangeCopier1(
             m_disjointBoxLayout, m_ghost, d);
 
-        m_exCornerCopier2[d].defineInvalidCornerExchange2(
+        m_exCornerCopier2[d] = *CopierCache::invalidCornerExchangeCopier2(
             m_disjointBoxLayout, m_ghost, d);
 
         FABAliasFlBxDataFactory factory(this, this->interval(), d);
@@ -162,13 +165,14 @@ LevelData<FluxBox>::define(const DisjointBoxLayout&    dp,
 
     for (int d = 0; d < SpaceDim; ++d) {
         constexpr bool doValidCorners = true;
-        m_exCopier[d].defineValidExchange(
+        // Copying a cached Copier is much cheaper than defining a new one.
+        m_exCopier[d] = *CopierCache::validExchangeCopier(
             m_disjointBoxLayout, m_ghost, d, doValidCorners);
 
-        m_exCornerCopier1[d].defineInvalidCornerExchange1(
+        m_exCornerCopier1[d] = *CopierCache::invalidCornerExchangeCopier1(
             m_disjointBoxLayout, m_ghost, d);
 
-        m_exCornerCopier2[d].defineInvalidCornerExchange2(
+        m_exCornerCopier2[d] = *CopierCache::invalidCornerExchangeCopier2(
             m_disjointBoxLayout, m_ghost, d);
 
         FABAliasFlBxDataFactory factory(this, this->interval(), d);
@@ -220,13 +224,14 @@ LevelData<FluxBox>::define(const LevelData<FluxBox>&   da,
 
     for (int d = 0; d < SpaceDim; ++d) {
         constexpr bool doValidCorners = true;
-        m_exCopier[d].defineValidExchange(
+        // Copying a cached Copier is much cheaper than defining a new one.
+        m_exCopier[d] = *CopierCache::validExchangeCopier(
             m_disjointBoxLayout, m_ghost, d, doValidCorners);
 
-        m_exCornerCopier1[d].defineInvalidCornerExchange1(
+        m_exCornerCopier1[d] = *CopierCache::invalidCornerExchangeCopier1(
             m_disjointBoxLayout, m_ghost, d);
 
-        m_exCornerCopier2[d].defineInvalidCornerExchange2(
+        m_exCornerCopier2[d] = *CopierCache::invalidCornerExchangeCopier2(
             m_disjointBoxLayout, m_ghost, d);
 
         FABAliasFlBxDataFactory factory(this, this->interval(), d);
@@ -290,13 +295,14 @@ LevelData<FluxBox>::define(const LevelData<FluxBox>&   da,
 
     for (int d = 0; d < SpaceDim; ++d) {
         constexpr bool doValidCorners = true;
-        m_exCopier[d].defineValidExchange(
+        // Copying a cached Copier is much cheaper than defining a new one.
+        m_exCopier[d] = *CopierCache::validExchangeCopier(
             m_disjointBoxLayout, m_ghost, d, doValidCorners);
 
-        m_exCornerCopier1[d].defineInvalidCornerExchange1(
+        m_exCornerCopier1[d] = *CopierCache::invalidCornerExchangeCopier1(
             m_disjointBoxLayout, m_ghost, d);
 
-        m_exCornerCopier2[d].defineInvalidCornerExchange2(
+        m_exCornerCopier2[d] = *CopierCache::invalidCornerExchangeCopier2(
             m_disjointBoxLayout, m_ghost, d);
 
         FABAliasFlBxDataFactory factory(this, this->interval(), d);
@@ -638,6 +644,23 @@ LevelData<FluxBox>::exchangeBegin(const CopierT& a_copier)
 }
 
 
+// -----------------------------------------------------------------------------
+void
+LevelData<FluxBox>::exchangeBegin()
+{
+    CH_assert(!m_cornerExchangePending);
+
+    for (int d = 0; d < SpaceDim; ++d) {
+        CH_assert(m_alias[d].isDefined());
+        CH_assert(m_alias[d].getBoxes() == this->getBoxes());
+        CH_assert(m_alias[d].ghostVect() == this->ghostVect());
+
+        m_alias[d].exchangeBegin(m_exCopier[d]);
+    }
+    m_cornerExchangePending = true;
+}
+
+
 // -----------------------------------------------------------------------------
 void
 LevelData<FluxBox>::exchangeEnd()
@@ -649,6 +672,25 @@ LevelData<FluxBox>::exchangeEnd()
 
         m_alias[d].exchangeEnd();
     }
+
+    // The corner copiers read the ghosts that the face exchange just filled.
+    if (m_cornerExchangePending) {
+        m_cornerExchangePending = false;
+
+        for (int d = 0; d < SpaceDim; ++d) {
+            m_alias[d].exchangeBegin(m_exCornerCopier1[d]);
+        }
+        for (int d = 0; d < SpaceDim; ++d) {
+            m_alias[d].exchangeEnd();
+        }
+
+        for (int d = 0; d < SpaceDim; ++d) {
+            m_alias[d].exchangeBegin(m_exCornerCopier2[d]);
+        }
+        for (int d = 0; d < SpaceDim; ++d) {
+            m_alias[d].exchangeEnd();
+        }
+    }
 }
 
 
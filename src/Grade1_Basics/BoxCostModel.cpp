@@ -0,0 +1,171 @@
+/*******************************************************************************
+ *  SOMAR - Stratified Ocean Model with Adaptive Refinement
+ *  Developed by Ed Santilli & Alberto Scotti
+ *  Copyright (C) 2024 Thomas Jefferson University and Arizona State University
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ *
+ *  For up-to-date contact information, please visit the repository homepage,
+ *  https://github.com/MUON-CFD/SOMAR.
+ ******************************************************************************/
+#include "BoxCostModel.H"
+#include "LayoutIterator.H"
+#include "SPMD.H"
+#include <algorithm>
+#include <cmath>
+#include <map>
+
+
+namespace {
+
+struct LevelCosts
+{
+    DisjointBoxLayout   grids;
+    std::vector<double> seconds;
+};
+
+std::map<int, LevelCosts>&
+getRegistry()
+{
+    static std::map<int, LevelCosts> s_registry;
+    return s_registry;
+}
+
+};  // namespace
+
+
+// -----------------------------------------------------------------------------
+std::vector<double>&
+BoxCostModel::costs(const int a_level, const DisjointBoxLayout& a_grids)
+{
+    LevelCosts& entry = getRegistry()[a_level];
+    if (!(entry.grids == a_grids)) {
+        entry.grids = a_grids;
+        entry.seconds.assign(a_grids.size(), 0.0);
+    }
+    return entry.seconds;
+}
+
+
+// -----------------------------------------------------------------------------
+std::vector<double>*
+BoxCostModel::findCosts(const int a_level, const DisjointBoxLayout& a_grids)
+{
+    auto it = getRegistry().find(a_level);
+    if (it == getRegistry().end() || !(it->second.grids == a_grids)) {
+        return nullptr;
+    }
+    return &it->second.seconds;
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+BoxCostModel::estimateLoads(Vector<long long>& a_loads,
+                            Real&              a_measuredImbalance,
+                            const Vector<Box>& a_boxes,
+                            const int          a_level)
+{
+    a_loads.resize(a_boxes.size());
+    for (size_t i = 0; i < a_boxes.size(); ++i) {
+        a_loads[i] = a_boxes[i].numPts();
+    }
+    a_measuredImbalance = -1.0;
+
+    // Every rank must have timed the same layout. Ranks without boxes still
+    // register the layout when they pass through the timed loops.
+    // Reducing (n, -n) with MAX gives (max n, -min n) in one call.
+    auto it = getRegistry().find(a_level);
+    const bool haveCosts = (it != getRegistry().end());
+    long       numOld[2] = {haveCosts ? (long)it->second.grids.size() : -1, 0};
+    numOld[1] = -numOld[0];
+#ifdef CH_MPI
+    MPI_Allreduce(
+        MPI_IN_PLACE, numOld, 2, MPI_LONG, MPI_MAX, Chombo_MPI::comm);
+#endif
+    if (numOld[0] <= 0 || numOld[0] != -numOld[1]) return false;
+
+    const DisjointBoxLayout& oldGrids = it->second.grids;
+    std::vector<double>      seconds  = it->second.seconds;
+#ifdef CH_MPI
+    MPI_Allreduce(MPI_IN_PLACE, seconds.data(), seconds.size(), MPI_DOUBLE,
+                  MPI_SUM, Chombo_MPI::comm);
+#endif
+
+    // Cost density of each old box, and the rank totals.
+    std::vector<Box>    oldBoxes(seconds.size());
+    std::vector<double> density(seconds.size());
+    std::vector<double> rankTotal(numProc(), 0.0);
+    double totalSeconds = 0.0;
+    double totalPts     = 0.0;
+    for (LayoutIterator lit = oldGrids.layoutIterator(); lit.ok(); ++lit) {
+        const int idx  = lit().intCode();
+        oldBoxes[idx]  = oldGrids[lit];
+        density[idx]   = seconds[idx] / oldBoxes[idx].numPts();
+        totalSeconds  += seconds[idx];
+        totalPts      += oldBoxes[idx].numPts();
+
+        const int rank = oldGrids.procID(lit());
+        if (rank < int(numProc())) rankTotal[rank] += seconds[idx];
+    }
+    if (totalSeconds <= 0.0) return false;
+
+    a_measuredImbalance =
+        *std::max_element(rankTotal.begin(), rankTotal.end())
+        / (totalSeconds / numProc());
+
+    // Overlap-weighted estimate for each new box.
+    const double meanDensity = totalSeconds / totalPts;
+    for (size_t i = 0; i < a_boxes.size(); ++i) {
+        const Box& newBox  = a_boxes[i];
+        double     cost    = 0.0;
+        long long  covered = 0;
+
+        for (size_t idx = 0; idx < oldBoxes.size(); ++idx) {
+            if (!newBox.intersectsNotEmpty(oldBoxes[idx])) continue;
+
+            const long long overlap = (newBox & oldBoxes[idx]).numPts();
+            cost    += density[idx] * overlap;
+            covered += overlap;
+        }
+        cost += meanDensity * (newBox.numPts() - covered);
+
+        a_loads[i] = std::max(1LL, std::llround(cost * 1.0e9));
+    }
+
+    return true;
+}
+
+
+// -----------------------------------------------------------------------------
+Real
+BoxCostModel::imbalance(const Vector<long long>& a_loads,
+                        const Vector<int>&       a_procMap)
+{
+    CH_assert(a_loads.size() == a_procMap.size());
+
+    std::vector<long long> rankTotal(numProc(), 0);
+    long long              total = 0;
+    for (size_t i = 0; i < a_loads.size(); ++i) {
+        rankTotal[a_procMap[i]] += a_loads[i];
+        total += a_loads[i];
+    }
+    if (total == 0) return 1.0;
+
+    const long long maxTotal =
+        *std::max_element(rankTotal.begin(), rankTotal.end());
+    return Real(maxTotal) / (Real(total) / numProc());
+}
@@ -22,6 +22,7 @@
  *  https://github.com/MUON-CFD/SOMAR.
  ******************************************************************************/
 #include "LayoutTools.H"
+#include "CopierCache.H"
 #include "MergeBoxesOnLines.H"
 #include "AnisotropicMeshRefine.H"
 #include "NeighborIterator.H"
@@ -169,6 +170,81 @@ defineImpartialCopier(std::array<StaggeredCopier, CH_SPACEDIM>& a_copier,
 }
 
 
+// -----------------------------------------------------------------------------
+std::shared_ptr<const Copier>
+cachedImpartialCopier(const BoxLayout&     a_srcLayout,
+                      const BoxLayout&     a_destLayout,
+                      const ProblemDomain& a_domain,
+                      const IntVect&       a_srcGhostVect,
+                      const IntVect&       a_destGhostVect)
+{
+    const CopierCache::Key key(a_srcLayout,
+                               a_destLayout,
+                               a_domain,
+                               a_srcGhostVect,
+                               a_destGhostVect,
+                               CopierCache::Impartial);
+
+    return CopierCache::get<Copier>(key, [&](Copier& a_copier) {
+        defineImpartialCopier(a_copier,
+                              a_srcLayout,
+                              a_destLayout,
+                              a_domain,
+                              a_srcGhostVect,
+                              a_destGhostVect);
+    });
+}
+
+
+// -----------------------------------------------------------------------------
+std::shared_ptr<const StaggeredCopier>
+cachedImpartialCopier(const int            a_fcDir,
+                      const BoxLayout&     a_srcLayout,
+                      const BoxLayout&     a_destLayout,
+                      const ProblemDomain& a_domain,
+                      const IntVect&       a_srcGhostVect,
+                      const IntVect&       a_destGhostVect)
+{
+    const CopierCache::Key key(a_srcLayout,
+                               a_destLayout,
+                               a_domain,
+                               a_srcGhostVect,
+                               a_destGhostVect,
+                               CopierCache::Impartial,
+                               a_fcDir);
+
+    return CopierCache::get<StaggeredCopier>(key, [&](StaggeredCopier& a_copier) {
+        defineImpartialCopier(a_copier,
+                              a_fcDir,
+                              a_srcLayout,
+                              a_destLayout,
+                              a_domain,
+                              a_srcGhostVect,
+                              a_destGhostVect);
+    });
+}
+
+
+// -----------------------------------------------------------------------------
+void
+cachedImpartialCopier(std::array<StaggeredCopier, CH_SPACEDIM>& a_copier,
+                      const BoxLayout&                          a_srcLayout,
+                      const BoxLayout&                          a_destLayout,
+                      const ProblemDomain&                      a_domain,
+                      const IntVect&                            a_srcGhostVect,
+                      const IntVect&                            a_destGhostVect)
+{
+    for (int fcDir = 0; fcDir < SpaceDim; ++fcDir) {
+        a_copier[fcDir] = *cachedImpartialCopier(fcDir,
+                                                 a_srcLayout,
+                                                 a_destLayout,
+                                                 a_domain,
+                                                 a_srcGhostVect,
+                                                 a_destGhostVect);
+    }
+}
+
+
 // -----------------------------------------------------------------------------
 std::vector<Real>
 domainDecompCoordVec(const std::vector<Real>& a_globalCoords,
@@ -727,4 +803,53 @@ averageOverlappingValidFaces(LevelData<FluxBox>& a_data)
 }
 
 
+// -----------------------------------------------------------------------------
+// Splits a region of a box into an interior and boundary strips.
+// -----------------------------------------------------------------------------
+void
+splitInterior(Box&         a_interior,
+              Vector<Box>& a_strips,
+              const Box&   a_region,
+              const Box&   a_ccValid,
+              const int    a_depth)
+{
+    CH_assert(a_ccValid.type() == IntVect::Zero);
+    CH_assert(a_depth >= 0);
+
+    a_strips.clear();
+
+    Box ccInterior = grow(a_ccValid, -a_depth);
+    if (ccInterior.isEmpty()) {
+        a_interior = Box();
+        if (!a_region.isEmpty()) a_strips.push_back(a_region);
+        return;
+    }
+
+    a_interior = ccInterior.convert(a_region.ixType()) & a_region;
+    if (a_interior.isEmpty()) {
+        a_interior = Box();
+        if (!a_region.isEmpty()) a_strips.push_back(a_region);
+        return;
+    }
+
+    // Peel a slab off each side of what remains, one direction at a time.
+    Box remainder = a_region;
+    for (int dir = 0; dir < SpaceDim; ++dir) {
+        if (remainder.smallEnd(dir) < a_interior.smallEnd(dir)) {
+            Box slab = remainder;
+            slab.setBig(dir, a_interior.smallEnd(dir) - 1);
+            a_strips.push_back(slab);
+            remainder.setSmall(dir, a_interior.smallEnd(dir));
+        }
+        if (remainder.bigEnd(dir) > a_interior.bigEnd(dir)) {
+            Box slab = remainder;
+            slab.setSmall(dir, a_interior.bigEnd(dir) + 1);
+            a_strips.push_back(slab);
+            remainder.setBig(dir, a_interior.bigEnd(dir));
+        }
+    }
+    CH_assert(remainder == a_interior);
+}
+
+
 }; // end LayoutTools namespace
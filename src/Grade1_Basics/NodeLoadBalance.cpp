@@ -0,0 +1,268 @@
+/*******************************************************************************
+ *  SOMAR - Stratified Ocean Model with Adaptive Refinement
+ *  Developed by Ed Santilli & Alberto Scotti
+ *  Copyright (C) 2024 Thomas Jefferson University and Arizona State University
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ *
+ *  For up-to-date contact information, please visit the repository homepage,
+ *  https://github.com/MUON-CFD/SOMAR.
+ ******************************************************************************/
+#include "NodeLoadBalance.H"
+#include "LoadBalance.H"
+#include "SPMD.H"
+#include <map>
+#include <vector>
+
+
+namespace {
+
+struct Topology
+{
+    std::vector<int>              nodeOfRank;
+    std::vector<std::vector<int>> ranksOfNode;
+};
+
+// Collective. Each rank learns the lowest rank on its node, then everyone
+// shares what they learned.
+Topology
+buildTopology()
+{
+    std::vector<int> leaders(numProc(), 0);
+
+#ifdef CH_MPI
+    MPI_Comm nodeComm;
+    MPI_Comm_split_type(Chombo_MPI::comm,
+                        MPI_COMM_TYPE_SHARED,
+                        procID(),
+                        MPI_INFO_NULL,
+                        &nodeComm);
+
+    int leader = procID();
+    MPI_Allreduce(MPI_IN_PLACE, &leader, 1, MPI_INT, MPI_MIN, nodeComm);
+    MPI_Comm_free(&nodeComm);
+
+    MPI_Allgather(
+        &leader, 1, MPI_INT, leaders.data(), 1, MPI_INT, Chombo_MPI::comm);
+#endif
+
+    // Number the nodes in order of their leaders.
+    std::map<int, int> nodeOfLeader;
+    for (const int leader : leaders) {
+        nodeOfLeader.emplace(leader, 0);
+    }
+    int numNodes = 0;
+    for (auto& entry : nodeOfLeader) {
+        entry.second = numNodes++;
+    }
+
+    Topology topo;
+    topo.nodeOfRank.resize(numProc());
+    topo.ranksOfNode.resize(numNodes);
+    for (int rank = 0; rank < int(numProc()); ++rank) {
+        const int node = nodeOfLeader[leaders[rank]];
+        topo.nodeOfRank[rank] = node;
+        topo.ranksOfNode[node].push_back(rank);
+    }
+    return topo;
+}
+
+const Topology&
+getTopology()
+{
+    static const Topology s_topo = buildTopology();
+    return s_topo;
+}
+
+};  // namespace
+
+
+// -----------------------------------------------------------------------------
+int
+NodeLoadBalance::numNodes()
+{
+    return getTopology().ranksOfNode.size();
+}
+
+
+// -----------------------------------------------------------------------------
+int
+NodeLoadBalance::nodeOf(const int a_rank)
+{
+    CH_assert(0 <= a_rank && a_rank < int(numProc()));
+    return getTopology().nodeOfRank[a_rank];
+}
+
+
+// -----------------------------------------------------------------------------
+void
+NodeLoadBalance::balance(Vector<int>&             a_procMap,
+                         const Vector<long long>& a_loads,
+                         const Vector<Box>&       a_boxes)
+{
+    CH_assert(a_loads.size() == a_boxes.size());
+
+    const Topology& topo     = getTopology();
+    const int       numNodes = topo.ranksOfNode.size();
+    const int       numBoxes = a_boxes.size();
+
+    // With one node, or too few boxes to go around, the node split cannot
+    // help. Let LoadBalance give each box its own rank.
+    if (numNodes == 1 || numBoxes <= int(numProc())) {
+        LoadBalance(a_procMap, a_loads, a_boxes);
+        return;
+    }
+
+    // 1. Cut the curve into one piece per node. A box goes to the node whose
+    //    share of the total load contains the box's midpoint.
+    double totalLoad = 0.0;
+    for (int ibox = 0; ibox < numBoxes; ++ibox) {
+        totalLoad += a_loads[ibox];
+    }
+
+    std::vector<int> nodeBegin(numNodes + 1, numBoxes);
+    {
+        int    node       = 0;
+        int    ranksSoFar = topo.ranksOfNode[0].size();
+        double prefixLoad = 0.0;
+
+        nodeBegin[0] = 0;
+        for (int ibox = 0; ibox < numBoxes; ++ibox) {
+            const double mid = prefixLoad + 0.5 * a_loads[ibox];
+            while (node < numNodes - 1 &&
+                   mid >= totalLoad * ranksSoFar / numProc()) {
+                ++node;
+                ranksSoFar += topo.ranksOfNode[node].size();
+                nodeBegin[node] = ibox;
+            }
+            prefixLoad += a_loads[ibox];
+        }
+    }
+
+    // 2. Spread each node's piece over its ranks.
+    a_procMap.resize(numBoxes);
+    for (int node = 0; node < numNodes; ++node) {
+        const int begin = nodeBegin[node];
+        const int end   = nodeBegin[node + 1];
+        if (begin == end) continue;
+
+        const std::vector<int>& ranks = topo.ranksOfNode[node];
+
+        Vector<long long> subLoads(end - begin);
+        Vector<Box>       subBoxes(end - begin);
+        for (int ibox = begin; ibox < end; ++ibox) {
+            subLoads[ibox - begin] = a_loads[ibox];
+            subBoxes[ibox - begin] = a_boxes[ibox];
+        }
+
+        Vector<int> subProcMap;
+        LoadBalance(subProcMap, subLoads, subBoxes, ranks.size());
+
+        for (int ibox = begin; ibox < end; ++ibox) {
+            a_procMap[ibox] = ranks[subProcMap[ibox - begin]];
+        }
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+NodeLoadBalance::balance(Vector<int>& a_procMap, const Vector<Box>& a_boxes)
+{
+    Vector<long long> loads(a_boxes.size());
+    for (size_t ibox = 0; ibox < a_boxes.size(); ++ibox) {
+        loads[ibox] = a_boxes[ibox].numPts();
+    }
+    NodeLoadBalance::balance(a_procMap, loads, a_boxes);
+}
+
+
+// -----------------------------------------------------------------------------
+void
+NodeLoadBalance::defineAndLoadBalance(DisjointBoxLayout&   a_grids,
+                                      Vector<Box>          a_boxes,
+                                      const ProblemDomain& a_domain,
+                                      const std::string&   a_reportLabel)
+{
+    mortonOrdering(a_boxes);
+
+    Vector<int> procMap;
+    NodeLoadBalance::balance(procMap, a_boxes);
+
+    if (!a_reportLabel.empty()) {
+        Vector<int> flatProcMap;
+        LoadBalance(flatProcMap, a_boxes);
+        NodeLoadBalance::printTraffic(
+            pout(), a_reportLabel, a_boxes, flatProcMap, procMap);
+    }
+
+    a_grids.define(a_boxes, procMap, a_domain);
+}
+
+
+// -----------------------------------------------------------------------------
+NodeLoadBalance::Traffic
+NodeLoadBalance::exchangeTraffic(const Vector<Box>& a_boxes,
+                                 const Vector<int>& a_procMap)
+{
+    CH_assert(a_procMap.size() == a_boxes.size());
+
+    Traffic traffic;
+    const int numBoxes = a_boxes.size();
+
+    for (int i = 0; i < numBoxes; ++i) {
+        const Box ghostBox = grow(a_boxes[i], 1);
+
+        for (int j = 0; j < numBoxes; ++j) {
+            if (i == j || !ghostBox.intersectsNotEmpty(a_boxes[j])) continue;
+
+            const long long cells = (ghostBox & a_boxes[j]).numPts();
+            const int       ri    = a_procMap[i];
+            const int       rj    = a_procMap[j];
+
+            if (ri == rj) {
+                traffic.onRank += cells;
+            } else if (nodeOf(ri) == nodeOf(rj)) {
+                traffic.onNode += cells;
+            } else {
+                traffic.offNode += cells;
+            }
+        }
+    }
+
+    return traffic;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+NodeLoadBalance::printTraffic(std::ostream&      a_os,
+                              const std::string& a_label,
+                              const Vector<Box>& a_boxes,
+                              const Vector<int>& a_oldProcMap,
+                              const Vector<int>& a_newProcMap)
+{
+    const Traffic oldTraffic = exchangeTraffic(a_boxes, a_oldProcMap);
+    const Traffic newTraffic = exchangeTraffic(a_boxes, a_newProcMap);
+    constexpr long long bytesPerCell = sizeof(Real);
+
+    a_os << a_label << " exchange bytes per component (inter-node / intra-node)"
+         << " on " << numNodes() << " nodes: "
+         << oldTraffic.offNode * bytesPerCell << " / "
+         << oldTraffic.onNode * bytesPerCell << " before, "
+         << newTraffic.offNode * bytesPerCell << " / "
+         << newTraffic.onNode * bytesPerCell << " after." << std::endl;
+}
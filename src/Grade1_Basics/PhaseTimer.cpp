@@ -0,0 +1,327 @@
+/*******************************************************************************
+ *  SOMAR - Stratified Ocean Model with Adaptive Refinement
+ *  Developed by Ed Santilli & Alberto Scotti
+ *  Copyright (C) 2024 Thomas Jefferson University and Arizona State University
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ *
+ *  For up-to-date contact information, please visit the repository homepage,
+ *  https://github.com/MUON-CFD/SOMAR.
+ ******************************************************************************/
+#include "PhaseTimer.H"
+#include "Arena.H"
+#include "SPMD.H"
+#include "parstream.H"
+#include "Format.H"
+#include "ThreadTools.H"
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <set>
+#include <sstream>
+#include <vector>
+
+
+namespace {
+
+struct PhaseStats
+{
+    long   calls    = 0;
+    double inclTime = 0.0;
+    double selfTime = 0.0;
+    int    arenaID  = -1;  // PoolArena subsystem, looked up on first use.
+};
+
+using PhaseKey = std::pair<std::string, int>;  // (phase, level)
+
+std::map<PhaseKey, PhaseStats>&
+getRegistry()
+{
+    static std::map<PhaseKey, PhaseStats> s_registry;
+    return s_registry;
+}
+
+PhaseTimer::Scope* s_topScopePtr = nullptr;
+
+};  // namespace
+
+
+// -----------------------------------------------------------------------------
+PhaseTimer::Phase::Phase(const std::string& a_name)
+: m_name(a_name)
+, m_statsPtrs()
+{
+}
+
+
+// -----------------------------------------------------------------------------
+void*
+PhaseTimer::Phase::getStats(const int a_level) const
+{
+    // Registry nodes are never erased, so the cached pointers stay valid.
+    const size_t idx = static_cast<size_t>(a_level + 1);
+    if (idx >= m_statsPtrs.size()) {
+        m_statsPtrs.resize(idx + 1, nullptr);
+    }
+    if (!m_statsPtrs[idx]) {
+        m_statsPtrs[idx] = &getRegistry()[PhaseKey(m_name, a_level)];
+    }
+    return m_statsPtrs[idx];
+}
+
+
+// -----------------------------------------------------------------------------
+PhaseTimer::Scope::Scope(const char* a_phase, const int a_level)
+{
+    const std::string phase(a_phase);
+    const int level = (a_level == s_inheritLevel ? PhaseTimer::currentLevel()
+                                                 : a_level);
+    this->start(phase, &getRegistry()[PhaseKey(phase, level)], level);
+}
+
+
+// -----------------------------------------------------------------------------
+PhaseTimer::Scope::Scope(const std::string& a_phase, const int a_level)
+{
+    const int level = (a_level == s_inheritLevel ? PhaseTimer::currentLevel()
+                                                 : a_level);
+    this->start(a_phase, &getRegistry()[PhaseKey(a_phase, level)], level);
+}
+
+
+// -----------------------------------------------------------------------------
+PhaseTimer::Scope::Scope(const Phase& a_phase, const int a_level)
+{
+    const int level = (a_level == s_inheritLevel ? PhaseTimer::currentLevel()
+                                                 : a_level);
+    this->start(a_phase.name(), a_phase.getStats(level), level);
+}
+
+
+// -----------------------------------------------------------------------------
+void
+PhaseTimer::Scope::start(const std::string& a_phase,
+                         void*              a_statsPtr,
+                         const int          a_level)
+{
+    m_parentPtr = s_topScopePtr;
+    m_childTime = 0.0;
+    m_level     = a_level;
+    m_statsPtr  = a_statsPtr;
+
+    // FAB memory allocated from a PoolArena is accounted to this phase.
+    PhaseStats& stats = *static_cast<PhaseStats*>(m_statsPtr);
+    if (stats.arenaID < 0) {
+        stats.arenaID = PoolArena::subsystemID(a_phase);
+    }
+    m_prevArenaID = PoolArena::setSubsystem(stats.arenaID);
+
+    s_topScopePtr = this;
+    m_startTime   = Clock::now();
+}
+
+
+// -----------------------------------------------------------------------------
+PhaseTimer::Scope::~Scope()
+{
+    const std::chrono::duration<double> elapsed = Clock::now() - m_startTime;
+
+    PhaseStats& stats = *static_cast<PhaseStats*>(m_statsPtr);
+    stats.calls    += 1;
+    stats.selfTime += elapsed.count() - m_childTime;
+
+    // If this phase is nested within itself, the outermost scope already
+    // accounts for this interval.
+    bool isOutermost = true;
+    for (const Scope* ptr = m_parentPtr; ptr; ptr = ptr->m_parentPtr) {
+        if (ptr->m_statsPtr == m_statsPtr) {
+            isOutermost = false;
+            break;
+        }
+    }
+    if (isOutermost) {
+        stats.inclTime += elapsed.count();
+    }
+
+    if (m_parentPtr) {
+        m_parentPtr->m_childTime += elapsed.count();
+    }
+    s_topScopePtr = m_parentPtr;
+    PoolArena::setSubsystem(m_prevArenaID);
+}
+
+
+// -----------------------------------------------------------------------------
+int
+PhaseTimer::currentLevel()
+{
+    return (s_topScopePtr ? s_topScopePtr->m_level : -1);
+}
+
+
+// -----------------------------------------------------------------------------
+void
+PhaseTimer::reset()
+{
+    // Open scopes still point into the registry, so zero the stats in place.
+    for (auto& kv : getRegistry()) {
+        kv.second = PhaseStats();
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+PhaseTimer::writeReport(const std::string& a_fileName)
+{
+    const auto& registry = getRegistry();
+    const int   numRanks = numProc();
+
+    // Each rank may have seen a different set of phases. Build the union.
+    std::vector<PhaseKey> keys;
+    {
+        std::ostringstream localKeys;
+        for (const auto& kv : registry) {
+            localKeys << kv.first.first << '\t' << kv.first.second << '\n';
+        }
+        std::string allKeys = localKeys.str();
+
+#ifdef CH_MPI
+        int localLen = allKeys.size();
+        std::vector<int> lens(numRanks, 0), offsets(numRanks, 0);
+        MPI_Gather(&localLen, 1, MPI_INT, lens.data(), 1, MPI_INT, 0,
+                   Chombo_MPI::comm);
+
+        int totalLen = 0;
+        for (int r = 0; r < numRanks; ++r) {
+            offsets[r] = totalLen;
+            totalLen += lens[r];
+        }
+
+        std::vector<char> buf(std::max(totalLen, 1));
+        MPI_Gatherv(allKeys.data(), localLen, MPI_CHAR,
+                    buf.data(), lens.data(), offsets.data(), MPI_CHAR,
+                    0, Chombo_MPI::comm);
+
+        if (procID() == 0) {
+            allKeys.assign(buf.data(), totalLen);
+        }
+#endif
+
+        std::set<PhaseKey> keySet;
+        std::istringstream is(allKeys);
+        std::string line;
+        while (std::getline(is, line)) {
+            const size_t tab = line.rfind('\t');
+            keySet.emplace(line.substr(0, tab), std::stoi(line.substr(tab + 1)));
+        }
+
+#ifdef CH_MPI
+        std::ostringstream unionKeys;
+        for (const auto& key : keySet) {
+            unionKeys << key.first << '\t' << key.second << '\n';
+        }
+        allKeys = unionKeys.str();
+
+        int unionLen = allKeys.size();
+        MPI_Bcast(&unionLen, 1, MPI_INT, 0, Chombo_MPI::comm);
+        allKeys.resize(unionLen);
+        MPI_Bcast(&allKeys[0], unionLen, MPI_CHAR, 0, Chombo_MPI::comm);
+
+        keySet.clear();
+        is.clear();
+        is.str(allKeys);
+        while (std::getline(is, line)) {
+            const size_t tab = line.rfind('\t');
+            keySet.emplace(line.substr(0, tab), std::stoi(line.substr(tab + 1)));
+        }
+#endif
+        keys.assign(keySet.begin(), keySet.end());
+    }
+
+    // Pack local stats: [calls, incl, self] per key.
+    const int numKeys = keys.size();
+    std::vector<double> localStats(3 * numKeys, 0.0);
+    for (int k = 0; k < numKeys; ++k) {
+        const auto it = registry.find(keys[k]);
+        if (it == registry.end()) continue;
+        localStats[3 * k + 0] = it->second.calls;
+        localStats[3 * k + 1] = it->second.inclTime;
+        localStats[3 * k + 2] = it->second.selfTime;
+    }
+
+    std::vector<double> minStats(localStats), maxStats(localStats),
+        sumStats(localStats);
+#ifdef CH_MPI
+    if (numKeys > 0) {
+        MPI_Reduce(localStats.data(), minStats.data(), 3 * numKeys,
+                   MPI_DOUBLE, MPI_MIN, 0, Chombo_MPI::comm);
+        MPI_Reduce(localStats.data(), maxStats.data(), 3 * numKeys,
+                   MPI_DOUBLE, MPI_MAX, 0, Chombo_MPI::comm);
+        MPI_Reduce(localStats.data(), sumStats.data(), 3 * numKeys,
+                   MPI_DOUBLE, MPI_SUM, 0, Chombo_MPI::comm);
+    }
+#endif
+
+    if (procID() != 0) return;
+
+    std::ofstream file(a_fileName);
+    if (!file) {
+        pout() << "PhaseTimer: could not open " << a_fileName
+               << " for writing." << std::endl;
+        return;
+    }
+
+    file << "phase,level,calls,"
+         << "incl_min,incl_mean,incl_max,"
+         << "self_min,self_mean,self_max\n";
+    file << std::setprecision(6) << std::scientific;
+    for (int k = 0; k < numKeys; ++k) {
+        file << '"' << keys[k].first << '"' << ','
+             << keys[k].second << ','
+             << static_cast<long>(maxStats[3 * k + 0]) << ','
+             << minStats[3 * k + 1] << ','
+             << sumStats[3 * k + 1] / numRanks << ','
+             << maxStats[3 * k + 1] << ','
+             << minStats[3 * k + 2] << ','
+             << sumStats[3 * k + 2] / numRanks << ','
+             << maxStats[3 * k + 2] << '\n';
+    }
+
+    // Brief summary, sorted by the max self time.
+    std::vector<int> order(numKeys);
+    for (int k = 0; k < numKeys; ++k) order[k] = k;
+    std::sort(order.begin(), order.end(), [&](const int a, const int b) {
+        return maxStats[3 * a + 2] > maxStats[3 * b + 2];
+    });
+
+    // The thread count makes reports from a strong-scaling sweep
+    // (OMP_NUM_THREADS = 1, 2, 4, ...) easy to tell apart.
+    pout() << "PhaseTimer report (self time over " << numRanks
+           << " ranks x " << omp_get_max_threads()
+           << " threads, written to " << a_fileName << "):\n"
+           << Format::indent() << std::flush;
+    for (const int k : order) {
+        pout() << std::setw(24) << std::left << keys[k].first
+               << " level " << std::setw(3) << keys[k].second
+               << "  min " << Format::textTime(minStats[3 * k + 2])
+               << "  mean " << Format::textTime(sumStats[3 * k + 2] / numRanks)
+               << "  max " << Format::textTime(maxStats[3 * k + 2])
+               << '\n';
+    }
+    pout() << Format::unindent << std::endl;
+}
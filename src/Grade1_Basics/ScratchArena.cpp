@@ -0,0 +1,79 @@
+/*******************************************************************************
+ *  SOMAR - Stratified Ocean Model with Adaptive Refinement
+ *  Developed by Ed Santilli & Alberto Scotti
+ *  Copyright (C) 2024 Thomas Jefferson University and Arizona State University
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ *
+ *  For up-to-date contact information, please visit the repository homepage,
+ *  https://github.com/MUON-CFD/SOMAR.
+ ******************************************************************************/
+#include "ScratchArena.H"
+
+
+// -----------------------------------------------------------------------------
+void
+ScratchArena::define(FArrayBox& a_fab,
+                     const int  a_slot,
+                     const Box& a_box,
+                     const int  a_nComp)
+{
+    CH_assert(a_slot >= 0);
+    CH_assert(a_nComp > 0);
+    CH_assert(!a_box.isEmpty());
+
+    std::vector<std::vector<Real>>& slots = getSlots();
+    if (a_slot >= (int)slots.size()) {
+        slots.resize(a_slot + 1);
+    }
+
+    std::vector<Real>& slot     = slots[a_slot];
+    const size_t       numReals = a_box.numPts() * a_nComp;
+    if (slot.size() < numReals) {
+        slot.resize(numReals);
+    }
+
+    a_fab.define(a_box, a_nComp, slot.data());
+}
+
+
+// -----------------------------------------------------------------------------
+size_t
+ScratchArena::bytes()
+{
+    size_t numReals = 0;
+    for (const auto& slot : getSlots()) {
+        numReals += slot.size();
+    }
+    return numReals * sizeof(Real);
+}
+
+
+// -----------------------------------------------------------------------------
+void
+ScratchArena::clear()
+{
+    getSlots().clear();
+}
+
+
+// -----------------------------------------------------------------------------
+std::vector<std::vector<Real>>&
+ScratchArena::getSlots()
+{
+    thread_local std::vector<std::vector<Real>> s_slots;
+    return s_slots;
+}
@@ -59,9 +59,15 @@ AMRParameters::dump() const
     pout() << "maxGridSize = " << maxGridSize << "\n";
     pout() << "bufferSize = " << bufferSize << "\n";
     pout() << "fillRatio = " << fillRatio << "\n";
+    pout() << "parallelClustering = " << (parallelClustering ? "true" : "false") << "\n";
 
     pout() << "regridIntervals = " << regridIntervals << "\n";
     pout() << "useSubcycling = " << (useSubcycling ? "true" : "false") << "\n";
+    pout() << "loadBalanceByCost = " << (loadBalanceByCost ? "true" : "false") << "\n";
+    pout() << "loadBalanceByNode = " << (loadBalanceByNode ? "true" : "false") << "\n";
+    pout() << "reportNodeTraffic = " << (reportNodeTraffic ? "true" : "false") << "\n";
+    pout() << "usePoolArena = " << (usePoolArena ? "true" : "false") << "\n";
+    pout() << "poolArenaMaxCachedMB = " << poolArenaMaxCachedMB << "\n";
 
     pout() << "tagIB = " << (tagIB ? "true" : "false") << "\n";
     pout() << "velTagTol = " << velTagTol << "\n";
@@ -145,6 +151,9 @@ AMRParameters::createDefaults(const BaseParameters& a_baseParams)
     s_defPtr->fillRatio = 0.80;
     pp.query("fillRatio", s_defPtr->fillRatio);
 
+    s_defPtr->parallelClustering = false;
+    pp.query("parallelClustering", s_defPtr->parallelClustering);
+
     const int numReadLevels = Max(s_defPtr->maxLevel, 1);
     std::vector<int> vintLevels(numReadLevels, 10);
     s_defPtr->regridIntervals = vintLevels;
@@ -156,6 +165,23 @@ AMRParameters::createDefaults(const BaseParameters& a_baseParams)
     s_defPtr->useSubcycling = true;
     pp.query("useSubcycling", s_defPtr->useSubcycling);
 
+    s_defPtr->loadBalanceByCost = false;
+    pp.query("loadBalanceByCost", s_defPtr->loadBalanceByCost);
+
+    s_defPtr->loadBalanceByNode = false;
+    pp.query("loadBalanceByNode", s_defPtr->loadBalanceByNode);
+
+    // The traffic count compares every pair of boxes. Off unless asked for.
+    s_defPtr->reportNodeTraffic = false;
+    pp.query("reportNodeTraffic", s_defPtr->reportNodeTraffic);
+
+    s_defPtr->usePoolArena = false;
+    pp.query("usePoolArena", s_defPtr->usePoolArena);
+
+    s_defPtr->poolArenaMaxCachedMB = 0;
+    pp.query("poolArenaMaxCachedMB", s_defPtr->poolArenaMaxCachedMB);
+    CH_verify(s_defPtr->poolArenaMaxCachedMB >= 0);
+
     // Tag tol
     s_defPtr->tagIB         = false;
     s_defPtr->velTagTol     = -1.0;
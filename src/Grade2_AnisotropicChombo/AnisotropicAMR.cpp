@@ -15,10 +15,12 @@ using std::endl;
 #include "AnisotropicAMR.H"
 #include "BoxIterator.H"
 #include "CH_Timer.H"
+#include "CopierCache.H"
 #include "IntVectSet.H"
 #include "Tuple.H"
 #include "parstream.H"
 #include "Debug.H"
+#include "PhaseTimer.H"
 #include "HeaderData.H"
 #ifdef CH_USE_PYTHON
 #include "PyGlue.H"
@@ -90,6 +92,7 @@ AnisotropicAMR::setDefaultValues()
     m_use_meshrefine        = false;
     m_plotfile_prefix       = string("pltstate");
     m_checkpointfile_prefix = string("chk");
+    m_asyncPlot             = false;
     m_verbosity             = 0;
     m_cur_time              = 0;
     m_dt_tolerance_factor   = 1.1;
@@ -194,12 +197,14 @@ AnisotropicAMR::AnisotropicAMR(
                          a_amrParams.bufferSize,
                          m_max_grid_size,
                          IntVect::Unit - m_splitDirs);
+    m_mesh_refine.setParallelClustering(a_amrParams.parallelClustering);
 
     useSubcyclingInTime(a_amrParams.useSubcycling);
 
     plotInterval(a_outputParams.plotInterval);
     plotPeriod(a_outputParams.plotPeriod);
     plotPrefix(a_outputParams.plotPrefix);
+    m_asyncPlot = a_outputParams.asyncPlot;
     checkpointInterval(a_outputParams.checkpointInterval);
     checkpointPrefix(a_outputParams.checkpointPrefix);
 
@@ -1299,6 +1304,7 @@ void
 AnisotropicAMR::regrid(int a_base_level)
 {
     CH_TIME("AnisotropicAMR::regrid");
+    PhaseTimer::Scope phaseTimer("Regrid", a_base_level);
 
     CH_assert(isDefined());
     CH_assert(isSetUp());
@@ -1414,6 +1420,9 @@ AnisotropicAMR::regrid(int a_base_level)
         m_amrlevels[level]->regrid(Vector<Box>());
     }
 
+    // The cached Copiers hold on to the old grids. Let them go.
+    CopierCache::clear();
+
     // now that the new hierarchy is defined, do post-regridding ops
     // (dfm 8/26/05 -- call postRegrid on base_level as well, to
     // cover the case where all levels finer than base_level are removed)
@@ -1743,6 +1752,7 @@ void
 AnisotropicAMR::writePlotFile() const
 {
     CH_TIME("AnisotropicAMR::writePlotFile");
+    PhaseTimer::Scope phaseTimer("I/O");
 
     CH_assert(m_isDefined);
 
@@ -1779,6 +1789,10 @@ AnisotropicAMR::writePlotFile() const
      if (m_verbosity >= 3) {
          pout() << header << endl;
      }
+    // Async plotfiles are written to a temp file and renamed in the
+    // background, once the write is complete.
+    if (m_asyncPlot) tmpFile = iter_str;
+
     constexpr bool checkpoint = false;
     m_amrlevels[0]->openFile(tmpFile,checkpoint);
     // write physics class header data
@@ -1792,7 +1806,7 @@ AnisotropicAMR::writePlotFile() const
 
     // after the write is complete, we rename it
     barrier();
-    if (procID() == 0) {
+    if (procID() == 0 && !m_asyncPlot) {
         std::string mv("mv -f ");
         mv += tmpFile;
         mv += std::string(" ");
@@ -1813,6 +1827,7 @@ void
 AnisotropicAMR::writeCheckpointFile() const
 {
     CH_TIME("AnisotropicAMR::writeCheckpointFile");
+    PhaseTimer::Scope phaseTimer("I/O");
 
     CH_assert(m_isDefined);
 
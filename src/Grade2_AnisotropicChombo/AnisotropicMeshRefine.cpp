@@ -380,33 +380,54 @@ AnisotropicMeshRefine::regrid(
             // coarser level.  This modifies the tags variable.  To handle
             // \var{BlockFactor}, coarsen everything before making the new
             // meshes and then refine the resulting mesh boxes.
+            // In parallel clustering mode, the tags are cut into slabs normal to
+            // the longest direction that boxes do not need to span.
+            int slabDir = -1;
+#ifdef CH_MPI
+            if (m_parallelClustering && numProc() > 1) {
+                for (int d = 0; d < SpaceDim; ++d) {
+                    if (m_spanDirs[d] != 0) continue;
+                    if (slabDir < 0 || domaint.size(d) > domaint.size(slabDir)) {
+                        slabDir = d;
+                    }
+                }
+            }
+#endif
+
             Vector<Box> lvlboxes ;  // new boxes on this level
             for ( int lvl = TopLevel ; lvl >= a_baseLevel ; lvl-- ) {
                 // make a new mesh at the same level as the tags
 
-                const int dest_proc = uniqueProc(SerialTask::compute);
-
-                Vector<IntVectSet> all_tags;
-                gather(all_tags, modifiedTags[lvl], dest_proc);
-
-                if (procID() == dest_proc) {
-                    for (unsigned int i = 0; i< all_tags.size(); ++i) {
-                        //                     modifiedTags[lvl] |= all_tags[i];
-                        //**FIXME -- revert to above line when IVS is fixed.
-                        //**The following works around a bug in IVS that appears if
-                        //**the above line is used.  This bug is observed when there
-                        //**is a coarsening of an IVS containing only IntVect::Zero
-                        //**followed by an IVS |= IVS.
-                        for (IVSIterator ivsit(all_tags[i]); ivsit.ok(); ++ivsit) {
-                            modifiedTags[lvl] |= ivsit();
+                Box mySlab;
+                if (slabDir >= 0) {
+                    // Each rank only receives the tags in its own slab.
+                    this->distributeTags(modifiedTags[lvl], mySlab, lvlboxes,
+                                         Domains[lvl], slabDir);
+                } else {
+                    const int dest_proc = uniqueProc(SerialTask::compute);
+
+                    Vector<IntVectSet> all_tags;
+                    gather(all_tags, modifiedTags[lvl], dest_proc);
+
+                    if (procID() == dest_proc) {
+                        for (unsigned int i = 0; i< all_tags.size(); ++i) {
+                            //                     modifiedTags[lvl] |= all_tags[i];
+                            //**FIXME -- revert to above line when IVS is fixed.
+                            //**The following works around a bug in IVS that appears if
+                            //**the above line is used.  This bug is observed when there
+                            //**is a coarsening of an IVS containing only IntVect::Zero
+                            //**followed by an IVS |= IVS.
+                            for (IVSIterator ivsit(all_tags[i]); ivsit.ok(); ++ivsit) {
+                                modifiedTags[lvl] |= ivsit();
+                            }
+                            //**FIXME -- end
+                            // Regain memory used (BVS,NDK 6/30/2008)
+                            all_tags[i].makeEmpty();
                         }
-                        //**FIXME -- end
-                        // Regain memory used (BVS,NDK 6/30/2008)
-                        all_tags[i].makeEmpty();
                     }
-                }
 
-                broadcast( modifiedTags[lvl] , dest_proc);
+                    broadcast( modifiedTags[lvl] , dest_proc);
+                }
 
                 // Move this union _after_ the above gather/broadcast to
                 // reduce memory -- shouldn't have other effects. (BVS,NDK 6/30/2008)
@@ -457,8 +478,25 @@ AnisotropicMeshRefine::regrid(
                 // which will result in satisfying the maxSize restriction when
                 // everything is refined up to the new level
                 const IntVect maxBoxSizeLevel = m_maxSize/(m_level_blockfactors[lvl]*m_nRefVect[lvl]);
-                this->makeBoxes(lvlboxes, modifiedTags[lvl], m_pnds[lvl],
-                                lvldomain, maxBoxSizeLevel, totalBufferSize[lvl]);
+                if (slabDir >= 0) {
+                    // Cluster this rank's slab. Boxes cannot leave the slab, so
+                    // boxes from different ranks are disjoint. Every box still
+                    // passes the same proper nesting test and lives in the
+                    // blocked index space, so the guarantees are unchanged.
+                    if (mySlab.isEmpty()) {
+                        modifiedTags[lvl].makeEmpty();
+                    } else {
+                        modifiedTags[lvl] &= mySlab;
+                    }
+
+                    std::list<Box> localBoxes;
+                    this->makeBoxes(localBoxes, modifiedTags[lvl], m_pnds[lvl],
+                                    lvldomain, maxBoxSizeLevel, 0, totalBufferSize[lvl]);
+                    this->gatherBoxes(lvlboxes, localBoxes);
+                } else {
+                    this->makeBoxes(lvlboxes, modifiedTags[lvl], m_pnds[lvl],
+                                    lvldomain, maxBoxSizeLevel, totalBufferSize[lvl]);
+                }
 
                 // This ensures the m_spanDirs requirements.
                 for (int d = 0; d < SpaceDim; ++d) {
@@ -1078,6 +1116,204 @@ void AnisotropicMeshRefine::makeBoxesParallel (std::list<Box>&      a_mesh,
 } //end of makeBoxesParallel
 
 
+// -----------------------------------------------------------------------------
+// Used by regrid when clustering in parallel. Splits a_domain into one slab per
+// rank along a_dir, each with about the same number of tags, and sends each
+// rank the tags in its slab. a_nestingBoxes are counted but not sent since
+// every rank already has them.
+// -----------------------------------------------------------------------------
+void AnisotropicMeshRefine::distributeTags (IntVectSet&          a_tags,
+                                            Box&                 a_mySlab,
+                                            const Vector<Box>&   a_nestingBoxes,
+                                            const ProblemDomain& a_domain,
+                                            const int            a_dir) const
+{
+#ifdef CH_MPI
+    CH_TIME("AnisotropicMeshRefine::distributeTags");
+
+    const int  nProcs  = numProc();
+    const int  myRank  = procID();
+    const Box& domBox  = a_domain.domainBox();
+    const int  domLo   = domBox.smallEnd(a_dir);
+    const int  len     = domBox.size(a_dir);
+    const int  boxSize = 2 * CH_SPACEDIM;
+
+    // Count the tags in each plane normal to a_dir.
+    std::vector<long long> localHist(len, 0), hist(len, 0);
+    for (IVSIterator ivsit(a_tags); ivsit.ok(); ++ivsit) {
+        ++localHist[ivsit()[a_dir] - domLo];
+    }
+    for (unsigned int i = myRank; i < a_nestingBoxes.size(); i += nProcs) {
+        const Box b = a_nestingBoxes[i] & domBox;
+        if (b.isEmpty()) continue;
+
+        const long long planePts = b.numPts() / b.size(a_dir);
+        for (int idx = b.smallEnd(a_dir); idx <= b.bigEnd(a_dir); ++idx) {
+            localHist[idx - domLo] += planePts;
+        }
+    }
+    MPI_Allreduce(localHist.data(), hist.data(), len, MPI_LONG_LONG, MPI_SUM,
+                  Chombo_MPI::comm);
+
+    long long totalTags = 0;
+    for (int idx = 0; idx < len; ++idx) {
+        totalTags += hist[idx];
+    }
+
+    // Give each rank a contiguous range of planes holding about
+    // totalTags / nProcs tags. Planes are never split, so some ranks may
+    // get nothing.
+    std::vector<int> owner(len);
+    {
+        long long cum = 0;
+        for (int idx = 0; idx < len; ++idx) {
+            long long o = (long long)idx * nProcs / len;
+            if (totalTags > 0) {
+                o = ((2 * cum + hist[idx]) * nProcs) / (2 * totalTags);
+            }
+            owner[idx] = int(Min(o, (long long)(nProcs - 1)));
+            cum += hist[idx];
+        }
+    }
+
+    a_mySlab = Box();
+    for (int idx = 0; idx < len; ++idx) {
+        if (owner[idx] != myRank) continue;
+        if (a_mySlab.isEmpty()) {
+            a_mySlab = domBox;
+            a_mySlab.setRange(a_dir, domLo + idx);
+        }
+        a_mySlab.setBig(a_dir, domLo + idx);
+    }
+
+    // Cut the tags at the slab boundaries and sort the pieces by owner.
+    std::vector<std::vector<int> > sendBoxes(nProcs);
+    Vector<Box> myBoxes;
+    {
+        const Vector<Box> tagBoxes = a_tags.boxes();
+        for (unsigned int i = 0; i < tagBoxes.size(); ++i) {
+            const Box& tb = tagBoxes[i];
+            int lo = tb.smallEnd(a_dir);
+            while (lo <= tb.bigEnd(a_dir)) {
+                const int rank = owner[lo - domLo];
+                int hi = lo;
+                while (hi < tb.bigEnd(a_dir) && owner[hi + 1 - domLo] == rank) ++hi;
+
+                Box piece = tb;
+                piece.setRange(a_dir, lo, hi - lo + 1);
+                if (rank == myRank) {
+                    myBoxes.push_back(piece);
+                } else {
+                    for (int d = 0; d < CH_SPACEDIM; ++d) {
+                        sendBoxes[rank].push_back(piece.smallEnd(d));
+                        sendBoxes[rank].push_back(piece.bigEnd(d));
+                    }
+                }
+                lo = hi + 1;
+            }
+        }
+    }
+
+    // Exchange the pieces.
+    std::vector<int> sendCounts(nProcs), sendDispls(nProcs);
+    std::vector<int> recvCounts(nProcs), recvDispls(nProcs);
+    std::vector<int> sendBuf;
+    for (int rank = 0; rank < nProcs; ++rank) {
+        sendCounts[rank] = sendBoxes[rank].size();
+        sendDispls[rank] = sendBuf.size();
+        sendBuf.insert(sendBuf.end(), sendBoxes[rank].begin(), sendBoxes[rank].end());
+        std::vector<int>().swap(sendBoxes[rank]);
+    }
+    MPI_Alltoall(sendCounts.data(), 1, MPI_INT,
+                 recvCounts.data(), 1, MPI_INT, Chombo_MPI::comm);
+
+    int recvSize = 0;
+    for (int rank = 0; rank < nProcs; ++rank) {
+        recvDispls[rank] = recvSize;
+        recvSize += recvCounts[rank];
+    }
+    std::vector<int> recvBuf(recvSize);
+    MPI_Alltoallv(sendBuf.data(), sendCounts.data(), sendDispls.data(), MPI_INT,
+                  recvBuf.data(), recvCounts.data(), recvDispls.data(), MPI_INT,
+                  Chombo_MPI::comm);
+
+    // Rebuild the tags from the pieces in this rank's slab.
+    a_tags.makeEmpty();
+    for (unsigned int i = 0; i < myBoxes.size(); ++i) {
+        a_tags |= myBoxes[i];
+    }
+    for (int n = 0; n < recvSize; n += boxSize) {
+        IntVect lo, hi;
+        for (int d = 0; d < CH_SPACEDIM; ++d) {
+            lo[d] = recvBuf[n + 2 * d];
+            hi[d] = recvBuf[n + 2 * d + 1];
+        }
+        a_tags |= Box(lo, hi);
+    }
+#else
+    (void)a_nestingBoxes;
+    (void)a_dir;
+    a_mySlab = a_domain.domainBox();
+#endif
+}
+
+
+// -----------------------------------------------------------------------------
+// Used by regrid when clustering in parallel. Collects every rank's boxes on
+// all ranks, in rank order.
+// -----------------------------------------------------------------------------
+void AnisotropicMeshRefine::gatherBoxes (Vector<Box>&          a_boxes,
+                                         const std::list<Box>& a_localBoxes) const
+{
+    a_boxes.resize(0);
+
+#ifdef CH_MPI
+    CH_TIME("AnisotropicMeshRefine::gatherBoxes");
+
+    const int nProcs  = numProc();
+    const int boxSize = 2 * CH_SPACEDIM;
+
+    std::vector<int> sendBuf;
+    sendBuf.reserve(a_localBoxes.size() * boxSize);
+    for (std::list<Box>::const_iterator it = a_localBoxes.begin(); it != a_localBoxes.end(); ++it) {
+        for (int d = 0; d < CH_SPACEDIM; ++d) {
+            sendBuf.push_back(it->smallEnd(d));
+            sendBuf.push_back(it->bigEnd(d));
+        }
+    }
+
+    int sendCount = sendBuf.size();
+    std::vector<int> recvCounts(nProcs), recvDispls(nProcs);
+    MPI_Allgather(&sendCount, 1, MPI_INT,
+                  recvCounts.data(), 1, MPI_INT, Chombo_MPI::comm);
+
+    int recvSize = 0;
+    for (int rank = 0; rank < nProcs; ++rank) {
+        recvDispls[rank] = recvSize;
+        recvSize += recvCounts[rank];
+    }
+    std::vector<int> recvBuf(recvSize);
+    MPI_Allgatherv(sendBuf.data(), sendCount, MPI_INT,
+                   recvBuf.data(), recvCounts.data(), recvDispls.data(), MPI_INT,
+                   Chombo_MPI::comm);
+
+    a_boxes.reserve(recvSize / boxSize);
+    for (int n = 0; n < recvSize; n += boxSize) {
+        IntVect lo, hi;
+        for (int d = 0; d < CH_SPACEDIM; ++d) {
+            lo[d] = recvBuf[n + 2 * d];
+            hi[d] = recvBuf[n + 2 * d + 1];
+        }
+        a_boxes.push_back(Box(lo, hi));
+    }
+#else
+    for (std::list<Box>::const_iterator it = a_localBoxes.begin(); it != a_localBoxes.end(); ++it) {
+        a_boxes.push_back(*it);
+    }
+#endif
+}
+
+
 // -----------------------------------------------------------------------------
 // Simply checks if a_pnd contains points that are properly nested in a_box.
 // -----------------------------------------------------------------------------
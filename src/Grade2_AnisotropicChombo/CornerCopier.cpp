@@ -11,6 +11,7 @@
 #include "DataIterator.H"
 #include "IntVect.H"
 #include "CornerCopier.H"
+#include "CopierCache.H"
 #include "MayDay.H"
 #include "LayoutIterator.H"
 #include "SPMD.H"
@@ -65,6 +66,19 @@ void CornerCopier::clear()
   Copier::clear();
 }
 
+std::shared_ptr<const CornerCopier>
+CornerCopier::cachedExchangeCopier(const DisjointBoxLayout& a_grids,
+                                   const IntVect&           a_ghost)
+{
+  const ProblemDomain&    domain = a_grids.physDomain();
+  const CopierCache::Key  key(a_grids, a_grids, domain, a_ghost, a_ghost,
+                              CopierCache::CornerExchange);
+  return CopierCache::get<CornerCopier>(key, [&](CornerCopier& a_cp)
+  {
+    a_cp.define(a_grids, a_grids, domain, a_ghost, true);
+  });
+}
+
 void
 CornerCopier::define(const DisjointBoxLayout& /*a_level*/,
                      const BoxLayout&         /*a_dest*/,
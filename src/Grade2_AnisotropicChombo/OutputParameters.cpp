@@ -1,6 +1,7 @@
 #include "OutputParameters.H"
 #include "Format.H"
 #include "ParmParse.H"
+#include "SPMD.H"
 #include "Debug.H"
 
 
@@ -56,8 +57,51 @@ OutputParameters::dump() const
     pout() << "plotInterval = " << plotInterval << "\n";
     pout() << "plotPeriod = " << plotPeriod << "\n";
     pout() << "plotPrefix = " << plotPrefix << "\n";
+    pout() << "asyncPlot = " << (asyncPlot ? "true" : "false") << "\n";
+    if (asyncPlot) {
+        pout() << "asyncPlotMaxMB = " << asyncPlotMaxMB << "\n";
+        pout() << "asyncPlotMaxMBps = " << asyncPlotMaxMBps << "\n";
+    }
+    pout() << "nativePlot = " << (nativePlot ? "true" : "false") << "\n";
+    pout() << "plotSinglePrecision = "
+           << (plotSinglePrecision ? "true" : "false") << "\n";
+    pout() << "plotCompression = " << plotCompression << "\n";
+    if (plotCompression > 0) {
+        pout() << "plotShuffle = " << (plotShuffle ? "true" : "false") << "\n";
+    }
+    pout() << "plotDecimalDigits = " << plotDecimalDigits << "\n";
+    pout() << "plotFields =";
+    if (plotFields.empty()) {
+        pout() << " (default)";
+    } else {
+        for (const auto& field : plotFields) pout() << " " << field;
+    }
+    pout() << "\n";
+    pout() << "probeInterval = " << probeInterval << "\n";
+    if (probeInterval > 0) {
+        pout() << "probePrefix = " << probePrefix << "\n";
+        pout() << "probeLevel = " << probeLevel << "\n";
+        pout() << "probeFields =";
+        for (const auto& field : probeFields) pout() << " " << field;
+        pout() << "\n";
+        for (size_t idx = 0; idx < probeSliceDirs.size(); ++idx) {
+            pout() << "probe slice " << idx << ": dir = " << probeSliceDirs[idx]
+                   << ", pos = " << probeSlicePos[idx] << "\n";
+        }
+        for (size_t idx = 0; idx < probeLineDirs.size(); ++idx) {
+            pout() << "probe line " << idx << ": dir = " << probeLineDirs[idx]
+                   << ", pos = " << probeLinePos[idx] << "\n";
+        }
+        for (size_t idx = 0; idx < probePoints.size(); ++idx) {
+            pout() << "probe point " << idx << ": pos = " << probePoints[idx]
+                   << "\n";
+        }
+    }
     pout() << "checkpointInterval = " << checkpointInterval << "\n";
     pout() << "checkpointPrefix = " << checkpointPrefix << "\n";
+    pout() << "nativeCheckpoint = " << (nativeCheckpoint ? "true" : "false") << "\n";
+    pout() << "timingReportFile = "
+           << (timingReportFile.empty() ? "(none)" : timingReportFile) << "\n";
 
     pout() << Format::unindent << std::endl;
 }
@@ -96,6 +140,154 @@ OutputParameters::createDefaults()
             MAYDAYERROR("No plots scheduled. You must set either "
                         "output.plotInterval or output.plotPeriod");
         }
+
+        s_defPtr->asyncPlot        = false;
+        s_defPtr->asyncPlotMaxMB   = -1.0;
+        s_defPtr->asyncPlotMaxMBps = -1.0;
+        pp.query("asyncPlot", s_defPtr->asyncPlot);
+        pp.query("asyncPlotMaxMB", s_defPtr->asyncPlotMaxMB);
+        pp.query("asyncPlotMaxMBps", s_defPtr->asyncPlotMaxMBps);
+#ifndef SOMAR_USE_HDF5
+        if (s_defPtr->asyncPlot) {
+            MAYDAYWARNING("output.asyncPlot requires a build with --HDF5. "
+                          "Plotfiles will be written synchronously.");
+            s_defPtr->asyncPlot = false;
+        }
+#elif defined(CH_MPI)
+        if (s_defPtr->asyncPlot) {
+            // The drain thread makes MPI calls of its own.
+            int threadSupport = MPI_THREAD_SINGLE;
+            MPI_Query_thread(&threadSupport);
+            if (threadSupport < MPI_THREAD_MULTIPLE) {
+                MAYDAYWARNING("output.asyncPlot requires MPI_THREAD_MULTIPLE. "
+                              "Plotfiles will be written synchronously.");
+                s_defPtr->asyncPlot = false;
+            }
+        }
+#endif
+
+#ifdef SOMAR_USE_HDF5
+        s_defPtr->nativePlot = true;
+#else
+        s_defPtr->nativePlot = false;
+#endif
+        pp.query("nativePlot", s_defPtr->nativePlot);
+#ifndef SOMAR_USE_HDF5
+        if (s_defPtr->nativePlot) {
+            MAYDAYWARNING("output.nativePlot requires a build with "
+                          "--HDF5. Falling back to the Python writer.");
+            s_defPtr->nativePlot = false;
+        }
+#endif
+
+        s_defPtr->plotSinglePrecision = false;
+        pp.query("plotSinglePrecision", s_defPtr->plotSinglePrecision);
+        if (s_defPtr->plotSinglePrecision && !s_defPtr->nativePlot &&
+            !s_defPtr->asyncPlot) {
+            MAYDAYWARNING("output.plotSinglePrecision requires "
+                          "output.nativePlot or output.asyncPlot. "
+                          "Plotfiles will be written in double precision.");
+            s_defPtr->plotSinglePrecision = false;
+        }
+
+        s_defPtr->plotCompression   = 0;
+        s_defPtr->plotShuffle       = true;
+        s_defPtr->plotDecimalDigits = -1;
+        pp.query("plotCompression", s_defPtr->plotCompression);
+        pp.query("plotShuffle", s_defPtr->plotShuffle);
+        pp.query("plotDecimalDigits", s_defPtr->plotDecimalDigits);
+        if (s_defPtr->plotCompression < 0 || 9 < s_defPtr->plotCompression) {
+            MAYDAYERROR("output.plotCompression must be in [0, 9].");
+        }
+        if ((s_defPtr->plotCompression > 0 || s_defPtr->plotDecimalDigits >= 0)
+            && !s_defPtr->nativePlot && !s_defPtr->asyncPlot) {
+            MAYDAYWARNING("output.plotCompression and output.plotDecimalDigits "
+                          "require output.nativePlot or output.asyncPlot. "
+                          "Plotfiles will not be compressed.");
+            s_defPtr->plotCompression   = 0;
+            s_defPtr->plotDecimalDigits = -1;
+        }
+
+        s_defPtr->plotFields.clear();
+        const int numFields = pp.countval("plotFields");
+        if (numFields > 0) {
+            Vector<std::string> vstr(numFields);
+            pp.getarr("plotFields", vstr, 0, numFields);
+            s_defPtr->plotFields = vstr;
+        }
+    }
+
+    { // probe block
+        s_defPtr->probeInterval = -1;
+        s_defPtr->probePrefix   = std::string("probe_");
+        s_defPtr->probeLevel    = 0;
+        s_defPtr->probeFields   = {"vel", "b"};
+        s_defPtr->probeSliceDirs.clear();
+        s_defPtr->probeSlicePos.clear();
+        s_defPtr->probeLineDirs.clear();
+        s_defPtr->probeLinePos.clear();
+        s_defPtr->probePoints.clear();
+
+        pp.query("probeInterval", s_defPtr->probeInterval);
+        pp.query("probePrefix", s_defPtr->probePrefix);
+        pp.query("probeLevel", s_defPtr->probeLevel);
+
+        int numVals = pp.countval("probeFields");
+        if (numVals > 0) {
+            s_defPtr->probeFields.resize(numVals);
+            pp.getarr("probeFields", s_defPtr->probeFields, 0, numVals);
+        }
+
+        numVals = pp.countval("probeSliceDirs");
+        if (numVals > 0) {
+            s_defPtr->probeSliceDirs.resize(numVals);
+            s_defPtr->probeSlicePos.resize(numVals);
+            pp.getarr("probeSliceDirs", s_defPtr->probeSliceDirs, 0, numVals);
+            pp.getarr("probeSlicePos", s_defPtr->probeSlicePos, 0, numVals);
+        }
+
+        numVals = pp.countval("probeLineDirs");
+        if (numVals > 0) {
+            std::vector<Real> vreal(numVals * SpaceDim);
+            s_defPtr->probeLineDirs.resize(numVals);
+            pp.getarr("probeLineDirs", s_defPtr->probeLineDirs, 0, numVals);
+            pp.getarr("probeLinePos", vreal, 0, numVals * SpaceDim);
+            for (int idx = 0; idx < numVals; ++idx) {
+                s_defPtr->probeLinePos.emplace_back(
+                    D_DECL(vreal[SpaceDim * idx],
+                           vreal[SpaceDim * idx + 1],
+                           vreal[SpaceDim * idx + 2]));
+            }
+        }
+
+        numVals = pp.countval("probePoints");
+        if (numVals > 0) {
+            if (numVals % SpaceDim != 0) {
+                MAYDAYERROR("output.probePoints needs SpaceDim values per "
+                            "point.");
+            }
+            std::vector<Real> vreal(numVals);
+            pp.getarr("probePoints", vreal, 0, numVals);
+            for (int idx = 0; idx < numVals / SpaceDim; ++idx) {
+                s_defPtr->probePoints.emplace_back(
+                    D_DECL(vreal[SpaceDim * idx],
+                           vreal[SpaceDim * idx + 1],
+                           vreal[SpaceDim * idx + 2]));
+            }
+        }
+
+        for (const int dir : s_defPtr->probeSliceDirs) {
+            CH_verify(0 <= dir && dir < SpaceDim);
+        }
+        for (const int dir : s_defPtr->probeLineDirs) {
+            CH_verify(0 <= dir && dir < SpaceDim);
+        }
+        if (s_defPtr->probeInterval > 0 && s_defPtr->probeSliceDirs.empty() &&
+            s_defPtr->probeLineDirs.empty() && s_defPtr->probePoints.empty()) {
+            MAYDAYWARNING("output.probeInterval is set, but no slices, lines "
+                          "or points were requested.");
+            s_defPtr->probeInterval = -1;
+        }
     }
 
     { // checkpoint block
@@ -111,8 +303,25 @@ OutputParameters::createDefaults()
         } else {
             MAYDAYWARNING("No checkpoints scheduled");
         }
+
+#ifdef SOMAR_USE_HDF5
+        s_defPtr->nativeCheckpoint = true;
+#else
+        s_defPtr->nativeCheckpoint = false;
+#endif
+        pp.query("nativeCheckpoint", s_defPtr->nativeCheckpoint);
+#ifndef SOMAR_USE_HDF5
+        if (s_defPtr->nativeCheckpoint) {
+            MAYDAYWARNING("output.nativeCheckpoint requires a build with "
+                          "--HDF5. Falling back to the Python writer.");
+            s_defPtr->nativeCheckpoint = false;
+        }
+#endif
     }
 
+    s_defPtr->timingReportFile = std::string("");
+    pp.query("timingReportFile", s_defPtr->timingReportFile);
+
     pout() << endl;
 
     // Send defaults to pout.
@@ -60,6 +60,11 @@ TimeParameters::dump() const
     pout() << "dtMult = " << dtMult << '\n';
     pout() << "maxDtGrow = " << maxDtGrow << '\n';
 
+    pout() << "integrator = " << integrator << '\n';
+    if (integrator == "PARK") {
+        pout() << "tableau = " << tableau << '\n';
+    }
+
     pout() << "useElementaryController = " << (useElementaryController ? "true" : "false") << '\n';
     pout() << "usePIController = " << (usePIController ? "true" : "false") << '\n';
     pout() << "usePIDController = " << (usePIDController ? "true" : "false") << '\n';
@@ -113,6 +118,13 @@ TimeParameters::createDefaults()
     pp.query("maxDtGrow", s_defPtr->maxDtGrow);
     if (s_defPtr->maxDtGrow <= 0.0) s_defPtr->maxDtGrow = 1.0e8;
 
+    // The time integrator. TimeIntegrator::create will validate these.
+    s_defPtr->integrator = "PARK";
+    pp.query("integrator", s_defPtr->integrator);
+
+    s_defPtr->tableau = "ARK3_2_4L_2_SA";
+    pp.query("tableau", s_defPtr->tableau);
+
 
     s_defPtr->useElementaryController = false;
     pp.query("useElementaryController", s_defPtr->useElementaryController);
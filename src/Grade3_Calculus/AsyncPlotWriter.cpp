@@ -0,0 +1,230 @@
+/*******************************************************************************
+ *  SOMAR - Stratified Ocean Model with Adaptive Refinement
+ *  Developed by Ed Santilli & Alberto Scotti
+ *  Copyright (C) 2024 Thomas Jefferson University and Arizona State University
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ *
+ *  For up-to-date contact information, please visit the repository homepage,
+ *  https://github.com/MUON-CFD/SOMAR.
+ ******************************************************************************/
+#include "AsyncPlotWriter.H"
+
+#ifdef SOMAR_USE_HDF5
+#include <chrono>
+#include <cstdio>
+#include <sstream>
+#include "HDF5Checkpoint.H"
+#include "PhaseTimer.H"
+#include "SPMD.H"
+#include "MayDay.H"
+#include "Debug.H"
+
+
+// -----------------------------------------------------------------------------
+void
+AsyncPlotWriter::Snapshot::addField(std::unique_ptr<LevelData<FArrayBox>> a_dataPtr,
+                                    const std::string&                    a_groupName,
+                                    const std::string&                    a_name,
+                                    const IntVect&                        a_ghost)
+{
+    CH_assert(a_dataPtr);
+    const DisjointBoxLayout& grids = a_dataPtr->getBoxes();
+
+    // Same boxes, same ranks, same order. Only the reference counts are new.
+    const DisjointBoxLayout privGrids(
+        grids.boxArray(), grids.procIDs(), grids.physDomain());
+
+    LayoutData<Real*> aliasPtrs(privGrids);
+    {
+        DataIterator dit     = grids.dataIterator();
+        DataIterator privDit = privGrids.dataIterator();
+        for (; dit.ok(); ++dit, ++privDit) {
+            CH_assert(privDit.ok());
+            CH_assert(privGrids[privDit] == grids[dit]);
+            aliasPtrs[privDit] = (*a_dataPtr)[dit].dataPtr();
+        }
+    }
+
+    auto privDataPtr = std::make_unique<LevelData<FArrayBox>>(
+        privGrids,
+        a_dataPtr->nComp(),
+        a_dataPtr->ghostVect(),
+        FABAliasDataFactory(aliasPtrs));
+
+    fields.push_back({a_groupName,
+                      a_name,
+                      std::move(a_dataPtr),
+                      std::move(privDataPtr),
+                      a_ghost});
+}
+
+
+// -----------------------------------------------------------------------------
+size_t
+AsyncPlotWriter::Snapshot::bytes() const
+{
+    size_t total = 0;
+    for (const Field& f : fields) {
+        for (DataIterator dit(f.dataPtr->getBoxes()); dit.ok(); ++dit) {
+            const FArrayBox& fab = (*f.dataPtr)[dit];
+            total += fab.box().numPts() * fab.nComp() * sizeof(Real);
+        }
+    }
+    return total;
+}
+
+
+// -----------------------------------------------------------------------------
+AsyncPlotWriter::AsyncPlotWriter(const Real a_maxMB, const Real a_maxMBps)
+: m_maxBytes(a_maxMB * 1024.0 * 1024.0)
+, m_maxBytesPerSec(a_maxMBps * 1024.0 * 1024.0)
+{
+#ifdef CH_MPI
+    MPI_Comm_dup(Chombo_MPI::comm, &m_comm);
+#endif
+}
+
+
+// -----------------------------------------------------------------------------
+AsyncPlotWriter::~AsyncPlotWriter()
+{
+    this->wait();
+#ifdef CH_MPI
+    MPI_Comm_free(&m_comm);
+#endif
+}
+
+
+// -----------------------------------------------------------------------------
+void
+AsyncPlotWriter::submit(std::unique_ptr<Snapshot> a_snapPtr)
+{
+    CH_assert(a_snapPtr);
+
+    // The writes are collective, so all ranks must agree on the path.
+    Real snapBytes = static_cast<Real>(a_snapPtr->bytes());
+#ifdef CH_MPI
+    {
+        Real maxBytes = snapBytes;
+        MPI_Allreduce(
+            &snapBytes, &maxBytes, 1, MPI_CH_REAL, MPI_MAX, Chombo_MPI::comm);
+        snapBytes = maxBytes;
+    }
+#endif
+
+    // Only one snapshot in flight.
+    this->wait();
+    m_inFlightPtr = std::move(a_snapPtr);
+
+    if (m_maxBytes > 0.0 && snapBytes > m_maxBytes) {
+        pout() << "Plotfile snapshot (" << snapBytes / (1024.0 * 1024.0)
+               << " MB) exceeds output.asyncPlotMaxMB. Writing synchronously."
+               << endl;
+        this->drain(0.0);
+        this->wait();
+        return;
+    }
+
+    m_thread = std::thread(&AsyncPlotWriter::drain, this, m_maxBytesPerSec);
+}
+
+
+// -----------------------------------------------------------------------------
+void
+AsyncPlotWriter::wait()
+{
+    if (m_thread.joinable()) {
+        PhaseTimer::Scope phaseTimer("I/O wait");
+        m_thread.join();
+    }
+    m_inFlightPtr.reset();
+
+    if (!m_drainReport.empty()) {
+        pout() << m_drainReport << flush;
+        m_drainReport.clear();
+    }
+
+    if (!m_drainError.empty()) {
+        const std::string drainError = m_drainError;
+        m_drainError.clear();
+        MAYDAYWARNING(drainError);
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+AsyncPlotWriter::drain(const Real a_maxBytesPerSec)
+{
+    // Apart from fatal errors, nothing in here may use pout() or PhaseTimer.
+    // Neither is thread-safe.
+    using Clock = std::chrono::steady_clock;
+
+    const Snapshot&   snap    = *m_inFlightPtr;
+    const std::string tmpName = snap.fileName + ".tmp";
+    const auto        start   = Clock::now();
+    double            written = 0.0;
+
+    {
+#ifdef CH_MPI
+        HDF5PlotWriter writer(tmpName, m_comm);
+#else
+        HDF5PlotWriter writer(tmpName);
+#endif
+        writer.setSinglePrecision(snap.singlePrecision);
+        writer.setCompression(snap.compression);
+        for (const auto& h : snap.headers) {
+            writer.writeHeader(h.second, h.first);
+        }
+
+        for (const Snapshot::Field& f : snap.fields) {
+            writer.write(*f.dataPtr, f.groupName, f.name, f.ghost);
+
+            if (a_maxBytesPerSec > 0.0) {
+                for (DataIterator dit(f.dataPtr->getBoxes()); dit.ok(); ++dit) {
+                    const FArrayBox& fab = (*f.dataPtr)[dit];
+                    written += fab.box().numPts() * fab.nComp() * sizeof(Real);
+                }
+                const std::chrono::duration<double> due(written / a_maxBytesPerSec);
+                std::this_thread::sleep_until(
+                    start + std::chrono::duration_cast<Clock::duration>(due));
+            }
+        }
+
+        if (snap.singlePrecision || snap.compression.isEnabled()) {
+            std::ostringstream report;
+            writer.report(report, snap.compNames);
+            m_drainReport = report.str();
+        }
+    }  // Closes the file.
+
+    // Everyone must be done before the file appears under its final name.
+    int rank = 0;
+#ifdef CH_MPI
+    MPI_Barrier(m_comm);
+    MPI_Comm_rank(m_comm, &rank);
+#endif
+    if (rank == 0) {
+        if (std::rename(tmpName.c_str(), snap.fileName.c_str()) != 0) {
+            m_drainError = "Could not rename " + tmpName + " to "
+                         + snap.fileName + ".";
+        }
+    }
+}
+
+
+#endif  // SOMAR_USE_HDF5
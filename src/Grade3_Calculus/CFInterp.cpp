@@ -1,12 +1,14 @@
 #include "CFInterp.H"
 #include "CFInterpF_F.H"
 #include "BoxIterator.H"
+#include "CopierCache.H"
 #include "LayoutTools.H"
 #include "SOMAR_Constants.H"
 #include "AnisotropicRefinementTools.H"
 #include "Convert.H"
 #include "BCTools.H"
 #include "Debug.H"
+#include "PhaseTimer.H"
 
 #include "AnisotropicLinearCFInterp.H" // TEMPORARY!!!
 #include "MappedQuadCFInterp.H"        // TEMPORARY!!!
@@ -391,6 +393,8 @@ CFInterp::interpAtCFI(LevelData<FArrayBox>&       a_fine,
     // Is there anything to do?
     if (!this->hasCFI()) return;
 
+    PhaseTimer::Scope phaseTimer("CF interp");
+
     CH_assert(m_isDefined);
     CH_assert(a_fine.getBoxes() == m_grids);
 
@@ -434,6 +438,8 @@ CFInterp::homogInterpAtCFI(LevelData<FArrayBox>& a_fine,
     // Is there anything to do?
     if (a_cfiIter.isEmpty()) return;
 
+    PhaseTimer::Scope phaseTimer("CF interp");
+
     for (a_cfiIter.reset(); a_cfiIter.ok(); ++a_cfiIter) {
         const DataIndex& di      = a_cfiIter->di;
         const int        isign   = a_cfiIter->isign;
@@ -538,6 +544,39 @@ CFInterp::refine(LevelData<FArrayBox>&       a_fine,
 }
 
 
+// -----------------------------------------------------------------------------
+void
+CFInterp::refine(LevelData<FArrayBox>&          a_fine,
+                 const LevelData<FArrayBox>&    a_crse,
+                 const LayoutData<Vector<Box>>& a_crseInterpBoxes,
+                 const int                      a_interpOrder,
+                 const bool                     a_doSlopeLimiter) const
+{
+    // Sanity checks
+    CH_assert(m_isDefined);
+    CH_assert(a_fine.getBoxes() == m_grids);
+    CH_assert(a_crse.getBoxes() == m_userCrseGrids);
+    CH_assert(a_fine.nComp() == a_crse.nComp());
+
+    // Localize the coarse data.
+    LevelData<FArrayBox> localCrse(m_crseGrids, a_crse.nComp(), IntVect::Unit);
+    this->localizeCrseData(localCrse, a_crse);
+
+    // Refine only the requested regions.
+    DataIterator dit = a_fine.dataIterator();
+    for (dit.reset(); dit.ok(); ++dit) {
+        for (const Box& crseInterpBox : a_crseInterpBoxes[dit]) {
+            CH_assert(m_crseGrids[dit].contains(crseInterpBox));
+            this->localRefine(a_fine[dit],
+                              localCrse[dit],
+                              crseInterpBox,
+                              a_interpOrder,
+                              a_doSlopeLimiter);
+        }
+    }
+}
+
+
 // -----------------------------------------------------------------------------
 void
 CFInterp::localRefine(LevelData<FArrayBox>&       a_fine,
@@ -1333,7 +1372,7 @@ CFInterp::interpGhostsAtCFI(LevelData<FluxBox>&       a_fineAdvVel,
             }
         }
 
-        fineInterp.exchange(); // TODO: Is this needed? If so, use a copier.
+        LayoutTools::exchange(fineInterp); // TODO: Is this needed? If so, use a copier.
     }
 
     // Interp to parent interiors.
@@ -1359,7 +1398,7 @@ CFInterp::interpGhostsAtCFI(LevelData<FluxBox>&       a_fineAdvVel,
         // }
     }
 
-    fineInterp.exchange();
+    LayoutTools::exchange(fineInterp);
     debugCheckValidFaceOverlap(fineInterp);
 
     // Copy ghost faces to user's fine holder.
@@ -1372,7 +1411,7 @@ CFInterp::interpGhostsAtCFI(LevelData<FluxBox>&       a_fineAdvVel,
             a_fineAdvVel[dit][fcDir].copy(fineInterp[dit][fcDir]);
         }
     } // dit
-    a_fineAdvVel.exchange();
+    LayoutTools::exchange(a_fineAdvVel);
 
     debugCheckValidFaceOverlap(a_fineAdvVel);
 }
@@ -1491,6 +1530,39 @@ CFInterp::refine(LevelData<FluxBox>&       a_fineAdvVel,
 }
 
 
+// -----------------------------------------------------------------------------
+void
+CFInterp::refine(LevelData<FluxBox>&            a_fineAdvVel,
+                 const LevelData<FluxBox>&      a_crseAdvVel,
+                 const LayoutData<Vector<Box>>& a_crseInterpBoxes) const
+{
+    CH_assert(m_isDefined);
+    CH_assert(a_fineAdvVel.getBoxes() == m_grids);
+    CH_assert(a_crseAdvVel.getBoxes() == m_userCrseGrids);
+    CH_assert(a_crseAdvVel.nComp() == a_fineAdvVel.nComp());
+
+    // Send crse data to compatible grids and fill ghosts.
+    LevelData<FluxBox> localCrse;
+    {
+        const IntVect ghostVect = IntVect::Unit;
+        localCrse.define(m_crseGrids, a_crseAdvVel.nComp(), ghostVect);
+        debugCheckValidFaceOverlap(a_crseAdvVel);
+        this->localizeCrseData(localCrse, a_crseAdvVel);
+    }
+
+    // Refine only the requested regions.
+    DataIterator dit = m_grids.dataIterator();
+    for (dit.reset(); dit.ok(); ++dit) {
+        for (const Box& ccCrseInterpBox : a_crseInterpBoxes[dit]) {
+            CH_assert(m_crseGrids[dit].contains(ccCrseInterpBox));
+            this->localRefine(a_fineAdvVel[dit],
+                              localCrse[dit],
+                              ccCrseInterpBox);
+        }
+    }
+}
+
+
 // -----------------------------------------------------------------------------
 void
 CFInterp::localRefine(LevelData<FluxBox>&       a_fineAdvVel,
@@ -1963,9 +2035,9 @@ CFInterp::validateAtCoarseCFI(LevelData<FluxBox>&      a_crse,
         // The interior cells will contain this patch's face values.
         // The exterior cells will contain the neighbor's face values.
         {
-            Copier cp;
-            cp.exchangeDefine(grids, exData.ghostVect());
-            exData.exchange(cp);
+            const auto cpPtr =
+                CopierCache::exchangeDefineCopier(grids, exData.ghostVect());
+            LayoutTools::exchange(exData, *cpPtr);
         }
 
         // 3. Create a mask.
@@ -2042,23 +2114,21 @@ CFInterp::localizeCrseData(LevelData<FArrayBox>&       a_localCrseData,
         // TODO: It would be better to copy all ghosts wherever the data is
         // available rather than extrapolate it.
 
-        // Should we cache this?
-        Copier copier;
-        LayoutTools::defineImpartialCopier(copier,
-                                           srcLayout,
-                                           destLayout,
-                                           domain,
-                                           IntVect::Unit,  // srcGhostVect
-                                           IntVect::Unit); // destGhostVect
+        const auto copierPtr =
+            LayoutTools::cachedImpartialCopier(srcLayout,
+                                               destLayout,
+                                               domain,
+                                               IntVect::Unit,  // srcGhostVect
+                                               IntVect::Unit); // destGhostVect
 
         debugInitLevel(dest);
-        src.copyTo(dest, copier);
+        src.copyTo(dest, *copierPtr);
     }
 
     // Fill all ghosts beyond the first layer.
     BCTools::extrapAllGhosts(dest, 2, IntVect::Unit);
-    dest.exchange(m_crseExCopier);
-    dest.exchange(m_crseExCornerCopier);
+    LayoutTools::exchange(dest, m_crseExCopier);
+    LayoutTools::exchange(dest, m_crseExCornerCopier);
 }
 
 
@@ -2083,13 +2153,12 @@ CFInterp::localizeCrseData(LevelData<FluxBox>&       a_localCrseData,
     const ProblemDomain& domain = srcGrids.physDomain();
 
     // Copy valid data.
-    // Copier creation is not a bottleneck, so don't bother creating a cache.
     {
         CH_assert(src.ghostVect() >= IntVect::Unit);
         CH_assert(dest.ghostVect() >= IntVect::Unit);
 
         std::array<StaggeredCopier, CH_SPACEDIM> copier;
-        LayoutTools::defineImpartialCopier(copier,
+        LayoutTools::cachedImpartialCopier(copier,
                                            srcLayout,
                                            destLayout,
                                            domain,
@@ -2133,7 +2202,7 @@ CFInterp::localizeCrseData(LevelData<FluxBox>&       a_localCrseData,
 
     // Fill all ghosts beyond the first layer.
     BCTools::extrapAllGhosts(dest, 2, IntVect::Unit);
-    dest.exchange();  // Does corners too!
+    LayoutTools::exchange(dest);  // Does corners too!
 
     debugCheckValidFaceOverlap(dest);
 }
@@ -2339,7 +2408,7 @@ CFInterp::localDivFreeInterp(LevelData<FluxBox>&       a_fine,
             }
         }
 
-        a_fine.exchange(); // TODO: Is this needed? If so, use a copier.
+        LayoutTools::exchange(a_fine); // TODO: Is this needed? If so, use a copier.
     }
 
     // Interp to parent interiors.
@@ -1,5 +1,7 @@
 #include "DiffusiveOp.H"
+#include "LayoutTools.H"
 #include "DiffusiveOpF_F.H"
+#include "VertLineRelaxF_F.H"
 #include "FABAlgebra.H"
 #include "AnisotropicRefinementTools.H"
 
@@ -17,6 +19,21 @@
 namespace Elliptic {
 
 
+// -----------------------------------------------------------------------------
+// Clones made by newMGOperator share our cached matrix elements. Before we
+// overwrite a holder, give this op a fresh one so the clones keep a
+// consistent operator. The contents are not copied.
+template <class T>
+static void
+unshareMatrixElements(std::shared_ptr<LevelData<T>>& a_ptr)
+{
+    if (a_ptr && a_ptr.use_count() > 1) {
+        a_ptr.reset(new LevelData<T>(
+            a_ptr->getBoxes(), a_ptr->nComp(), a_ptr->ghostVect()));
+    }
+}
+
+
 // -----------------------------------------------------------------------------
 DiffusiveOp::DiffusiveOp(
     const LevelGeometry&                        a_levGeo,
@@ -27,18 +44,23 @@ DiffusiveOp::DiffusiveOp(
     const LevelData<FArrayBox>&                 a_eddyNu,
     const std::vector<Real>&                    a_vEddyPrandtl,
     const std::shared_ptr<BCTools::BCFunction>& a_bcFuncPtr,
-    const int                                   a_numComps)
+    const int                                   a_numComps,
+    const bool                                  a_useVertLineRelax)
 : m_alpha(a_alpha)
 , m_beta(a_beta)
 , m_domain(a_levGeo.getDomain())
 , m_grids(a_levGeo.getBoxes())
 , m_dXi(a_levGeo.getDXi())
 , m_geoSrc(a_levGeo.getGeoSource())
+, m_levGeoPtr(&a_levGeo)
+, m_useVertLineRelax(a_useVertLineRelax)
 , m_crseAMRGridsPtr(a_crseGridsPtr)
 , m_amrCrseDXi(D_DECL(quietNAN, quietNAN, quietNAN))
 , m_Jptr(new LevelData<FArrayBox>)
+, m_unscaledJgupPtr(new LevelData<FluxBox>(a_levGeo.getBoxes(), a_numComps))
 , m_JgupPtr(new LevelData<FluxBox>(a_levGeo.getBoxes(), a_numComps))
 , m_invDiagsPtr(new LevelData<FArrayBox>(a_levGeo.getBoxes(), a_numComps))
+, m_vertLineFactorsPtr()
 , m_bcFuncPtr(a_bcFuncPtr)
 , m_physBdryIter(a_levGeo.getBoxes())
 , m_cfiIter(a_levGeo.getBoxes(), a_levGeo.getCFRegion())
@@ -71,14 +93,70 @@ DiffusiveOp::DiffusiveOp(
                    const_cast<LevelData<FArrayBox>*>(&a_levGeo.getCCJ()),
                    Interval(0, 0));
 
-    // Jgup <- beta * (kappa + eddyNu / eddyPrandtl) * Jgup
+    // Vertical line relaxation needs each box to span the vertical domain.
+    if (m_useVertLineRelax && !this->gridsAreSuitableForVertLines()) {
+        MAYDAYWARNING(
+            "DiffusiveOp: Grids are not suitable for vertical line relaxation. "
+            "Using GSRB instead. Try setting base.splitDirs = 1 1 0 in 3D or "
+            "1 0 in 2D.");
+        m_useVertLineRelax = false;
+    }
+
+    // Jgup, invDiags, etc.
+    this->setCoefficients(a_alpha,
+                          a_beta,
+                          a_vKappa,
+                          a_eddyNu,
+                          a_vEddyPrandtl,
+                          a_bcFuncPtr);
+}
+
+
+// -----------------------------------------------------------------------------
+void
+DiffusiveOp::setAlphaAndBeta(const Real a_alpha, const Real a_beta)
+{
+    m_alpha = a_alpha;
+    m_beta  = a_beta;
+
+    // beta is baked into Jgup, so rebuild it from the unscaled Jgup. This
+    // does not accumulate rounding error over repeated calls.
+    this->applyBetaToJgup();
+    this->cacheMatrixElements();
+}
+
+
+// -----------------------------------------------------------------------------
+void
+DiffusiveOp::setCoefficients(
+    const Real                                  a_alpha,
+    const Real                                  a_beta,
+    const std::vector<Real>&                    a_vKappa,
+    const LevelData<FArrayBox>&                 a_eddyNu,
+    const std::vector<Real>&                    a_vEddyPrandtl,
+    const std::shared_ptr<BCTools::BCFunction>& a_bcFuncPtr)
+{
+    CH_assert(m_levGeoPtr);
+    CH_assert(a_eddyNu.getBoxes().compatible(m_grids));
+    CH_assert(a_bcFuncPtr);
+
+    const int numComps = this->numComps();
+    CH_assert(static_cast<int>(a_vKappa.size()) >= numComps);
+    CH_assert(static_cast<int>(a_vEddyPrandtl.size()) >= numComps);
+
+    m_alpha     = a_alpha;
+    m_beta      = a_beta;
+    m_bcFuncPtr = a_bcFuncPtr;
+
+    // unscaledJgup <- (kappa + eddyNu / eddyPrandtl) * Jgup
+    unshareMatrixElements(m_unscaledJgupPtr);
     for (DataIterator dit(m_grids); dit.ok(); ++dit) {
         for (int fcDir = 0; fcDir < SpaceDim; ++fcDir) {
-            FArrayBox&       destFAB   = (*m_JgupPtr)[dit][fcDir];
-            const FArrayBox& JgupFAB   = a_levGeo.getFCJgup()[dit][fcDir];
+            FArrayBox&       destFAB   = (*m_unscaledJgupPtr)[dit][fcDir];
+            const FArrayBox& JgupFAB   = m_levGeoPtr->getFCJgup()[dit][fcDir];
             const FArrayBox& eddyNuFAB = a_eddyNu[dit];
 
-            for (int comp = 0; comp < a_numComps; ++comp) {
+            for (int comp = 0; comp < numComps; ++comp) {
                 destFAB.copy(JgupFAB, 0, comp, 1);
 
                 if (RealCmp::isZero(a_vEddyPrandtl[comp])) {
@@ -87,7 +165,7 @@ DiffusiveOp::DiffusiveOp(
                                          destFAB.box(),
                                          eddyNuFAB,
                                          0,
-                                         a_beta * a_vKappa[comp],
+                                         a_vKappa[comp],
                                          0.0);  // set eddy diffusivity to zero
                 } else {
                     FABAlgebra::FCmultCC(destFAB,
@@ -95,68 +173,30 @@ DiffusiveOp::DiffusiveOp(
                                          destFAB.box(),
                                          eddyNuFAB,
                                          0,
-                                         a_beta * a_vKappa[comp],
-                                         a_beta / a_vEddyPrandtl[comp]);
+                                         a_vKappa[comp],
+                                         1.0 / a_vEddyPrandtl[comp]);
                 }
             } // comp
         } // fcDir
     } // dit
 
-    // invDiags
-    for (DataIterator dit(m_grids); dit.ok(); ++dit) {
-        FArrayBox&       invDiagsFAB = (*m_invDiagsPtr)[dit];
-        const Box&       destBox     = invDiagsFAB.box();
-        const FArrayBox& JgxxFAB     = (*m_JgupPtr)[dit][0];
-        const FArrayBox& JgyyFAB     = (*m_JgupPtr)[dit][1];
-        const FArrayBox& JgzzFAB     = (*m_JgupPtr)[dit][SpaceDim - 1];  // Not used in 2D
-        const FArrayBox& JFAB        = (*m_Jptr)[dit];
-
-        debugInit(invDiagsFAB);
-        FORT_DIFFUSIVEOP_COMPUTEDIAGS(
-            CHF_FRA(invDiagsFAB),
-            CHF_CONST_FRA(JgxxFAB),
-            CHF_CONST_FRA(JgyyFAB),
-            CHF_CONST_FRA(JgzzFAB),
-            CHF_CONST_FRA1(JFAB, 0),
-            CHF_CONST_REALVECT(m_dXi),
-            CHF_BOX(destBox),
-            CHF_CONST_REAL(m_alpha));
-
-        invDiagsFAB.invert(1.0);
-    }
-    nanCheck(*m_invDiagsPtr);
+    // Jgup <- beta * unscaledJgup
+    this->applyBetaToJgup();
+    this->cacheMatrixElements();
 }
 
 
 // -----------------------------------------------------------------------------
 void
-DiffusiveOp::setAlphaAndBeta(const Real a_alpha, const Real a_beta)
+DiffusiveOp::setBCFunction(
+    const std::shared_ptr<BCTools::BCFunction>& a_bcFuncPtr)
 {
-    m_alpha = a_alpha;
-    m_beta  = a_beta;
-
-    for (DataIterator dit(m_grids); dit.ok(); ++dit) {
-        FArrayBox&       invDiagsFAB = (*m_invDiagsPtr)[dit];
-        const Box&       destBox     = invDiagsFAB.box();
-        const FArrayBox& JgxxFAB     = (*m_JgupPtr)[dit][0];
-        const FArrayBox& JgyyFAB     = (*m_JgupPtr)[dit][1];
-        const FArrayBox& JgzzFAB     = (*m_JgupPtr)[dit][SpaceDim - 1];  // Not used in 2D
-        const FArrayBox& JFAB        = (*m_Jptr)[dit];
-
-        debugInit(invDiagsFAB);
-        FORT_DIFFUSIVEOP_COMPUTEDIAGS(
-            CHF_FRA(invDiagsFAB),
-            CHF_CONST_FRA(JgxxFAB),
-            CHF_CONST_FRA(JgyyFAB),
-            CHF_CONST_FRA(JgzzFAB),
-            CHF_CONST_FRA1(JFAB, 0),
-            CHF_CONST_REALVECT(m_dXi),
-            CHF_BOX(destBox),
-            CHF_CONST_REAL(m_alpha));
+    CH_assert(a_bcFuncPtr);
+    m_bcFuncPtr = a_bcFuncPtr;
 
-        invDiagsFAB.invert(1.0);
+    if (m_useVertLineRelax) {
+        this->cacheMatrixElements();
     }
-    nanCheck(*m_invDiagsPtr);
 }
 
 
@@ -174,7 +214,7 @@ DiffusiveOp::applyBCs(StateType&       a_phi,
     CH_assert(a_phi.ghostVect() == IntVect::Unit);
 
     // Begin exchange
-    a_phi.exchangeBegin(m_exCopier);
+    LayoutTools::exchangeBegin(a_phi, m_exCopier);
 
     // CFI BCs
     if (!m_cfiIter.isEmpty()) {
@@ -200,7 +240,7 @@ DiffusiveOp::applyBCs(StateType&       a_phi,
                      m_physBdryIter);
 
     // Finish exchange
-    a_phi.exchangeEnd();  // Bottleneck!
+    LayoutTools::exchangeEnd(a_phi);  // Bottleneck!
 
     nanCheck(a_phi);
 }
@@ -273,8 +313,12 @@ DiffusiveOp::relax(StateType&       a_cor,
                    const Real       a_time,
                    const int        a_relaxIters) const
 {
-    // this->jacobi_relax(a_cor, a_res, a_time, a_relaxIters);
-    this->gsrb_relax(a_cor, a_res, a_time, a_relaxIters);
+    if (m_useVertLineRelax) {
+        this->vertLineGSRB_relax(a_cor, a_res, a_time, a_relaxIters);
+    } else {
+        // this->jacobi_relax(a_cor, a_res, a_time, a_relaxIters);
+        this->gsrb_relax(a_cor, a_res, a_time, a_relaxIters);
+    }
 }
 
 
@@ -427,7 +471,7 @@ DiffusiveOp::MGProlong(StateType&      a_finePhi,
                         a_crseCor.getBoxes().physDomain(),
                         a_crseCor.ghostVect(),
                         true);
-        a_crseCor.exchange(ccp);
+        LayoutTools::exchange(a_crseCor, ccp);
 
         // Update with mixed second derivative terms.
         for (dit.reset(); dit.ok(); ++dit) {
@@ -463,11 +507,15 @@ DiffusiveOp::DiffusiveOp(const DiffusiveOp& a_srcOp)
 , m_grids(a_srcOp.m_grids)
 , m_dXi(a_srcOp.m_dXi)
 , m_geoSrc(a_srcOp.m_geoSrc)
+, m_levGeoPtr(a_srcOp.m_levGeoPtr)
+, m_useVertLineRelax(a_srcOp.m_useVertLineRelax)
 , m_crseAMRGridsPtr(a_srcOp.m_crseAMRGridsPtr)
 , m_amrCrseDXi(a_srcOp.m_amrCrseDXi)
 , m_Jptr(a_srcOp.m_Jptr)
+, m_unscaledJgupPtr(a_srcOp.m_unscaledJgupPtr)
 , m_JgupPtr(a_srcOp.m_JgupPtr)
 , m_invDiagsPtr(a_srcOp.m_invDiagsPtr)
+, m_vertLineFactorsPtr(a_srcOp.m_vertLineFactorsPtr)
 , m_bcFuncPtr(a_srcOp.m_bcFuncPtr)
 , m_physBdryIter(a_srcOp.m_physBdryIter)
 , m_cfiIter(a_srcOp.m_cfiIter)
@@ -488,11 +536,15 @@ DiffusiveOp::DiffusiveOp(const DiffusiveOp&       a_srcOp,
 , m_grids(a_crseGrids)
 , m_dXi(a_srcOp.m_dXi * a_refRatio)
 , m_geoSrc(a_srcOp.m_geoSrc)
+, m_levGeoPtr(nullptr)
+, m_useVertLineRelax(a_srcOp.m_useVertLineRelax)
 , m_crseAMRGridsPtr(a_srcOp.m_crseAMRGridsPtr)
 , m_amrCrseDXi(a_srcOp.m_amrCrseDXi)
 , m_Jptr(new LevelData<FArrayBox>(a_crseGrids, 1))
+, m_unscaledJgupPtr(new LevelData<FluxBox>(a_crseGrids, a_srcOp.numComps()))
 , m_JgupPtr(new LevelData<FluxBox>(a_crseGrids, a_srcOp.numComps()))
 , m_invDiagsPtr(new LevelData<FArrayBox>(a_crseGrids, a_srcOp.numComps()))
+, m_vertLineFactorsPtr()
 , m_bcFuncPtr(a_srcOp.m_bcFuncPtr)
 , m_physBdryIter(a_crseGrids)
 , m_cfiIter(a_crseGrids, CFRegion(a_crseGrids, a_crseGrids.physDomain()))
@@ -519,39 +571,19 @@ DiffusiveOp::DiffusiveOp(const DiffusiveOp&       a_srcOp,
                 destFAB, srcFAB, destFAB.box(), a_refRatio, false, nullptr);
         }
         {
-            FluxBox&       destFlub = (*m_JgupPtr)[dit];
-            const FluxBox& srcFlub  = (*a_srcOp.m_JgupPtr)[dit];
+            FluxBox&       destFlub = (*m_unscaledJgupPtr)[dit];
+            const FluxBox& srcFlub  = (*a_srcOp.m_unscaledJgupPtr)[dit];
             CFInterp::localCoarsen(
                 destFlub, srcFlub, destFlub.box(), a_refRatio, nullptr);
         }
 
     }  // dit
     nanCheck(*m_Jptr);
-    nanCheck(*m_JgupPtr);
-
-    // invDiags
-    for (DataIterator dit(m_grids); dit.ok(); ++dit) {
-        FArrayBox&       invDiagsFAB = (*m_invDiagsPtr)[dit];
-        const Box&       destBox     = invDiagsFAB.box();
-        const FArrayBox& JgxxFAB     = (*m_JgupPtr)[dit][0];
-        const FArrayBox& JgyyFAB     = (*m_JgupPtr)[dit][1];
-        const FArrayBox& JgzzFAB     = (*m_JgupPtr)[dit][SpaceDim - 1];  // Not used in 2D
-        const FArrayBox& JFAB        = (*m_Jptr)[dit];
+    nanCheck(*m_unscaledJgupPtr);
 
-        debugInit(invDiagsFAB);
-        FORT_DIFFUSIVEOP_COMPUTEDIAGS(
-            CHF_FRA(invDiagsFAB),
-            CHF_CONST_FRA(JgxxFAB),
-            CHF_CONST_FRA(JgyyFAB),
-            CHF_CONST_FRA(JgzzFAB),
-            CHF_CONST_FRA1(JFAB, 0),
-            CHF_CONST_REALVECT(m_dXi),
-            CHF_BOX(destBox),
-            CHF_CONST_REAL(m_alpha));
-
-        invDiagsFAB.invert(1.0);
-    }
-    nanCheck(*m_invDiagsPtr);
+    // Jgup, invDiags, etc.
+    this->applyBetaToJgup();
+    this->cacheMatrixElements();
 }
 
 
@@ -591,7 +623,7 @@ DiffusiveOp::gsrb_relax(StateType&       a_phi,
             if (whichPass == 0) {
                 this->applyBCs(a_phi, nullptr, a_time, true, true);
             } else {
-                a_phi.exchange(m_exCopier);
+                LayoutTools::exchange(a_phi, m_exCopier);
             }
 
             for (DataIterator dit(m_grids); dit.ok(); ++dit) {
@@ -619,5 +651,276 @@ DiffusiveOp::gsrb_relax(StateType&       a_phi,
 }
 
 
+// -----------------------------------------------------------------------------
+void
+DiffusiveOp::vertLineGSRB_relax(StateType&       a_phi,
+                                const StateType& a_rhs,
+                                const Real       a_time,
+                                const int        a_iters) const
+{
+    if (a_iters == 0) return;
+
+    // The line solves reuse the factors built in cacheMatrixElements.
+    CH_assert(m_vertLineFactorsPtr);
+
+    // We want to preserve the horizontal index to compute
+    // the red-black ordering.
+    IntVect validShift       = IntVect::Zero;
+    validShift[SpaceDim - 1] = m_domain.domainBox().smallEnd(SpaceDim - 1);
+
+    // The BCs are rolled into the factors.
+    constexpr Real unitScale  = 1.0;
+    constexpr int  lagVertBCs = 0;
+
+    for (int iter = 0; iter < a_iters; ++iter) {
+        for (int whichPass = 0; whichPass < 2; ++whichPass) {
+            // Bottleneck!
+            if (whichPass == 0) {
+                this->applyBCs(a_phi, nullptr, a_time, true, true);
+            } else {
+                LayoutTools::exchange(a_phi, m_exCopier);
+            }
+
+            for (DataIterator dit(m_grids); dit.ok(); ++dit) {
+                FArrayBox&       phiFAB  = a_phi[dit];
+                const FArrayBox& rhsFAB  = a_rhs[dit];
+                const FArrayBox& JgxxFAB = (*m_JgupPtr)[dit][0];
+                const FArrayBox& JgyyFAB = (*m_JgupPtr)[dit][1]; // Not used in 2D
+                const FArrayBox& JgzzFAB = (*m_JgupPtr)[dit][SpaceDim - 1];
+                const FArrayBox& facFAB  = (*m_vertLineFactorsPtr)[dit];
+                const Box        valid   = m_grids[dit];
+
+                if constexpr (SpaceDim == 2) {
+                    FORT_VERTLINERELAX_HORIZRHSFC_2D(
+                        CHF_FRA_SHIFT(phiFAB, validShift),
+                        CHF_CONST_FRA_SHIFT(rhsFAB, validShift),
+                        CHF_CONST_FRA_SHIFT(JgxxFAB, validShift),
+                        CHF_CONST_FRA_SHIFT(JgzzFAB, validShift),
+                        CHF_CONST_REAL(unitScale),
+                        CHF_CONST_REALVECT(m_dXi),
+                        CHF_BOX_SHIFT(valid, validShift),
+                        CHF_CONST_INT(whichPass),
+                        CHF_CONST_INT(lagVertBCs));
+
+                    FORT_VERTLINERELAX_SOLVE_2D(
+                        CHF_FRA_SHIFT(phiFAB, validShift),
+                        CHF_CONST_FRA_SHIFT(facFAB, validShift),
+                        CHF_BOX_SHIFT(valid, validShift),
+                        CHF_CONST_INT(whichPass));
+                } else {
+                    FORT_VERTLINERELAX_HORIZRHSFC_3D(
+                        CHF_FRA_SHIFT(phiFAB, validShift),
+                        CHF_CONST_FRA_SHIFT(rhsFAB, validShift),
+                        CHF_CONST_FRA_SHIFT(JgxxFAB, validShift),
+                        CHF_CONST_FRA_SHIFT(JgyyFAB, validShift),
+                        CHF_CONST_FRA_SHIFT(JgzzFAB, validShift),
+                        CHF_CONST_REAL(unitScale),
+                        CHF_CONST_REALVECT(m_dXi),
+                        CHF_BOX_SHIFT(valid, validShift),
+                        CHF_CONST_INT(whichPass),
+                        CHF_CONST_INT(lagVertBCs));
+
+                    FORT_VERTLINERELAX_SOLVE_3D(
+                        CHF_FRA_SHIFT(phiFAB, validShift),
+                        CHF_CONST_FRA_SHIFT(facFAB, validShift),
+                        CHF_BOX_SHIFT(valid, validShift),
+                        CHF_CONST_INT(whichPass));
+                }
+            }  // dit
+        } // whichPass (red or black)
+    } // iter
+}
+
+
+// -----------------------------------------------------------------------------
+void
+DiffusiveOp::applyBetaToJgup()
+{
+    unshareMatrixElements(m_JgupPtr);
+
+    for (DataIterator dit(m_grids); dit.ok(); ++dit) {
+        for (int fcDir = 0; fcDir < SpaceDim; ++fcDir) {
+            FArrayBox& destFAB = (*m_JgupPtr)[dit][fcDir];
+            destFAB.copy((*m_unscaledJgupPtr)[dit][fcDir]);
+            destFAB *= m_beta;
+        }
+    }
+    nanCheck(*m_JgupPtr);
+}
+
+
+// -----------------------------------------------------------------------------
+void
+DiffusiveOp::cacheMatrixElements()
+{
+    unshareMatrixElements(m_invDiagsPtr);
+    unshareMatrixElements(m_vertLineFactorsPtr);
+
+    // invDiags
+    for (DataIterator dit(m_grids); dit.ok(); ++dit) {
+        FArrayBox&       invDiagsFAB = (*m_invDiagsPtr)[dit];
+        const Box&       destBox     = invDiagsFAB.box();
+        const FArrayBox& JgxxFAB     = (*m_JgupPtr)[dit][0];
+        const FArrayBox& JgyyFAB     = (*m_JgupPtr)[dit][1];
+        const FArrayBox& JgzzFAB     = (*m_JgupPtr)[dit][SpaceDim - 1];  // Not used in 2D
+        const FArrayBox& JFAB        = (*m_Jptr)[dit];
+
+        debugInit(invDiagsFAB);
+        FORT_DIFFUSIVEOP_COMPUTEDIAGS(
+            CHF_FRA(invDiagsFAB),
+            CHF_CONST_FRA(JgxxFAB),
+            CHF_CONST_FRA(JgyyFAB),
+            CHF_CONST_FRA(JgzzFAB),
+            CHF_CONST_FRA1(JFAB, 0),
+            CHF_CONST_REALVECT(m_dXi),
+            CHF_BOX(destBox),
+            CHF_CONST_REAL(m_alpha));
+
+        invDiagsFAB.invert(1.0);
+    }
+    nanCheck(*m_invDiagsPtr);
+
+    if (!m_useVertLineRelax) return;
+
+    // The tridiagonal systems only change with the operator, so we factor
+    // them here and let vertLineGSRB_relax reuse the factors.
+    if (!m_vertLineFactorsPtr) {
+        m_vertLineFactorsPtr.reset(
+            new LevelData<FArrayBox>(m_grids, 3 * this->numComps()));
+    }
+
+    const int numComps = this->numComps();
+    constexpr Real unitScale = 1.0;
+
+    IntVect validShift       = IntVect::Zero;
+    validShift[SpaceDim - 1] = m_domain.domainBox().smallEnd(SpaceDim - 1);
+
+    for (DataIterator dit(m_grids); dit.ok(); ++dit) {
+        FArrayBox&       facFAB      = (*m_vertLineFactorsPtr)[dit];
+        const FArrayBox& JgzzFAB     = (*m_JgupPtr)[dit][SpaceDim - 1];
+        const FArrayBox& invDiagsFAB = (*m_invDiagsPtr)[dit];
+        const Box        valid       = m_grids[dit];
+
+        FArrayBox xFAB(valid, SpaceDim);
+        m_geoSrc.fill_physCoor(xFAB, m_dXi);
+
+        FArrayBox      dummyFAB;
+        constexpr Real dummyTime = 0.0;
+        constexpr bool homogBCs  = true;
+
+        FArrayBox phiFAB(valid, numComps);
+        phiFAB.setVal(quietNAN);
+
+        // Get the homogeneous BC coefficients at the top and bottom.
+        const Box loBdry = bdryBox(valid, SpaceDim - 1, Side::Lo);
+        FArrayBox loBCalphaFAB(loBdry, numComps);
+        FArrayBox loBCbetaFAB(loBdry, numComps);
+        (*m_bcFuncPtr)(loBCalphaFAB,
+                       loBCbetaFAB,
+                       dummyFAB,
+                       phiFAB,
+                       xFAB,
+                       dit(),
+                       SpaceDim - 1,
+                       Side::Lo,
+                       dummyTime,
+                       homogBCs);
+
+        const Box hiBdry = bdryBox(valid, SpaceDim - 1, Side::Hi);
+        FArrayBox hiBCalphaFAB(hiBdry, numComps);
+        FArrayBox hiBCbetaFAB(hiBdry, numComps);
+        (*m_bcFuncPtr)(hiBCalphaFAB,
+                       hiBCbetaFAB,
+                       dummyFAB,
+                       phiFAB,
+                       xFAB,
+                       dit(),
+                       SpaceDim - 1,
+                       Side::Hi,
+                       dummyTime,
+                       homogBCs);
+
+        FArrayBox lowerFAB(valid, numComps);
+        FArrayBox diagFAB(valid, numComps);
+        FArrayBox upperFAB(valid, numComps);
+
+        if constexpr (SpaceDim == 2) {
+            FORT_VERTLINERELAX_TRIDIAGSFC_2D(
+                CHF_FRA_SHIFT(lowerFAB, validShift),
+                CHF_FRA_SHIFT(diagFAB, validShift),
+                CHF_FRA_SHIFT(upperFAB, validShift),
+                CHF_CONST_FRA_SHIFT(JgzzFAB, validShift),
+                CHF_CONST_FRA_SHIFT(invDiagsFAB, validShift),
+                CHF_CONST_REAL(unitScale),
+                CHF_CONST_REALVECT(m_dXi),
+                CHF_BOX_SHIFT(valid, validShift));
+
+            FORT_VERTLINERELAX_ROLLINBCS_2D(
+                CHF_FRA_SHIFT(diagFAB, validShift),
+                CHF_CONST_FRA_SHIFT(lowerFAB, validShift),
+                CHF_CONST_FRA_SHIFT(upperFAB, validShift),
+                CHF_CONST_FRA_SHIFT(loBCalphaFAB, validShift),
+                CHF_CONST_FRA_SHIFT(loBCbetaFAB, validShift),
+                CHF_CONST_FRA_SHIFT(hiBCalphaFAB, validShift),
+                CHF_CONST_FRA_SHIFT(hiBCbetaFAB, validShift),
+                CHF_CONST_REAL(m_dXi[SpaceDim - 1]),
+                CHF_BOX_SHIFT(valid, validShift));
+
+            FORT_VERTLINERELAX_FACTOR_2D(
+                CHF_FRA_SHIFT(facFAB, validShift),
+                CHF_CONST_FRA_SHIFT(lowerFAB, validShift),
+                CHF_CONST_FRA_SHIFT(diagFAB, validShift),
+                CHF_CONST_FRA_SHIFT(upperFAB, validShift),
+                CHF_BOX_SHIFT(valid, validShift));
+        } else {
+            FORT_VERTLINERELAX_TRIDIAGSFC_3D(
+                CHF_FRA_SHIFT(lowerFAB, validShift),
+                CHF_FRA_SHIFT(diagFAB, validShift),
+                CHF_FRA_SHIFT(upperFAB, validShift),
+                CHF_CONST_FRA_SHIFT(JgzzFAB, validShift),
+                CHF_CONST_FRA_SHIFT(invDiagsFAB, validShift),
+                CHF_CONST_REAL(unitScale),
+                CHF_CONST_REALVECT(m_dXi),
+                CHF_BOX_SHIFT(valid, validShift));
+
+            FORT_VERTLINERELAX_ROLLINBCS_3D(
+                CHF_FRA_SHIFT(diagFAB, validShift),
+                CHF_CONST_FRA_SHIFT(lowerFAB, validShift),
+                CHF_CONST_FRA_SHIFT(upperFAB, validShift),
+                CHF_CONST_FRA_SHIFT(loBCalphaFAB, validShift),
+                CHF_CONST_FRA_SHIFT(loBCbetaFAB, validShift),
+                CHF_CONST_FRA_SHIFT(hiBCalphaFAB, validShift),
+                CHF_CONST_FRA_SHIFT(hiBCbetaFAB, validShift),
+                CHF_CONST_REAL(m_dXi[SpaceDim - 1]),
+                CHF_BOX_SHIFT(valid, validShift));
+
+            FORT_VERTLINERELAX_FACTOR_3D(
+                CHF_FRA_SHIFT(facFAB, validShift),
+                CHF_CONST_FRA_SHIFT(lowerFAB, validShift),
+                CHF_CONST_FRA_SHIFT(diagFAB, validShift),
+                CHF_CONST_FRA_SHIFT(upperFAB, validShift),
+                CHF_BOX_SHIFT(valid, validShift));
+        }
+    }  // dit
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+DiffusiveOp::gridsAreSuitableForVertLines() const
+{
+    constexpr int vdir = SpaceDim - 1;
+    if (m_domain.isPeriodic(vdir)) return false;
+
+    const Box& domBox = m_domain.domainBox();
+    for (LayoutIterator lit = m_grids.layoutIterator(); lit.ok(); ++lit) {
+        const Box& valid = m_grids[lit];
+        if (valid.smallEnd(vdir) != domBox.smallEnd(vdir)) return false;
+        if (valid.bigEnd(vdir) != domBox.bigEnd(vdir)) return false;
+    }
+    return true;
+}
+
+
 }; // namespace Elliptic
 
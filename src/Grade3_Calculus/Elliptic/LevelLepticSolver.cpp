@@ -4,6 +4,7 @@
 #include "Debug.H"
 #include "LayoutTools.H"
 #include "LepticBoxTools.H"
+#include "NodeLoadBalance.H"
 #include "PoissonOpF_F.H"  // TODO: Don't reference PoissonOp.
 #include "ProjectorParameters.H"
 #include "SetValLevel.H"  // May not be needed
@@ -31,6 +32,8 @@ LevelLepticSolver::getDefaultOptions()
     opt.verbosity          = proj.verbosity;
     opt.hang               = proj.hang;
     opt.maxDivergingOrders = 2; // BUG: Hard-coded.
+    opt.loadBalanceByNode  = ProblemContext::getInstance()->amr.loadBalanceByNode;
+    opt.reportNodeTraffic  = ProblemContext::getInstance()->amr.reportNodeTraffic;
 
     // Horizontal solver parameters
     opt.horizOptions.absTol           = 1.0e-15;
@@ -127,6 +130,7 @@ LevelLepticSolver::LevelLepticSolver()
 //
 , m_grids()
 , m_JgupPtr()
+, m_vertFactorsPtr()
 , m_origToVertCopier()
 , m_vertToOrigCopier()
 , m_vertOpPtr()
@@ -213,7 +217,15 @@ LevelLepticSolver::define(
         Vector<Box> vertBoxArray;
         LepticBoxTools::createVerticalSolverGrids(
             vertBoxArray, m_origGrids.boxArray(), m_domain.domainBox());
-        m_grids.defineAndLoadBalance(vertBoxArray, nullptr, m_domain);
+        if (m_options.loadBalanceByNode) {
+            NodeLoadBalance::defineAndLoadBalance(
+                m_grids,
+                vertBoxArray,
+                m_domain,
+                m_options.reportNodeTraffic ? "Leptic vertical grids" : "");
+        } else {
+            m_grids.defineAndLoadBalance(vertBoxArray, nullptr, m_domain);
+        }
 
         // Copy metric data.
         m_JgupPtr.reset(new LevelData<FluxBox>(m_grids, 1));
@@ -221,6 +233,27 @@ LevelLepticSolver::define(
         debugInitLevel(*m_JgupPtr);
         origJgup.copyTo(*m_JgupPtr);
 
+        // Factor the vertical tridiagonal systems. These only depend on the
+        // metric, so verticalLineSolver can reuse them until we are redefined.
+        m_vertFactorsPtr.reset(new LevelData<FArrayBox>(m_grids, 2));
+        CH_assert(m_vertFactorsPtr);
+        for (DataIterator dit(m_grids); dit.ok(); ++dit) {
+            FArrayBox&       facFAB  = (*m_vertFactorsPtr)[dit];
+            const FArrayBox& JgzzFAB = (*m_JgupPtr)[dit][SpaceDim - 1];
+            const Box&       valid   = m_grids[dit];
+            const int        Nz      = valid.size(SpaceDim - 1);
+            const int        vertDir = SpaceDim - 1;
+
+            Box bottomBox = adjCellLo(valid, vertDir, 1);
+            bottomBox.shift(vertDir, 1);
+
+            FORT_TRIDIAGPOISSONNN1DFAB_FACTOR(CHF_FRA(facFAB),
+                                              CHF_CONST_FRA1(JgzzFAB, 0),
+                                              CHF_BOX(bottomBox),
+                                              CHF_CONST_INT(Nz),
+                                              CHF_CONST_INT(vertDir));
+        }
+
         // This helps copy the rhs.
         m_origToVertCopier.define(m_origGrids, m_grids, m_domain, IntVect::Zero, false);
         m_vertToOrigCopier = m_origToVertCopier;
@@ -292,7 +325,16 @@ LevelLepticSolver::define(
                                                     domBox,
                                                     horizBlockFactor);
         CH_assert(horizBoxArray.size() > 0);
-        m_horizGrids.defineAndLoadBalance(horizBoxArray, nullptr, m_horizDomain);
+        if (m_options.loadBalanceByNode) {
+            NodeLoadBalance::defineAndLoadBalance(
+                m_horizGrids,
+                horizBoxArray,
+                m_horizDomain,
+                m_options.reportNodeTraffic ? "Leptic horizontal grids" : "");
+        } else {
+            m_horizGrids.defineAndLoadBalance(
+                horizBoxArray, nullptr, m_horizDomain);
+        }
 
         // 5. Create the flat <--> horiz copiers.
         m_shiftedFlatToHorizCopier.define(m_shiftedFlatGrids,
@@ -378,6 +420,7 @@ LevelLepticSolver::clear()
     m_vertOpPtr.reset();
     m_vertToOrigCopier.clear();
     m_origToVertCopier.clear();
+    m_vertFactorsPtr.reset();
     m_JgupPtr.reset();
     m_grids = DisjointBoxLayout();
 
@@ -781,6 +824,7 @@ LevelLepticSolver::verticalLineSolver(
     // Sanity checks
     CH_assert(m_isDefined);
     CH_assert(m_JgupPtr);
+    CH_assert(m_vertFactorsPtr);
 
     CH_assert(a_vertPhi.ghostVect()[SpaceDim - 1] >= 1);
 
@@ -814,6 +858,7 @@ LevelLepticSolver::verticalLineSolver(
         FArrayBox&       phiFAB  = a_vertPhi[dit];
         FArrayBox&       rhsFAB  = a_vertRhs[dit];
         const FArrayBox& JgzzFAB = (*m_JgupPtr)[dit][SpaceDim - 1];
+        const FArrayBox& facFAB  = (*m_vertFactorsPtr)[dit];
         const Box&       valid   = m_grids[dit];
         const int        Nz      = valid.size(SpaceDim - 1);
         const Real       dz      = m_dXi[SpaceDim - 1];
@@ -832,18 +877,23 @@ LevelLepticSolver::verticalLineSolver(
         BUG("Can only handle Neum-Neum BCs for now.");
 
         // Use the modified homogeneous Neumann tridiagonal solver.
+        // All columns of this box are solved at once with the cached factors.
         const int vertDir   = SpaceDim - 1;
         Box       bottomBox = adjCellLo(valid, vertDir, 1);
         bottomBox.shift(vertDir, 1);
 
-        FORT_TRIDIAGPOISSONNN1DFAB(CHF_FRA(phiFAB),
-                                   CHF_CONST_FRA(rhsFAB),
-                                   CHF_CONST_FRA(upperBCFAB),
-                                   CHF_CONST_FRA1(JgzzFAB, 0),
-                                   CHF_BOX(bottomBox),
-                                   CHF_CONST_INT(Nz),
-                                   CHF_CONST_REAL(dz),
-                                   CHF_CONST_INT(vertDir));
+        FArrayBox avgFAB(bottomBox, 1);
+
+        FORT_TRIDIAGPOISSONNN1DFAB_FACTORED(CHF_FRA(phiFAB),
+                                            CHF_CONST_FRA(rhsFAB),
+                                            CHF_CONST_FRA(upperBCFAB),
+                                            CHF_CONST_FRA1(JgzzFAB, 0),
+                                            CHF_CONST_FRA(facFAB),
+                                            CHF_FRA1(avgFAB, 0),
+                                            CHF_BOX(bottomBox),
+                                            CHF_CONST_INT(Nz),
+                                            CHF_CONST_REAL(dz),
+                                            CHF_CONST_INT(vertDir));
     }  // end loop over grids (dit)
 
     // writeLevelHDF5(a_vertRhs, 0.0, false);
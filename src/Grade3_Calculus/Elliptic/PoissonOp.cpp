@@ -2,6 +2,7 @@
 
 #include "AnisotropicRefinementTools.H"
 #include "BCToolsF_F.H"
+#include "BoxCostModel.H"
 #include "CFInterp.H"
 #include "CFInterpF_F.H"
 #include "Comm.H"
@@ -11,12 +12,16 @@
 #include "Integral.H"
 #include "LayoutTools.H"
 #include "NeighborIterator.H"
+#include "NodeLoadBalance.H"
+#include "PhaseTimer.H"
 #include "PoissonOpF_F.H"
 #include "ProblemContext.H"
 #include "ProjectorParameters.H"
 #include "SOMAR_Constants.H"
 #include "Subspace.H"
 #include "LepticBoxTools.H"
+#include "ThreadTools.H"
+#include "VertLineRelaxF_F.H"
 
 // NOTE: The nanChecks in applyOp(...) take the most time by far!
 #ifndef NDEBUG
@@ -263,6 +268,13 @@ PoissonOp::PoissonOp(const PoissonOp& a_srcOp)
             const_cast<LevelData<FArrayBox>*>(&a_srcOp.m_vertTriDiagsHiBCs),
             a_srcOp.m_vertTriDiagsHiBCs.interval());
     }
+
+    if (a_srcOp.m_vertTriDiagsFactors.isDefined()) {
+        aliasLevelData(
+            m_vertTriDiagsFactors,
+            const_cast<LevelData<FArrayBox>*>(&a_srcOp.m_vertTriDiagsFactors),
+            a_srcOp.m_vertTriDiagsFactors.interval());
+    }
 }
 
 
@@ -579,10 +591,16 @@ PoissonOp::cacheMatrixElements()
         m_vertTriDiagsLoBCs.define(loBCGrids, m_numComps);
         m_vertTriDiagsHiBCs.define(hiBCGrids, m_numComps);
 
+        // The tridiagonal systems only change with the operator, so we factor
+        // them here and let vertLineGSRB_relax reuse the factors.
+        m_vertTriDiagsFactors.define(m_grids, 3);
+
         for (DataIterator dit(m_grids); dit.ok(); ++dit) {
             FArrayBox&       loBCFAB = m_vertTriDiagsLoBCs[dit];
             FArrayBox&       hiBCFAB = m_vertTriDiagsHiBCs[dit];
+            FArrayBox&       facFAB  = m_vertTriDiagsFactors[dit];
             const FArrayBox& JFAB    = m_J[dit];
+            const FArrayBox& DinvFAB = m_Dinv[dit];
             const Box        valid   = m_grids[dit];
 
             FArrayBox xFAB(valid, SpaceDim);
@@ -595,6 +613,10 @@ PoissonOp::cacheMatrixElements()
             FArrayBox phiFAB(valid, m_numComps);
             phiFAB.setVal(quietNAN);
 
+            FArrayBox lowerFAB(valid, 1);
+            FArrayBox diagFAB(valid, 1);
+            FArrayBox upperFAB(valid, 1);
+
             // Get important regions.
             const Box loBdry = bdryBox(valid, SpaceDim - 1, Side::Lo);
             FArrayBox loBCalphaFAB(loBdry, m_numComps);
@@ -645,6 +667,16 @@ PoissonOp::cacheMatrixElements()
                     CHF_CONST_REAL(hidz),
                     CHF_FRA_SHIFT(loBCFAB, validShift),
                     CHF_FRA_SHIFT(hiBCFAB, validShift));
+
+                FORT_POISSONOP_VERTLINETRIDIAGS_2D(
+                    CHF_FRA1_SHIFT(lowerFAB, 0, validShift),
+                    CHF_FRA1_SHIFT(diagFAB, 0, validShift),
+                    CHF_FRA1_SHIFT(upperFAB, 0, validShift),
+                    CHF_CONST_FRA1_SHIFT(JFAB, 0, validShift),
+                    CHF_CONST_FRA_SHIFT(m_M[SpaceDim - 1], validShift),
+                    CHF_CONST_FRA1_SHIFT(DinvFAB, 0, validShift),
+                    CHF_CONST_REAL(m_beta),
+                    CHF_BOX_SHIFT(valid, validShift));
             } else {
                 FORT_POISSONOP_DEFINEVERTLINERELAXBCS_3D(
                     CHF_CONST_FRA1_SHIFT(JFAB, 0, validShift),
@@ -659,6 +691,35 @@ PoissonOp::cacheMatrixElements()
                     CHF_CONST_REAL(hidz),
                     CHF_FRA_SHIFT(loBCFAB, validShift),
                     CHF_FRA_SHIFT(hiBCFAB, validShift));
+
+                FORT_POISSONOP_VERTLINETRIDIAGS_3D(
+                    CHF_FRA1_SHIFT(lowerFAB, 0, validShift),
+                    CHF_FRA1_SHIFT(diagFAB, 0, validShift),
+                    CHF_FRA1_SHIFT(upperFAB, 0, validShift),
+                    CHF_CONST_FRA1_SHIFT(JFAB, 0, validShift),
+                    CHF_CONST_FRA_SHIFT(m_M[SpaceDim - 1], validShift),
+                    CHF_CONST_FRA1_SHIFT(DinvFAB, 0, validShift),
+                    CHF_CONST_REAL(m_beta),
+                    CHF_BOX_SHIFT(valid, validShift));
+            }
+
+            diagFAB.plus(loBCFAB, loBCFAB.box(), 0, 0, 1);
+            diagFAB.plus(hiBCFAB, hiBCFAB.box(), 0, 0, 1);
+
+            if constexpr (SpaceDim == 2) {
+                FORT_VERTLINERELAX_FACTOR_2D(
+                    CHF_FRA_SHIFT(facFAB, validShift),
+                    CHF_CONST_FRA_SHIFT(lowerFAB, validShift),
+                    CHF_CONST_FRA_SHIFT(diagFAB, validShift),
+                    CHF_CONST_FRA_SHIFT(upperFAB, validShift),
+                    CHF_BOX_SHIFT(valid, validShift));
+            } else {
+                FORT_VERTLINERELAX_FACTOR_3D(
+                    CHF_FRA_SHIFT(facFAB, validShift),
+                    CHF_CONST_FRA_SHIFT(lowerFAB, validShift),
+                    CHF_CONST_FRA_SHIFT(diagFAB, validShift),
+                    CHF_CONST_FRA_SHIFT(upperFAB, validShift),
+                    CHF_BOX_SHIFT(valid, validShift));
             }
         }  // dit
     }
@@ -737,7 +798,7 @@ PoissonOp::applyBCsBegin(LevelData<FArrayBox>&       a_phi,
     CH_assert(m_cfiIter.isDefined());
 
     // Begin exchange
-    a_phi.exchangeBegin(m_exCopier);
+    LayoutTools::exchangeBegin(a_phi, m_exCopier);
 
     // CFI BCs
     if (!m_cfiIter.isEmpty()) {
@@ -780,29 +841,38 @@ PoissonOp::applyOpNoBCs(LevelData<FArrayBox>&       a_lhs,
     CH_assert(a_phi.ghostVect() >= m_activeDirs);
     nanCheck(a_phi);
 
-    for (DataIterator dit(m_grids); dit.ok(); ++dit) {
+    const DataIterator dit      = m_grids.dataIterator();
+    const int          numBoxes = dit.size();
+    std::vector<double>* boxCostsPtr =
+        BoxCostModel::findCosts(PhaseTimer::currentLevel(), m_grids);
+
+    OMP_PARALLEL_FOR
+    for (int ibox = 0; ibox < numBoxes; ++ibox) {
+        const DataIndex& di = dit[ibox];
+        BoxCostModel::Scope costScope(boxCostsPtr, di);
+
         if (m_activeDirs == IntVect::Unit) {
-            FORT_POISSONOP_APPLYOP(CHF_FRA(a_lhs[dit]),
-                                   CHF_CONST_FRA(a_phi[dit]),
+            FORT_POISSONOP_APPLYOP(CHF_FRA(a_lhs[di]),
+                                   CHF_CONST_FRA(a_phi[di]),
                                    CHF_CONST_FRA(m_M[0]),
                                    CHF_CONST_FRA(m_M[1]),
                                    CHF_CONST_FRA(m_M[SpaceDim - 1]),
-                                   CHF_CONST_FRA1(m_Dinv[dit], 0),
-                                   CHF_CONST_FRA1(m_J[dit], 0),
+                                   CHF_CONST_FRA1(m_Dinv[di], 0),
+                                   CHF_CONST_FRA1(m_J[di], 0),
                                    CHF_CONST_REALVECT(m_dXi),
                                    CHF_CONST_REAL(m_beta),
-                                   CHF_BOX(m_grids[dit]));
+                                   CHF_BOX(m_grids[di]));
         } else {
-            FORT_POISSONOP_APPLYOPDIRS(CHF_FRA(a_lhs[dit]),
-                                       CHF_CONST_FRA(a_phi[dit]),
+            FORT_POISSONOP_APPLYOPDIRS(CHF_FRA(a_lhs[di]),
+                                       CHF_CONST_FRA(a_phi[di]),
                                        CHF_CONST_FRA(m_M[0]),
                                        CHF_CONST_FRA(m_M[1]),
                                        CHF_CONST_FRA(m_M[SpaceDim - 1]),
-                                       CHF_CONST_FRA1(m_Dinv[dit], 0),
-                                       CHF_CONST_FRA1(m_J[dit], 0),
+                                       CHF_CONST_FRA1(m_Dinv[di], 0),
+                                       CHF_CONST_FRA1(m_J[di], 0),
                                        CHF_CONST_REALVECT(m_dXi),
                                        CHF_CONST_REAL(m_beta),
-                                       CHF_BOX(m_grids[dit]),
+                                       CHF_BOX(m_grids[di]),
                                        CHF_CONST_INTVECT(m_activeDirs));
         }
     }  // dit
@@ -984,6 +1054,34 @@ PoissonOp::newMGOperator(const IntVect& a_refRatio) const
 }
 
 
+// -----------------------------------------------------------------------------
+// Factory method.
+// Allocate + define a copy of *this over a_grids, which must cover the
+// same region as m_grids. Used to agglomerate the MG bottom solve.
+// Deletion is left to the caller.
+// -----------------------------------------------------------------------------
+MGOperator<LevelData<FArrayBox>>*
+PoissonOp::newRedistributedMGOperator(const DisjointBoxLayout& a_grids) const
+{
+    CH_assert(a_grids.physDomain() == m_domain);
+
+    PoissonOp* newOpPtr = new PoissonOp(*this, a_grids);
+
+    // The new op filled its metric from m_geoSrc, but MG depths carry
+    // metric data that was averaged down from the finer depths. Copy ours
+    // so that the redistributed op is identical to *this.
+    m_J.copyTo(newOpPtr->m_J);
+    m_Jgup.copyTo(newOpPtr->m_Jgup);
+    nanCheck(newOpPtr->m_J);
+    nanCheck(newOpPtr->m_Jgup);
+
+    newOpPtr->cacheMatrixElements();
+    newOpPtr->m_hasNullSpace = m_hasNullSpace;
+
+    return newOpPtr;
+}
+
+
 // -----------------------------------------------------------------------------
 // Restrict to coarser MG depth: a_crseRes = I[h->2h](a_fineRes).
 // This op is at the fine level.
@@ -1122,7 +1220,7 @@ PoissonOp::MGProlong(StateType&      a_finePhi,
         }
         const auto& crsePoissonOp = static_cast<const PoissonOp&>(a_crseOp);
         CH_verify(crsePoissonOp.m_HOProlongCornerCopier.isDefined());
-        a_crseCor.exchange(crsePoissonOp.m_HOProlongCornerCopier);
+        LayoutTools::exchange(a_crseCor, crsePoissonOp.m_HOProlongCornerCopier);
 
         // Update with mixed second derivative terms.
         for (dit.reset(); dit.ok(); ++dit) {
@@ -1669,7 +1767,13 @@ PoissonOp::createHorizontalMGOperator(const DisjointBoxLayout& a_hgrids) const
                                                     crseDomBox,
                                                     horizBlockFactor);
         CH_assert(hCrseBoxArray.size() > 0);
-        hCrseGrids.defineAndLoadBalance(hCrseBoxArray, nullptr, hCrseDomain);
+        if (ProblemContext::getInstance()->amr.loadBalanceByNode) {
+            NodeLoadBalance::defineAndLoadBalance(
+                hCrseGrids, hCrseBoxArray, hCrseDomain);
+        } else {
+            hCrseGrids.defineAndLoadBalance(
+                hCrseBoxArray, nullptr, hCrseDomain);
+        }
     }
 
     const int hRelaxMethod = ((m_relaxMethod == 6) ? 5 : m_relaxMethod);
@@ -1714,19 +1818,27 @@ PoissonOp::jacobi_relax(LevelData<FArrayBox>&       a_phi,
                         const int                   a_iters) const
 {
     LevelData<FArrayBox> res(m_grids, m_numComps);
+    const DataIterator dit      = m_grids.dataIterator();
+    const int          numBoxes = dit.size();
+    std::vector<double>* boxCostsPtr =
+        BoxCostModel::findCosts(PhaseTimer::currentLevel(), m_grids);
 
     for (int iter = 0; iter < a_iters; ++iter) {
         // Compute residual
         this->residual(res, a_phi, nullptr, a_rhs, a_time, true, true);
 
         // Relax
-        for (DataIterator dit(m_grids); dit.ok(); ++dit) {
-            FArrayBox& resFAB = res[dit];
-            const Box& valid  = m_grids[dit];
+        OMP_PARALLEL_FOR
+        for (int ibox = 0; ibox < numBoxes; ++ibox) {
+            const DataIndex& di = dit[ibox];
+            BoxCostModel::Scope costScope(boxCostsPtr, di);
 
-            FORT_POISSONOP_JACOBI(CHF_FRA(a_phi[dit]),
+            FArrayBox& resFAB = res[di];
+            const Box& valid  = m_grids[di];
+
+            FORT_POISSONOP_JACOBI(CHF_FRA(a_phi[di]),
                                   CHF_CONST_FRA(resFAB),
-                                  CHF_CONST_FRA1(m_Dinv[dit], 0),
+                                  CHF_CONST_FRA1(m_Dinv[di], 0),
                                   CHF_BOX(valid));
         }
     }
@@ -1743,32 +1855,44 @@ PoissonOp::jacobiRB_relax(LevelData<FArrayBox>&       a_phi,
                           const int                   a_iters) const
 {
     LevelData<FArrayBox> res(m_grids, m_numComps);
+    const DataIterator dit      = m_grids.dataIterator();
+    const int          numBoxes = dit.size();
+    std::vector<double>* boxCostsPtr =
+        BoxCostModel::findCosts(PhaseTimer::currentLevel(), m_grids);
 
     for (int iter = 0; iter < a_iters; ++iter) {
         this->residual(res, a_phi, nullptr, a_rhs, a_time, true, true);
 
         int whichPass = 0;
-        for (DataIterator dit(m_grids); dit.ok(); ++dit) {
-            FArrayBox& resFAB = res[dit];
-            const Box& valid  = m_grids[dit];
+        OMP_PARALLEL_FOR
+        for (int ibox = 0; ibox < numBoxes; ++ibox) {
+            const DataIndex& di = dit[ibox];
+            BoxCostModel::Scope costScope(boxCostsPtr, di);
+
+            FArrayBox& resFAB = res[di];
+            const Box& valid  = m_grids[di];
 
-            FORT_POISSONOP_JACOBIRB(CHF_FRA(a_phi[dit]),
+            FORT_POISSONOP_JACOBIRB(CHF_FRA(a_phi[di]),
                                     CHF_CONST_FRA(resFAB),
-                                    CHF_CONST_FRA1(m_Dinv[dit], 0),
+                                    CHF_CONST_FRA1(m_Dinv[di], 0),
                                     CHF_CONST_INT(whichPass),
                                     CHF_BOX(valid));
         }
 
-        a_phi.exchange(m_exCopier);
+        LayoutTools::exchange(a_phi, m_exCopier);
 
         whichPass = 1;
-        for (DataIterator dit(m_grids); dit.ok(); ++dit) {
-            FArrayBox& resFAB = res[dit];
-            const Box& valid  = m_grids[dit];
+        OMP_PARALLEL_FOR
+        for (int ibox = 0; ibox < numBoxes; ++ibox) {
+            const DataIndex& di = dit[ibox];
+            BoxCostModel::Scope costScope(boxCostsPtr, di);
+
+            FArrayBox& resFAB = res[di];
+            const Box& valid  = m_grids[di];
 
-            FORT_POISSONOP_JACOBIRB(CHF_FRA(a_phi[dit]),
+            FORT_POISSONOP_JACOBIRB(CHF_FRA(a_phi[di]),
                                     CHF_CONST_FRA(resFAB),
-                                    CHF_CONST_FRA1(m_Dinv[dit], 0),
+                                    CHF_CONST_FRA1(m_Dinv[di], 0),
                                     CHF_CONST_INT(whichPass),
                                     CHF_BOX(valid));
         }
@@ -1785,20 +1909,29 @@ PoissonOp::gs_relax(LevelData<FArrayBox>&       a_phi,
                     const Real                  a_time,
                     const int                   a_iters) const
 {
+    const DataIterator dit      = m_grids.dataIterator();
+    const int          numBoxes = dit.size();
+    std::vector<double>* boxCostsPtr =
+        BoxCostModel::findCosts(PhaseTimer::currentLevel(), m_grids);
+
     if (m_activeDirs == IntVect::Unit) {
         for (int iter = 0; iter < a_iters; ++iter) {
             this->applyBCs(a_phi, nullptr, a_time, true, true);
 
-            for (DataIterator dit(m_grids); dit.ok(); ++dit) {
-                FORT_POISSONOP_GS(CHF_FRA(a_phi[dit]),
-                                  CHF_CONST_FRA(a_rhs[dit]),
-                                  CHF_CONST_FRA1(m_J[dit], 0),
+            OMP_PARALLEL_FOR
+            for (int ibox = 0; ibox < numBoxes; ++ibox) {
+                const DataIndex& di = dit[ibox];
+                BoxCostModel::Scope costScope(boxCostsPtr, di);
+
+                FORT_POISSONOP_GS(CHF_FRA(a_phi[di]),
+                                  CHF_CONST_FRA(a_rhs[di]),
+                                  CHF_CONST_FRA1(m_J[di], 0),
                                   CHF_CONST_FRA(m_M[0]),
                                   CHF_CONST_FRA(m_M[1]),
                                   CHF_CONST_FRA(m_M[SpaceDim - 1]),
-                                  CHF_CONST_FRA1(m_Dinv[dit], 0),
+                                  CHF_CONST_FRA1(m_Dinv[di], 0),
                                   CHF_CONST_REAL(m_beta),
-                                  CHF_BOX(m_grids[dit]));
+                                  CHF_BOX(m_grids[di]));
             }  // dit
         }  // iter
 
@@ -1806,15 +1939,19 @@ PoissonOp::gs_relax(LevelData<FArrayBox>&       a_phi,
         for (int iter = 0; iter < a_iters; ++iter) {
             this->applyBCs(a_phi, nullptr, a_time, true, true);
 
-            for (DataIterator dit(m_grids); dit.ok(); ++dit) {
-                FORT_POISSONOP_GS_HORIZ(CHF_FRA(a_phi[dit]),
-                                        CHF_CONST_FRA(a_rhs[dit]),
-                                        CHF_CONST_FRA1(m_J[dit], 0),
+            OMP_PARALLEL_FOR
+            for (int ibox = 0; ibox < numBoxes; ++ibox) {
+                const DataIndex& di = dit[ibox];
+                BoxCostModel::Scope costScope(boxCostsPtr, di);
+
+                FORT_POISSONOP_GS_HORIZ(CHF_FRA(a_phi[di]),
+                                        CHF_CONST_FRA(a_rhs[di]),
+                                        CHF_CONST_FRA1(m_J[di], 0),
                                         CHF_CONST_FRA(m_M[0]),
                                         CHF_CONST_FRA(m_M[SpaceDim - 2]),
-                                        CHF_CONST_FRA1(m_Dinv[dit], 0),
+                                        CHF_CONST_FRA1(m_Dinv[di], 0),
                                         CHF_CONST_REAL(m_beta),
-                                        CHF_BOX(m_grids[dit]));
+                                        CHF_BOX(m_grids[di]));
             }  // dit
         }  // iter
 
@@ -1835,6 +1972,11 @@ PoissonOp::gsrb_relax(LevelData<FArrayBox>&       a_phi,
                       const Real                  a_time,
                       const int                   a_iters) const
 {
+    const DataIterator dit      = m_grids.dataIterator();
+    const int          numBoxes = dit.size();
+    std::vector<double>* boxCostsPtr =
+        BoxCostModel::findCosts(PhaseTimer::currentLevel(), m_grids);
+
     if (m_activeDirs == IntVect::Unit) {
         for (int iter = 0; iter < a_iters; ++iter) {
             this->applyBCs(a_phi,
@@ -1844,32 +1986,40 @@ PoissonOp::gsrb_relax(LevelData<FArrayBox>&       a_phi,
                            true);  // Bottleneck! (due to exchange)
 
             int whichPass = 0;
-            for (DataIterator dit(m_grids); dit.ok(); ++dit) {
-                FORT_POISSONOP_GSRB(CHF_FRA(a_phi[dit]),
-                                    CHF_CONST_FRA(a_rhs[dit]),
-                                    CHF_CONST_FRA1(m_J[dit], 0),
+            OMP_PARALLEL_FOR
+            for (int ibox = 0; ibox < numBoxes; ++ibox) {
+                const DataIndex& di = dit[ibox];
+                BoxCostModel::Scope costScope(boxCostsPtr, di);
+
+                FORT_POISSONOP_GSRB(CHF_FRA(a_phi[di]),
+                                    CHF_CONST_FRA(a_rhs[di]),
+                                    CHF_CONST_FRA1(m_J[di], 0),
                                     CHF_CONST_FRA(m_M[0]),
                                     CHF_CONST_FRA(m_M[1]),
                                     CHF_CONST_FRA(m_M[SpaceDim - 1]),
-                                    CHF_CONST_FRA1(m_Dinv[dit], 0),
+                                    CHF_CONST_FRA1(m_Dinv[di], 0),
                                     CHF_CONST_REAL(m_beta),
-                                    CHF_BOX(m_grids[dit]),
+                                    CHF_BOX(m_grids[di]),
                                     CHF_CONST_INT(whichPass));
             }  // dit
 
-            a_phi.exchange(m_exCopier);  // Bottleneck!
+            LayoutTools::exchange(a_phi, m_exCopier);  // Bottleneck!
 
             whichPass = 1;
-            for (DataIterator dit(m_grids); dit.ok(); ++dit) {
-                FORT_POISSONOP_GSRB(CHF_FRA(a_phi[dit]),
-                                    CHF_CONST_FRA(a_rhs[dit]),
-                                    CHF_CONST_FRA1(m_J[dit], 0),
+            OMP_PARALLEL_FOR
+            for (int ibox = 0; ibox < numBoxes; ++ibox) {
+                const DataIndex& di = dit[ibox];
+                BoxCostModel::Scope costScope(boxCostsPtr, di);
+
+                FORT_POISSONOP_GSRB(CHF_FRA(a_phi[di]),
+                                    CHF_CONST_FRA(a_rhs[di]),
+                                    CHF_CONST_FRA1(m_J[di], 0),
                                     CHF_CONST_FRA(m_M[0]),
                                     CHF_CONST_FRA(m_M[1]),
                                     CHF_CONST_FRA(m_M[SpaceDim - 1]),
-                                    CHF_CONST_FRA1(m_Dinv[dit], 0),
+                                    CHF_CONST_FRA1(m_Dinv[di], 0),
                                     CHF_CONST_REAL(m_beta),
-                                    CHF_BOX(m_grids[dit]),
+                                    CHF_BOX(m_grids[di]),
                                     CHF_CONST_INT(whichPass));
             }  // dit
         }  // iter
@@ -1883,30 +2033,38 @@ PoissonOp::gsrb_relax(LevelData<FArrayBox>&       a_phi,
                            true);  // Bottleneck! (due to exchange)
 
             int whichPass = 0;
-            for (DataIterator dit(m_grids); dit.ok(); ++dit) {
-                FORT_POISSONOP_GSRB_HORIZ(CHF_FRA(a_phi[dit]),
-                                          CHF_CONST_FRA(a_rhs[dit]),
-                                          CHF_CONST_FRA1(m_J[dit], 0),
+            OMP_PARALLEL_FOR
+            for (int ibox = 0; ibox < numBoxes; ++ibox) {
+                const DataIndex& di = dit[ibox];
+                BoxCostModel::Scope costScope(boxCostsPtr, di);
+
+                FORT_POISSONOP_GSRB_HORIZ(CHF_FRA(a_phi[di]),
+                                          CHF_CONST_FRA(a_rhs[di]),
+                                          CHF_CONST_FRA1(m_J[di], 0),
                                           CHF_CONST_FRA(m_M[0]),
                                           CHF_CONST_FRA(m_M[SpaceDim - 2]),
-                                          CHF_CONST_FRA1(m_Dinv[dit], 0),
+                                          CHF_CONST_FRA1(m_Dinv[di], 0),
                                           CHF_CONST_REAL(m_beta),
-                                          CHF_BOX(m_grids[dit]),
+                                          CHF_BOX(m_grids[di]),
                                           CHF_CONST_INT(whichPass));
             }  // dit
 
-            a_phi.exchange(m_exCopier);  // Bottleneck!
+            LayoutTools::exchange(a_phi, m_exCopier);  // Bottleneck!
 
             whichPass = 1;
-            for (DataIterator dit(m_grids); dit.ok(); ++dit) {
-                FORT_POISSONOP_GSRB_HORIZ(CHF_FRA(a_phi[dit]),
-                                          CHF_CONST_FRA(a_rhs[dit]),
-                                          CHF_CONST_FRA1(m_J[dit], 0),
+            OMP_PARALLEL_FOR
+            for (int ibox = 0; ibox < numBoxes; ++ibox) {
+                const DataIndex& di = dit[ibox];
+                BoxCostModel::Scope costScope(boxCostsPtr, di);
+
+                FORT_POISSONOP_GSRB_HORIZ(CHF_FRA(a_phi[di]),
+                                          CHF_CONST_FRA(a_rhs[di]),
+                                          CHF_CONST_FRA1(m_J[di], 0),
                                           CHF_CONST_FRA(m_M[0]),
                                           CHF_CONST_FRA(m_M[SpaceDim - 2]),
-                                          CHF_CONST_FRA1(m_Dinv[dit], 0),
+                                          CHF_CONST_FRA1(m_Dinv[di], 0),
                                           CHF_CONST_REAL(m_beta),
-                                          CHF_BOX(m_grids[dit]),
+                                          CHF_BOX(m_grids[di]),
                                           CHF_CONST_INT(whichPass));
             }  // dit
         }  // iter
@@ -1922,7 +2080,7 @@ PoissonOp::gsrb_relax(LevelData<FArrayBox>&       a_phi,
 // -----------------------------------------------------------------------------
 // Red-Black Gauss-Seidel line relaxation.
 // -----------------------------------------------------------------------------
-#if 1 // 1 = async exchange, 0 = sync exchange.
+#if 1 // 1 = sync exchange with factored lines, 0 = async exchange.
 void
 PoissonOp::vertLineGSRB_relax(LevelData<FArrayBox>&       a_phi,
                               const LevelData<FArrayBox>& a_rhs,
@@ -1936,17 +2094,13 @@ PoissonOp::vertLineGSRB_relax(LevelData<FArrayBox>&       a_phi,
     CH_assert(m_bcFuncPtr);
     FArrayBox dummyFAB;
 
-    // Create workspace for Fortran
-    int Nz = m_domain.size(SpaceDim - 1);
-    Box workspace(IntVect::Unit, IntVect(D_DECL(Nz, 1, 1)));
-    BaseFab<Real> D(workspace, 1);
-    BaseFab<Real> B(workspace, 1);
-
-    workspace.shift(0, 1);
-    BaseFab<Real> DU(workspace, 1);  // Last element not used.
+    // The line solves reuse the factors built in cacheMatrixElements.
+    CH_assert(m_vertTriDiagsFactors.isDefined());
 
-    workspace.shift(0, -1);
-    BaseFab<Real> DL(workspace, 1);  // Last element not used.
+    const DataIterator dit      = m_grids.dataIterator();
+    const int          numBoxes = dit.size();
+    std::vector<double>* boxCostsPtr =
+        BoxCostModel::findCosts(PhaseTimer::currentLevel(), m_grids);
 
     // We want to preserve the horizontal index to compute
     // the red-black ordering.
@@ -1961,53 +2115,51 @@ PoissonOp::vertLineGSRB_relax(LevelData<FArrayBox>&       a_phi,
                                true,
                                true);  // Bottleneck! (due to exchange)
             } else {
-                a_phi.exchange(m_exCopier);  // Bottleneck!
+                LayoutTools::exchange(a_phi, m_exCopier);  // Bottleneck!
             }
 
-            for (DataIterator dit(m_grids); dit.ok(); ++dit) {
-                FArrayBox&       phiFAB  = a_phi[dit];
-                const FArrayBox& rhsFAB  = a_rhs[dit];
-                const FArrayBox& JFAB    = m_J[dit];
-                const FArrayBox& DinvFAB = m_Dinv[dit];
-                const FArrayBox& loBCFAB = m_vertTriDiagsLoBCs[dit];
-                const FArrayBox& hiBCFAB = m_vertTriDiagsHiBCs[dit];
-                const Box        valid   = m_grids[dit];
+            OMP_PARALLEL_FOR
+            for (int ibox = 0; ibox < numBoxes; ++ibox) {
+                const DataIndex& di  = dit[ibox];
+                BoxCostModel::Scope costScope(boxCostsPtr, di);
+
+                FArrayBox&       phiFAB  = a_phi[di];
+                const FArrayBox& rhsFAB  = a_rhs[di];
+                const FArrayBox& JFAB    = m_J[di];
+                const FArrayBox& facFAB  = m_vertTriDiagsFactors[di];
+                const Box        valid   = m_grids[di];
 
                 if constexpr (SpaceDim == 2) {
-                    FORT_POISSONOP_VERTLINEGSRB_2D(
+                    FORT_POISSONOP_VERTLINEHORIZRHS_2D(
                         CHF_FRA1_SHIFT(phiFAB, 0, validShift),
                         CHF_CONST_FRA1_SHIFT(rhsFAB, 0, validShift),
                         CHF_CONST_FRA1_SHIFT(JFAB, 0, validShift),
                         CHF_CONST_FRA(m_M[0]),
-                        CHF_CONST_FRA_SHIFT(m_M[SpaceDim - 1], validShift),
-                        CHF_CONST_FRA1_SHIFT(DinvFAB, 0, validShift),
                         CHF_CONST_REAL(m_beta),
                         CHF_BOX_SHIFT(valid, validShift),
-                        CHF_CONST_INT(whichPass),
-                        CHF_CONST_FRA1_SHIFT(loBCFAB, 0, validShift),
-                        CHF_CONST_FRA1_SHIFT(hiBCFAB, 0, validShift),
-                        CHF_FRA1(DU, 0),
-                        CHF_FRA1(D, 0),
-                        CHF_FRA1(DL, 0),
-                        CHF_FRA1(B, 0));
+                        CHF_CONST_INT(whichPass));
+
+                    FORT_VERTLINERELAX_SOLVE_2D(
+                        CHF_FRA_SHIFT(phiFAB, validShift),
+                        CHF_CONST_FRA_SHIFT(facFAB, validShift),
+                        CHF_BOX_SHIFT(valid, validShift),
+                        CHF_CONST_INT(whichPass));
                 } else {
-                    FORT_POISSONOP_VERTLINEGSRB_3D(
+                    FORT_POISSONOP_VERTLINEHORIZRHS_3D(
                         CHF_FRA1_SHIFT(phiFAB, 0, validShift),
                         CHF_CONST_FRA1_SHIFT(rhsFAB, 0, validShift),
                         CHF_CONST_FRA1_SHIFT(JFAB, 0, validShift),
                         CHF_CONST_FRA(m_M[0]),
                         CHF_CONST_FRA(m_M[1]),
-                        CHF_CONST_FRA_SHIFT(m_M[SpaceDim - 1], validShift),
-                        CHF_CONST_FRA1_SHIFT(DinvFAB, 0, validShift),
                         CHF_CONST_REAL(m_beta),
                         CHF_BOX_SHIFT(valid, validShift),
-                        CHF_CONST_INT(whichPass),
-                        CHF_CONST_FRA1_SHIFT(loBCFAB, 0, validShift),
-                        CHF_CONST_FRA1_SHIFT(hiBCFAB, 0, validShift),
-                        CHF_FRA1(DU, 0),
-                        CHF_FRA1(D, 0),
-                        CHF_FRA1(DL, 0),
-                        CHF_FRA1(B, 0));
+                        CHF_CONST_INT(whichPass));
+
+                    FORT_VERTLINERELAX_SOLVE_3D(
+                        CHF_FRA_SHIFT(phiFAB, validShift),
+                        CHF_CONST_FRA_SHIFT(facFAB, validShift),
+                        CHF_BOX_SHIFT(valid, validShift),
+                        CHF_CONST_INT(whichPass));
                 }
             }  // dit
         }  // whichPass
@@ -2016,6 +2168,8 @@ PoissonOp::vertLineGSRB_relax(LevelData<FArrayBox>&       a_phi,
 
 #else
 
+// Overlaps the exchange with the interior lines. This still calls the
+// unfactored PoissonOp_VertLineGSRB kernels.
 void
 PoissonOp::vertLineGSRB_relax(LevelData<FArrayBox>&       a_phi,
                               const LevelData<FArrayBox>& a_rhs,
@@ -2056,7 +2210,7 @@ PoissonOp::vertLineGSRB_relax(LevelData<FArrayBox>&       a_phi,
                                     true,
                                     true);  // Bottleneck! (due to exchange)
             } else {
-                a_phi.exchangeBegin(m_exCopier);  // Bottleneck!
+                LayoutTools::exchangeBegin(a_phi, m_exCopier);  // Bottleneck!
             }
 
             for (DataIterator dit(m_grids); dit.ok(); ++dit) {
@@ -2111,7 +2265,7 @@ PoissonOp::vertLineGSRB_relax(LevelData<FArrayBox>&       a_phi,
             if (whichPass == 0) {
                 this->applyBCsEnd(a_phi);  // Bottleneck! (due to exchange)
             } else {
-                a_phi.exchangeEnd();  // Bottleneck!
+                LayoutTools::exchangeEnd(a_phi);  // Bottleneck!
             }
 
             for (DataIterator dit(m_grids); dit.ok(); ++dit) {
@@ -268,6 +268,24 @@ StateOps<StateType, TraitsType>::createCoarsened(
 }
 
 
+// -----------------------------------------------------------------------------
+// Create a version of a_src over a_grids, which cover the same region
+// as a_src.getBoxes() but may be distributed differently.
+// You do not need to fill a_dest with data, just define it properly.
+// -----------------------------------------------------------------------------
+void
+StateOps<StateType, TraitsType>::createRedistributed(
+    StateType&       a_dest,
+    const StateType& a_src,
+    const GridsType& a_grids) const
+{
+    CH_assert(a_grids.physDomain() == a_src.getBoxes().physDomain());
+
+    a_dest.define(a_grids, a_src.nComp(), a_src.ghostVect());
+    debugInitLevel(a_dest);
+}
+
+
 // -----------------------------------------------------------------------------
 // Create a copier for a_rhs.copyTo(a_lhs).
 // If your StateType does not support copiers, leave the function empty.
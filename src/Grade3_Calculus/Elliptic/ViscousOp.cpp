@@ -1,5 +1,7 @@
 #include "ViscousOp.H"
+#include "LayoutTools.H"
 #include "ViscousOpF_F.H"
+#include "VertLineRelaxF_F.H"
 #include "Subspace.H"
 #include "Convert.H"
 #include "Debug.H"
@@ -27,7 +29,8 @@ ViscousOp::ViscousOp(const LevelGeometry*                        a_levGeoPtr,
                      const Real                                  a_alpha,
                      const Real                                  a_beta,
                      const LevelData<FArrayBox>&                 a_ccNu,
-                     const std::shared_ptr<BCTools::BCFunction>& a_bcFuncPtr)
+                     const std::shared_ptr<BCTools::BCFunction>& a_bcFuncPtr,
+                     const bool                                  a_useVertLineRelax)
 : m_alpha(a_alpha)
 , m_beta(a_beta)
 , m_domain(a_levGeoPtr->getDomain())
@@ -35,9 +38,12 @@ ViscousOp::ViscousOp(const LevelGeometry*                        a_levGeoPtr,
 , m_dXi(a_levGeoPtr->getDXi())
 , m_amrCrseDXi(D_DECL(quietNAN, quietNAN, quietNAN))
 , m_geoSrc(a_levGeoPtr->getGeoSource())
+, m_levGeoPtr(a_levGeoPtr)
+, m_useVertLineRelax(a_useVertLineRelax)
 , m_Jptr(new LevelData<FluxBox>(a_levGeoPtr->getBoxes(), 1, IntVect::Unit))
 , m_nuJgupPtr(new StaggeredFluxLD(a_levGeoPtr->getBoxes()))
 , m_invDiagsPtr(new LevelData<FluxBox>(a_levGeoPtr->getBoxes(), 1))
+, m_vertLineFactorsPtr()
 , m_bcFuncPtr(a_bcFuncPtr)
 , m_physBdryIter(a_levGeoPtr->getBoxes())
 // m_cfInterp
@@ -77,22 +83,64 @@ ViscousOp::ViscousOp(const LevelGeometry*                        a_levGeoPtr,
         }
     }
 
-    // Metric
+    // FC J
+    for (DataIterator dit(m_grids); dit.ok(); ++dit) {
+        for (int velComp = 0; velComp < SpaceDim; ++velComp) {
+            auto& destFAB = (*m_Jptr)[dit][velComp];
+            Convert::Simple(destFAB, a_levGeoPtr->getCCJ()[dit]);
+        }
+    }
+    BCTools::extrapAllGhosts(*m_Jptr, 2);
+    m_Jptr->exchange();
+    debugCheckValidFaceOverlap(*m_Jptr);
+
+    // Vertical line relaxation needs each box to span the vertical domain.
+    if (m_useVertLineRelax && !this->gridsAreSuitableForVertLines()) {
+        MAYDAYWARNING(
+            "ViscousOp: Grids are not suitable for vertical line relaxation. "
+            "Using GSRB instead. Try setting base.splitDirs = 1 1 0 in 3D or "
+            "1 0 in 2D.");
+        m_useVertLineRelax = false;
+    }
+
+    // nu*Jgup and diagonals, etc.
+    this->setCoefficients(a_alpha, a_beta, a_ccNu);
+
+    // CFInterp
+    if (a_levGeoPtr->getCrseGridsPtr()) {
+        m_cfInterp.define(*a_levGeoPtr, *a_levGeoPtr->getCrseGridsPtr());
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+ViscousOp::setAlphaAndBeta(const Real a_alpha, const Real a_beta)
+{
+    m_alpha = a_alpha;
+    m_beta  = a_beta;
+    this->cacheMatrixElements();
+}
+
+
+// -----------------------------------------------------------------------------
+void
+ViscousOp::setCoefficients(const Real                  a_alpha,
+                           const Real                  a_beta,
+                           const LevelData<FArrayBox>& a_ccNu)
+{
+    CH_assert(m_levGeoPtr);
+    CH_assert(a_ccNu.getBoxes().compatible(m_grids));
+
     for (DataIterator dit(m_grids); dit.ok(); ++dit) {
         const FArrayBox& ccNuFAB = a_ccNu[dit];
         checkForNAN(ccNuFAB, ccNuFAB.box());
 
         for (int velComp = 0; velComp < SpaceDim; ++velComp) {
-            // FC J
-            {
-                auto& destFAB = (*m_Jptr)[dit][velComp];
-                Convert::Simple(destFAB, a_levGeoPtr->getCCJ()[dit]);
-            }
-
             // CC nu*Jgup
             {
                 auto& destFAB = (*m_nuJgupPtr)[velComp][velComp][dit];
-                Convert::Simple(destFAB, a_levGeoPtr->getFCJgup()[dit][velComp]);
+                Convert::Simple(destFAB, m_levGeoPtr->getFCJgup()[dit][velComp]);
                 destFAB.mult(ccNuFAB);
             }
 
@@ -104,16 +152,12 @@ ViscousOp::ViscousOp(const LevelGeometry*                        a_levGeoPtr,
                                                  .surroundingNodes(derivDir);
 
                 auto& destFAB = (*m_nuJgupPtr)[velComp][derivDir][dit];
-                Convert::Simple(destFAB, a_levGeoPtr->getFCJgup()[dit][derivDir]);
+                Convert::Simple(destFAB, m_levGeoPtr->getFCJgup()[dit][derivDir]);
                 FABAlgebra::ECmultCC(destFAB, 0, ecRegion, ccNuFAB, 0);
             }
         }
     }
 
-    BCTools::extrapAllGhosts(*m_Jptr, 2);
-    m_Jptr->exchange();
-    debugCheckValidFaceOverlap(*m_Jptr);
-
     for (int velComp = 0; velComp < SpaceDim; ++velComp) {
         for (int derivDir = 0; derivDir < SpaceDim; ++derivDir) {
             BCTools::extrapAllGhosts((*m_nuJgupPtr)[velComp][derivDir], 2);
@@ -121,21 +165,6 @@ ViscousOp::ViscousOp(const LevelGeometry*                        a_levGeoPtr,
     }
     m_nuJgupPtr->exchange();
 
-
-    // Compute diagonals, etc.
-    this->cacheMatrixElements();
-
-    // CFInterp
-    if (a_levGeoPtr->getCrseGridsPtr()) {
-        m_cfInterp.define(*a_levGeoPtr, *a_levGeoPtr->getCrseGridsPtr());
-    }
-}
-
-
-// -----------------------------------------------------------------------------
-void
-ViscousOp::setAlphaAndBeta(const Real a_alpha, const Real a_beta)
-{
     m_alpha = a_alpha;
     m_beta  = a_beta;
     this->cacheMatrixElements();
@@ -230,12 +259,12 @@ ViscousOp::applyBCs(StateType&       a_vel,
     for (int d = 0; d < SpaceDim; ++d) {
         FABAliasFlBxDataFactory factory(&a_vel, Interval(0,0), d);
         alias[d].define(m_grids, 1, a_vel.ghostVect(), factory);
-        alias[d].exchangeBegin(m_exCopier[d]);
+        LayoutTools::exchangeBegin(alias[d], m_exCopier[d]);
     }
     // End valid exchange and exchange corner ghosts filled by BC-setting
     // functions(See StaggeredCopier::defineInvalidCornerExchange1 for details.)
     for (int d = 0; d < SpaceDim; ++d) {
-        alias[d].exchangeEnd();
+        LayoutTools::exchangeEnd(alias[d]);
         // alias[d].exchangeBegin(m_exCornerCopier1[d]);
     }
     // for (int d = 0; d < SpaceDim; ++d) {
@@ -347,8 +376,12 @@ ViscousOp::relax(StateType&       a_cor,
                  const Real       a_time,
                  const int        a_relaxIters) const
 {
-    // this->jacobi_relax(a_cor, a_res, a_time, a_relaxIters);
-    this->gsrb_relax(a_cor, a_res, a_time, a_relaxIters);
+    if (m_useVertLineRelax) {
+        this->vertLineGSRB_relax(a_cor, a_res, a_time, a_relaxIters);
+    } else {
+        // this->jacobi_relax(a_cor, a_res, a_time, a_relaxIters);
+        this->gsrb_relax(a_cor, a_res, a_time, a_relaxIters);
+    }
 }
 
 
@@ -537,7 +570,7 @@ ViscousOp::MGProlong(StateType&      a_finePhi,
         // const auto& crseViscousOp = static_cast<const ViscousOp&>(a_crseOp);
         // CH_verify(crseViscousOp.m_HOProlongCornerCopier.isDefined());
         // a_crseCor.exchange(crseViscousOp.m_HOProlongCornerCopier);
-        a_crseCor.exchange();
+        LayoutTools::exchange(a_crseCor);
 
         for (dit.reset(); dit.ok(); ++dit) {
             for (int velComp = 0; velComp < SpaceDim; ++velComp) {
@@ -665,9 +698,12 @@ ViscousOp::ViscousOp(const ViscousOp& a_srcOp)
 , m_dXi(a_srcOp.m_dXi)
 , m_amrCrseDXi(a_srcOp.m_amrCrseDXi)
 , m_geoSrc(a_srcOp.m_geoSrc)
+, m_levGeoPtr(a_srcOp.m_levGeoPtr)
+, m_useVertLineRelax(a_srcOp.m_useVertLineRelax)
 , m_Jptr(a_srcOp.m_Jptr)
 , m_nuJgupPtr(a_srcOp.m_nuJgupPtr)
 , m_invDiagsPtr(a_srcOp.m_invDiagsPtr)
+, m_vertLineFactorsPtr(a_srcOp.m_vertLineFactorsPtr)
 , m_bcFuncPtr(a_srcOp.m_bcFuncPtr)
 , m_physBdryIter(a_srcOp.m_physBdryIter)
 , m_cfRegion(a_srcOp.m_cfRegion)
@@ -697,9 +733,12 @@ ViscousOp::ViscousOp(const ViscousOp&         a_srcOp,
 , m_dXi(a_srcOp.m_dXi * a_refRatio)
 , m_amrCrseDXi(a_srcOp.m_amrCrseDXi)
 , m_geoSrc(a_srcOp.m_geoSrc)
+, m_levGeoPtr(nullptr)
+, m_useVertLineRelax(a_srcOp.m_useVertLineRelax)
 , m_Jptr(new LevelData<FluxBox>(a_crseGrids, 1, IntVect::Unit))
 , m_nuJgupPtr(new StaggeredFluxLD(a_crseGrids))
 , m_invDiagsPtr(new LevelData<FluxBox>(a_crseGrids, 1))
+, m_vertLineFactorsPtr()
 , m_bcFuncPtr(a_srcOp.m_bcFuncPtr)
 , m_physBdryIter(a_crseGrids)
 // , m_cfRegion(a_srcOp.m_cfRegion) // We will coarsen in the body!
@@ -828,6 +867,154 @@ ViscousOp::cacheMatrixElements()
 
     nanCheck(*m_invDiagsPtr);
     LayoutTools::averageOverlappingValidFaces(*m_invDiagsPtr);
+
+    if (!m_useVertLineRelax) return;
+
+    // The tridiagonal systems only change with the operator, so we factor
+    // them here and let vertLineGSRB_relax reuse the factors.
+    if (!m_vertLineFactorsPtr) {
+        m_vertLineFactorsPtr.reset(new LevelData<FluxBox>(m_grids, 3));
+    }
+
+    constexpr int vdir = SpaceDim - 1;
+
+    for (DataIterator dit(m_grids); dit.ok(); ++dit) {
+        const Box valid = m_grids[dit];
+
+        for (int velComp = 0; velComp < SpaceDim; ++velComp) {
+            FArrayBox&       facFAB      = (*m_vertLineFactorsPtr)[dit][velComp];
+            const FArrayBox& nuJgupzFAB  = (*m_nuJgupPtr)[velComp][vdir][dit];
+            const FArrayBox& invDiagsFAB = (*m_invDiagsPtr)[dit][velComp];
+
+            // We want to preserve the horizontal index to compute
+            // the red-black ordering.
+            const Box     region     = surroundingNodes(valid, velComp)
+                                     & m_interiorBox[velComp];
+            if (region.isEmpty()) continue;
+
+            const IntVect validShift = region.smallEnd(vdir) * BASISV(vdir);
+            const IntVect zShift     = (velComp == vdir)
+                                     ? validShift - BASISV(vdir)
+                                     : validShift;
+
+            FArrayBox lowerFAB(region, 1);
+            FArrayBox diagFAB(region, 1);
+            FArrayBox upperFAB(region, 1);
+
+            if constexpr (SpaceDim == 2) {
+                FORT_VERTLINERELAX_TRIDIAGSFC_2D(
+                    CHF_FRA_SHIFT(lowerFAB, validShift),
+                    CHF_FRA_SHIFT(diagFAB, validShift),
+                    CHF_FRA_SHIFT(upperFAB, validShift),
+                    CHF_CONST_FRA_SHIFT(nuJgupzFAB, zShift),
+                    CHF_CONST_FRA_SHIFT(invDiagsFAB, validShift),
+                    CHF_CONST_REAL(m_beta),
+                    CHF_CONST_REALVECT(m_dXi),
+                    CHF_BOX_SHIFT(region, validShift));
+            } else {
+                FORT_VERTLINERELAX_TRIDIAGSFC_3D(
+                    CHF_FRA_SHIFT(lowerFAB, validShift),
+                    CHF_FRA_SHIFT(diagFAB, validShift),
+                    CHF_FRA_SHIFT(upperFAB, validShift),
+                    CHF_CONST_FRA_SHIFT(nuJgupzFAB, zShift),
+                    CHF_CONST_FRA_SHIFT(invDiagsFAB, validShift),
+                    CHF_CONST_REAL(m_beta),
+                    CHF_CONST_REALVECT(m_dXi),
+                    CHF_BOX_SHIFT(region, validShift));
+            }
+
+            // The vertical velocity's boundary faces are set by applyBCs, so
+            // the line solves hold them fixed. The horizontal velocities have
+            // ghosts at the top and bottom, so we roll their BCs into the
+            // first and last rows.
+            if (velComp != vdir) {
+                FArrayBox      dummyFAB;
+                constexpr Real dummyTime = 0.0;
+                constexpr bool homogBCs  = true;
+
+                // The BC function needs the state's centering.
+                FArrayBox stateFAB(surroundingNodes(valid, velComp), 1);
+                stateFAB.setVal(quietNAN);
+
+                Box stateGhosts;
+                Box loBdry, hiBdry;
+                BCTools::getBoxesForApplyBC(
+                    loBdry, stateGhosts, stateFAB, valid, vdir, Side::Lo);
+                BCTools::getBoxesForApplyBC(
+                    hiBdry, stateGhosts, stateFAB, valid, vdir, Side::Hi);
+
+                FArrayBox loXFAB(loBdry, SpaceDim);
+                m_geoSrc.fill_physCoor(loXFAB, m_dXi);
+                FArrayBox loBCalphaFAB(loBdry, 1);
+                FArrayBox loBCbetaFAB(loBdry, 1);
+                (*m_bcFuncPtr)(loBCalphaFAB,
+                               loBCbetaFAB,
+                               dummyFAB,
+                               stateFAB,
+                               loXFAB,
+                               dit(),
+                               vdir,
+                               Side::Lo,
+                               dummyTime,
+                               homogBCs);
+
+                FArrayBox hiXFAB(hiBdry, SpaceDim);
+                m_geoSrc.fill_physCoor(hiXFAB, m_dXi);
+                FArrayBox hiBCalphaFAB(hiBdry, 1);
+                FArrayBox hiBCbetaFAB(hiBdry, 1);
+                (*m_bcFuncPtr)(hiBCalphaFAB,
+                               hiBCbetaFAB,
+                               dummyFAB,
+                               stateFAB,
+                               hiXFAB,
+                               dit(),
+                               vdir,
+                               Side::Hi,
+                               dummyTime,
+                               homogBCs);
+
+                if constexpr (SpaceDim == 2) {
+                    FORT_VERTLINERELAX_ROLLINBCS_2D(
+                        CHF_FRA_SHIFT(diagFAB, validShift),
+                        CHF_CONST_FRA_SHIFT(lowerFAB, validShift),
+                        CHF_CONST_FRA_SHIFT(upperFAB, validShift),
+                        CHF_CONST_FRA_SHIFT(loBCalphaFAB, validShift),
+                        CHF_CONST_FRA_SHIFT(loBCbetaFAB, validShift),
+                        CHF_CONST_FRA_SHIFT(hiBCalphaFAB, validShift),
+                        CHF_CONST_FRA_SHIFT(hiBCbetaFAB, validShift),
+                        CHF_CONST_REAL(m_dXi[vdir]),
+                        CHF_BOX_SHIFT(region, validShift));
+                } else {
+                    FORT_VERTLINERELAX_ROLLINBCS_3D(
+                        CHF_FRA_SHIFT(diagFAB, validShift),
+                        CHF_CONST_FRA_SHIFT(lowerFAB, validShift),
+                        CHF_CONST_FRA_SHIFT(upperFAB, validShift),
+                        CHF_CONST_FRA_SHIFT(loBCalphaFAB, validShift),
+                        CHF_CONST_FRA_SHIFT(loBCbetaFAB, validShift),
+                        CHF_CONST_FRA_SHIFT(hiBCalphaFAB, validShift),
+                        CHF_CONST_FRA_SHIFT(hiBCbetaFAB, validShift),
+                        CHF_CONST_REAL(m_dXi[vdir]),
+                        CHF_BOX_SHIFT(region, validShift));
+                }
+            }
+
+            if constexpr (SpaceDim == 2) {
+                FORT_VERTLINERELAX_FACTOR_2D(
+                    CHF_FRA_SHIFT(facFAB, validShift),
+                    CHF_CONST_FRA_SHIFT(lowerFAB, validShift),
+                    CHF_CONST_FRA_SHIFT(diagFAB, validShift),
+                    CHF_CONST_FRA_SHIFT(upperFAB, validShift),
+                    CHF_BOX_SHIFT(region, validShift));
+            } else {
+                FORT_VERTLINERELAX_FACTOR_3D(
+                    CHF_FRA_SHIFT(facFAB, validShift),
+                    CHF_CONST_FRA_SHIFT(lowerFAB, validShift),
+                    CHF_CONST_FRA_SHIFT(diagFAB, validShift),
+                    CHF_CONST_FRA_SHIFT(upperFAB, validShift),
+                    CHF_BOX_SHIFT(region, validShift));
+            }
+        }  // velComp
+    }  // dit
 }
 
 
@@ -914,7 +1101,7 @@ ViscousOp::gsrb_relax(StateType&       a_vel,
             if (whichPass == 0) {
                 this->applyBCs(a_vel, nullptr, a_time, true, true);
             } else {
-                a_vel.exchange();
+                LayoutTools::exchange(a_vel);
             }
 
             for (DataIterator dit(m_grids); dit.ok(); ++dit) {
@@ -959,5 +1146,117 @@ ViscousOp::gsrb_relax(StateType&       a_vel,
 }
 
 
+// -----------------------------------------------------------------------------
+void
+ViscousOp::vertLineGSRB_relax(StateType&       a_vel,
+                              const StateType& a_rhs,
+                              const Real       a_time,
+                              const int        a_iters) const
+{
+    if (a_iters == 0) return;
+
+    // The line solves reuse the factors built in cacheMatrixElements.
+    CH_assert(m_vertLineFactorsPtr);
+
+    constexpr int vdir = SpaceDim - 1;
+
+    for (int iter = 0; iter < a_iters; ++iter) {
+        for (int whichPass = 0; whichPass < 2; ++whichPass) {
+            // Bottleneck!
+            if (whichPass == 0) {
+                this->applyBCs(a_vel, nullptr, a_time, true, true);
+            } else {
+                LayoutTools::exchange(a_vel);
+            }
+
+            for (DataIterator dit(m_grids); dit.ok(); ++dit) {
+                for (int velComp = 0; velComp < SpaceDim; ++velComp) {
+                    FArrayBox&       velFAB = a_vel[dit][velComp];
+                    const FArrayBox& rhsFAB = a_rhs[dit][velComp];
+                    const FArrayBox& facFAB = (*m_vertLineFactorsPtr)[dit][velComp];
+
+                    // We want to preserve the horizontal index to compute
+                    // the red-black ordering.
+                    const Box     region     = m_grids[dit].surroundingNodes(velComp)
+                                             & m_interiorBox[velComp];
+                    if (region.isEmpty()) continue;
+
+                    const IntVect validShift = region.smallEnd(vdir) * BASISV(vdir);
+
+                    // The CC nu*Jgup is shifted so that all directions use
+                    // the FC stencil of VertLineRelax_HorizRHSFC.
+                    std::array<IntVect, SpaceDim> coefShift;
+                    for (int d = 0; d < SpaceDim; ++d) {
+                        coefShift[d] = (d == velComp)
+                                     ? validShift - BASISV(d)
+                                     : validShift;
+                    }
+                    const FArrayBox& nuJgupxFAB = (*m_nuJgupPtr)[velComp][0][dit];
+                    const FArrayBox& nuJgupyFAB = (*m_nuJgupPtr)[velComp][1][dit]; // Not used in 2D
+                    const FArrayBox& nuJgupzFAB = (*m_nuJgupPtr)[velComp][vdir][dit];
+
+                    // The vertical velocity's boundary faces are held fixed.
+                    const int lagVertBCs = (velComp == vdir ? 1 : 0);
+
+                    if constexpr (SpaceDim == 2) {
+                        FORT_VERTLINERELAX_HORIZRHSFC_2D(
+                            CHF_FRA_SHIFT(velFAB, validShift),
+                            CHF_CONST_FRA_SHIFT(rhsFAB, validShift),
+                            CHF_CONST_FRA_SHIFT(nuJgupxFAB, coefShift[0]),
+                            CHF_CONST_FRA_SHIFT(nuJgupzFAB, coefShift[vdir]),
+                            CHF_CONST_REAL(m_beta),
+                            CHF_CONST_REALVECT(m_dXi),
+                            CHF_BOX_SHIFT(region, validShift),
+                            CHF_CONST_INT(whichPass),
+                            CHF_CONST_INT(lagVertBCs));
+
+                        FORT_VERTLINERELAX_SOLVE_2D(
+                            CHF_FRA_SHIFT(velFAB, validShift),
+                            CHF_CONST_FRA_SHIFT(facFAB, validShift),
+                            CHF_BOX_SHIFT(region, validShift),
+                            CHF_CONST_INT(whichPass));
+                    } else {
+                        FORT_VERTLINERELAX_HORIZRHSFC_3D(
+                            CHF_FRA_SHIFT(velFAB, validShift),
+                            CHF_CONST_FRA_SHIFT(rhsFAB, validShift),
+                            CHF_CONST_FRA_SHIFT(nuJgupxFAB, coefShift[0]),
+                            CHF_CONST_FRA_SHIFT(nuJgupyFAB, coefShift[1]),
+                            CHF_CONST_FRA_SHIFT(nuJgupzFAB, coefShift[vdir]),
+                            CHF_CONST_REAL(m_beta),
+                            CHF_CONST_REALVECT(m_dXi),
+                            CHF_BOX_SHIFT(region, validShift),
+                            CHF_CONST_INT(whichPass),
+                            CHF_CONST_INT(lagVertBCs));
+
+                        FORT_VERTLINERELAX_SOLVE_3D(
+                            CHF_FRA_SHIFT(velFAB, validShift),
+                            CHF_CONST_FRA_SHIFT(facFAB, validShift),
+                            CHF_BOX_SHIFT(region, validShift),
+                            CHF_CONST_INT(whichPass));
+                    }
+                } // velComp
+            }  // dit
+        } // whichPass (red or black)
+    } // iter
+}
+
+
+// -----------------------------------------------------------------------------
+bool
+ViscousOp::gridsAreSuitableForVertLines() const
+{
+    constexpr int vdir = SpaceDim - 1;
+    if (m_domain.isPeriodic(vdir)) return false;
+
+    const Box& domBox = m_domain.domainBox();
+    for (LayoutIterator lit = m_grids.layoutIterator(); lit.ok(); ++lit) {
+        const Box& valid = m_grids[lit];
+        if (valid.smallEnd(vdir) != domBox.smallEnd(vdir)) return false;
+        if (valid.bigEnd(vdir) != domBox.bigEnd(vdir)) return false;
+    }
+    return true;
+}
+
+
 
 }; // end namespace Elliptic
@@ -0,0 +1,1187 @@
+/*******************************************************************************
+ *  SOMAR - Stratified Ocean Model with Adaptive Refinement
+ *  Developed by Ed Santilli & Alberto Scotti
+ *  Copyright (C) 2024 Thomas Jefferson University and Arizona State University
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ *
+ *  For up-to-date contact information, please visit the repository homepage,
+ *  https://github.com/MUON-CFD/SOMAR.
+ ******************************************************************************/
+#include "HDF5Checkpoint.H"
+
+#ifdef SOMAR_USE_HDF5
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include "SPMD.H"
+#include "MayDay.H"
+#include "Debug.H"
+
+
+// ============================ Local utilities ================================
+
+namespace {
+
+// Python's hash of a tuple of small ints (CPython >= 3.8, 64-bit).
+long long
+pyTupleHash(const std::vector<long long>& a_items)
+{
+    constexpr uint64_t prime1 = 11400714785074694791ULL;
+    constexpr uint64_t prime2 = 14029467366897019727ULL;
+    constexpr uint64_t prime5 = 2870177450012600261ULL;
+
+    uint64_t acc = prime5;
+    for (const long long item : a_items) {
+        // hash(-1) == -2 in Python. All other small ints hash to themselves.
+        const uint64_t lane = static_cast<uint64_t>(item == -1 ? -2 : item);
+        acc += lane * prime2;
+        acc = (acc << 31) | (acc >> 33);
+        acc *= prime1;
+    }
+    acc += static_cast<uint64_t>(a_items.size()) ^ (prime5 ^ 3527539ULL);
+
+    if (acc == static_cast<uint64_t>(-1)) return 1546275796;
+    return static_cast<long long>(acc);
+}
+
+
+// The compound types below mimic SomarIO.WriteCheckPoint.Transmogrify,
+// including its extra padding word.
+hid_t
+createIntVectType()
+{
+    const char* names[] = {"intvecti", "intvectj", "intvectk"};
+    hid_t type = H5Tcreate(H5T_COMPOUND, (SpaceDim + 1) * sizeof(int));
+    for (int d = 0; d < SpaceDim; ++d) {
+        H5Tinsert(type, names[d], d * sizeof(int), H5T_NATIVE_INT);
+    }
+    return type;
+}
+
+hid_t
+createRealVectType()
+{
+    const char* names[] = {"x", "y", "z"};
+    hid_t type = H5Tcreate(H5T_COMPOUND, (SpaceDim + 1) * sizeof(double));
+    for (int d = 0; d < SpaceDim; ++d) {
+        H5Tinsert(type, names[d], d * sizeof(double), H5T_NATIVE_DOUBLE);
+    }
+    return type;
+}
+
+hid_t
+createBoxType()
+{
+    const char* names[] = {"lo_i", "lo_j", "lo_k", "hi_i", "hi_j", "hi_k"};
+    hid_t type = H5Tcreate(H5T_COMPOUND, (2 * SpaceDim + 1) * sizeof(int));
+
+    // The Python readers unpack a Box with tuple(), which follows the order
+    // the members were inserted, so all lo's must come before the hi's.
+    for (int d = 0; d < SpaceDim; ++d) {
+        H5Tinsert(type, names[d], d * sizeof(int), H5T_NATIVE_INT);
+    }
+    for (int d = 0; d < SpaceDim; ++d) {
+        H5Tinsert(type, names[3 + d], (SpaceDim + d) * sizeof(int),
+                  H5T_NATIVE_INT);
+    }
+    return type;
+}
+
+// Fixed-length string, as h5py stores np.bytes_.
+hid_t
+createStringType(const std::string& a_str)
+{
+    hid_t type = H5Tcopy(H5T_C_S1);
+    H5Tset_size(type, std::max<size_t>(a_str.size(), 1));
+    H5Tset_strpad(type, H5T_STR_NULLPAD);
+    return type;
+}
+
+// Writes a scalar attribute, replacing any existing one.
+void
+writeAttribute(hid_t              a_locID,
+               const std::string& a_key,
+               hid_t              a_type,
+               const void*        a_valPtr)
+{
+    if (H5Aexists(a_locID, a_key.c_str()) > 0) {
+        H5Adelete(a_locID, a_key.c_str());
+    }
+
+    hid_t space = H5Screate(H5S_SCALAR);
+    hid_t attr  = H5Acreate2(
+        a_locID, a_key.c_str(), a_type, space, H5P_DEFAULT, H5P_DEFAULT);
+    if (attr < 0) {
+        MAYDAYERROR("Could not create attribute " << a_key);
+    }
+    H5Awrite(attr, a_type, a_valPtr);
+    H5Aclose(attr);
+    H5Sclose(space);
+}
+
+void
+writeAttribute(hid_t a_locID, const std::string& a_key, const IntVect& a_val)
+{
+    int buf[SpaceDim + 1] = {0};
+    for (int d = 0; d < SpaceDim; ++d) buf[d] = a_val[d];
+
+    hid_t type = createIntVectType();
+    writeAttribute(a_locID, a_key, type, buf);
+    H5Tclose(type);
+}
+
+void
+writeAttribute(hid_t a_locID, const std::string& a_key, const std::string& a_val)
+{
+    const std::string padded = (a_val.empty() ? std::string(1, '\0') : a_val);
+
+    hid_t type = createStringType(a_val);
+    writeAttribute(a_locID, a_key, type, padded.c_str());
+    H5Tclose(type);
+}
+
+};  // namespace
+
+
+// ======================== Construction / destruction =========================
+
+// -----------------------------------------------------------------------------
+HDF5CheckpointWriter::HDF5CheckpointWriter(const std::string& a_fileName)
+: m_fileName(a_fileName)
+, m_fileID(-1)
+#ifdef CH_MPI
+, m_comm(Chombo_MPI::comm)
+#endif
+{
+    hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+
+#ifdef CH_MPI
+#   ifdef H5_HAVE_PARALLEL
+    H5Pset_fapl_mpio(fapl, Chombo_MPI::comm, MPI_INFO_NULL);
+#   else
+    if (numProc() > 1) {
+        MAYDAYERROR("HDF5CheckpointWriter needs a parallel HDF5 library when "
+                    "running on more than one rank.");
+    }
+#   endif
+#endif
+
+    this->create(fapl);
+    H5Pclose(fapl);
+}
+
+
+#ifdef CH_MPI
+// -----------------------------------------------------------------------------
+HDF5CheckpointWriter::HDF5CheckpointWriter(const std::string& a_fileName,
+                                           MPI_Comm           a_comm)
+: m_fileName(a_fileName)
+, m_fileID(-1)
+, m_comm(a_comm)
+{
+    hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+
+#   ifdef H5_HAVE_PARALLEL
+    H5Pset_fapl_mpio(fapl, a_comm, MPI_INFO_NULL);
+#   else
+    int commSize = 1;
+    MPI_Comm_size(a_comm, &commSize);
+    if (commSize > 1) {
+        MAYDAYERROR("HDF5CheckpointWriter needs a parallel HDF5 library when "
+                    "running on more than one rank.");
+    }
+#   endif
+
+    this->create(fapl);
+    H5Pclose(fapl);
+}
+#endif
+
+
+// -----------------------------------------------------------------------------
+void
+HDF5CheckpointWriter::create(hid_t a_fapl)
+{
+#if defined(CH_MPI) && defined(H5_HAVE_PARALLEL) && H5_VERSION_GE(1, 10, 0)
+    // Every rank issues identical metadata calls, so let one rank do the I/O.
+    H5Pset_all_coll_metadata_ops(a_fapl, true);
+    H5Pset_coll_metadata_write(a_fapl, true);
+#endif
+
+    m_fileID = H5Fcreate(m_fileName.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, a_fapl);
+    if (m_fileID < 0) {
+        MAYDAYERROR("Could not create " << m_fileName);
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+HDF5CheckpointWriter::~HDF5CheckpointWriter()
+{
+    if (m_fileID >= 0) {
+        H5Fclose(m_fileID);
+    }
+}
+
+
+// ================================ Utilities ==================================
+
+// -----------------------------------------------------------------------------
+std::string
+HDF5CheckpointWriter::boxTag(const IntVect& a_lo)
+{
+    std::vector<long long> items(SpaceDim);
+    for (int d = 0; d < SpaceDim; ++d) items[d] = a_lo[d];
+    return std::to_string(pyTupleHash(items));
+}
+
+
+// -----------------------------------------------------------------------------
+std::string
+HDF5CheckpointWriter::boxTag(const IntVect& a_lo, const int a_dir)
+{
+    std::vector<long long> items(SpaceDim + 1);
+    for (int d = 0; d < SpaceDim; ++d) items[d] = a_lo[d];
+    items[SpaceDim] = a_dir;
+    return std::to_string(pyTupleHash(items));
+}
+
+
+// -----------------------------------------------------------------------------
+hid_t
+HDF5CheckpointWriter::openGroup(const std::string& a_groupName)
+{
+    if (a_groupName.empty() || a_groupName == "/") {
+        return H5Gopen2(m_fileID, "/", H5P_DEFAULT);
+    }
+
+    if (H5Lexists(m_fileID, a_groupName.c_str(), H5P_DEFAULT) > 0) {
+        return H5Gopen2(m_fileID, a_groupName.c_str(), H5P_DEFAULT);
+    }
+
+    hid_t groupID = H5Gcreate2(
+        m_fileID, a_groupName.c_str(), H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    if (groupID < 0) {
+        MAYDAYERROR("Could not create group " << a_groupName << " in "
+                    << m_fileName);
+    }
+    return groupID;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+HDF5CheckpointWriter::packFAB(std::vector<Real>& a_buf, const FArrayBox& a_fab)
+{
+    const Box&    region   = a_fab.box();
+    const IntVect n        = region.size();
+    const int     numComps = a_fab.nComp();
+    const long    numPts   = region.numPts();
+
+    // Chombo stores x fastest and comps slowest. numpy's C order, which the
+    // Python readers expect, has the comp index fastest and x slowest.
+    long dstStride[SpaceDim];
+    {
+        long s = numComps;
+        for (int d = SpaceDim - 1; d >= 0; --d) {
+            dstStride[d] = s;
+            s *= n[d];
+        }
+    }
+
+    a_buf.resize(numPts * numComps);
+    const long numRows = numPts / n[0];
+
+    for (int comp = 0; comp < numComps; ++comp) {
+        const Real* srcPtr = a_fab.dataPtr(comp);
+        Real*       dstPtr = a_buf.data() + comp;
+
+        for (long row = 0; row < numRows; ++row) {
+            long offset = 0;
+            long r      = row;
+            for (int d = 1; d < SpaceDim; ++d) {
+                offset += (r % n[d]) * dstStride[d];
+                r /= n[d];
+            }
+
+            const Real* srcRow = srcPtr + row * n[0];
+            Real*       dstRow = dstPtr + offset;
+            for (int i = 0; i < n[0]; ++i) {
+                dstRow[i * dstStride[0]] = srcRow[i];
+            }
+        }
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+hid_t
+HDF5CheckpointWriter::createCollectiveXfer()
+{
+    hid_t xfer = H5Pcreate(H5P_DATASET_XFER);
+#if defined(CH_MPI) && defined(H5_HAVE_PARALLEL)
+    H5Pset_dxpl_mpio(xfer, H5FD_MPIO_COLLECTIVE);
+#endif
+    return xfer;
+}
+
+
+// ================================= Writers ===================================
+
+// -----------------------------------------------------------------------------
+void
+HDF5CheckpointWriter::writeHeader(const HeaderData&  a_header,
+                                  const std::string& a_groupName)
+{
+    hid_t groupID = this->openGroup(a_groupName);
+
+    for (const auto& kv : a_header.m_int) {
+        const int val = kv.second;
+        writeAttribute(groupID, kv.first, H5T_NATIVE_INT, &val);
+    }
+
+    for (const auto& kv : a_header.m_real) {
+        const double val = kv.second;
+        writeAttribute(groupID, kv.first, H5T_NATIVE_DOUBLE, &val);
+    }
+
+    for (const auto& kv : a_header.m_string) {
+        writeAttribute(groupID, kv.first, kv.second);
+    }
+
+    for (const auto& kv : a_header.m_intvect) {
+        writeAttribute(groupID, kv.first, kv.second);
+    }
+
+    if (!a_header.m_realvect.empty()) {
+        hid_t type = createRealVectType();
+        for (const auto& kv : a_header.m_realvect) {
+            double buf[SpaceDim + 1] = {0.0};
+            for (int d = 0; d < SpaceDim; ++d) buf[d] = kv.second[d];
+            writeAttribute(groupID, kv.first, type, buf);
+        }
+        H5Tclose(type);
+    }
+
+    if (!a_header.m_box.empty()) {
+        hid_t type = createBoxType();
+        for (const auto& kv : a_header.m_box) {
+            int buf[2 * SpaceDim + 1] = {0};
+            for (int d = 0; d < SpaceDim; ++d) {
+                buf[d]            = kv.second.smallEnd(d);
+                buf[SpaceDim + d] = kv.second.bigEnd(d);
+            }
+            writeAttribute(groupID, kv.first, type, buf);
+        }
+        H5Tclose(type);
+    }
+
+    H5Gclose(groupID);
+}
+
+
+// -----------------------------------------------------------------------------
+void
+HDF5CheckpointWriter::writeBoxLayout(hid_t                    a_groupID,
+                                     const DisjointBoxLayout& a_grids)
+{
+    if (H5Lexists(a_groupID, "boxes", H5P_DEFAULT) > 0) return;
+
+    const hsize_t numBoxes = a_grids.size();
+
+    std::vector<int>     boxBuf((2 * SpaceDim + 1) * numBoxes, 0);
+    std::vector<int64_t> procBuf(numBoxes);
+    {
+        size_t idx = 0;
+        for (LayoutIterator lit = a_grids.layoutIterator(); lit.ok(); ++lit) {
+            const Box& b   = a_grids[lit];
+            int*       dst = &boxBuf[(2 * SpaceDim + 1) * idx];
+            for (int d = 0; d < SpaceDim; ++d) {
+                dst[d]            = b.smallEnd(d);
+                dst[SpaceDim + d] = b.bigEnd(d);
+            }
+            procBuf[idx] = a_grids.procID(lit());
+            ++idx;
+        }
+    }
+
+    // All ranks hold the same layout. Let rank 0 write the values.
+    hid_t xfer = createCollectiveXfer();
+
+    hid_t fileSpace = H5Screate_simple(1, &numBoxes, nullptr);
+    hid_t memSpace  = H5Scopy(fileSpace);
+    if (procID() != 0) {
+        H5Sselect_none(fileSpace);
+        H5Sselect_none(memSpace);
+    }
+
+    {
+        hid_t type = createBoxType();
+        hid_t dset = H5Dcreate2(a_groupID, "boxes", type, fileSpace,
+                                H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        H5Dwrite(dset, type, memSpace, fileSpace, xfer, boxBuf.data());
+        H5Dclose(dset);
+        H5Tclose(type);
+    }
+    {
+        hid_t dset = H5Dcreate2(a_groupID, "Processors", H5T_STD_I64LE,
+                                fileSpace, H5P_DEFAULT, H5P_DEFAULT,
+                                H5P_DEFAULT);
+        H5Dwrite(dset, H5T_NATIVE_INT64, memSpace, fileSpace, xfer,
+                 procBuf.data());
+
+        // Lets the reader decide if this distribution can be reused.
+        const int numRanks = numProc();
+        writeAttribute(dset, "numRanks", H5T_NATIVE_INT, &numRanks);
+        H5Dclose(dset);
+    }
+
+    H5Sclose(memSpace);
+    H5Sclose(fileSpace);
+    H5Pclose(xfer);
+}
+
+
+// -----------------------------------------------------------------------------
+void
+HDF5CheckpointWriter::writeDataAttributes(hid_t              a_groupID,
+                                          const std::string& a_name,
+                                          const int          a_numComps,
+                                          const IntVect&     a_ghost,
+                                          const std::string& a_objectType)
+{
+    const std::string attrGroupName = a_name + "_attributes";
+
+    hid_t attrGroupID;
+    if (H5Lexists(a_groupID, attrGroupName.c_str(), H5P_DEFAULT) > 0) {
+        attrGroupID = H5Gopen2(a_groupID, attrGroupName.c_str(), H5P_DEFAULT);
+    } else {
+        attrGroupID = H5Gcreate2(a_groupID, attrGroupName.c_str(), H5P_DEFAULT,
+                                 H5P_DEFAULT, H5P_DEFAULT);
+    }
+
+    writeAttribute(attrGroupID, "comps", H5T_NATIVE_INT, &a_numComps);
+    writeAttribute(attrGroupID, "ghost", a_ghost);
+    writeAttribute(attrGroupID, "outputGhost", a_ghost);
+    writeAttribute(attrGroupID, "objectType", a_objectType);
+
+    H5Gclose(attrGroupID);
+}
+
+
+// -----------------------------------------------------------------------------
+void
+HDF5CheckpointWriter::writeDatasets(hid_t                          a_groupID,
+                                    const std::vector<BoxDataset>& a_datasets,
+                                    const int                      a_numComps)
+{
+    const size_t numDatasets = a_datasets.size();
+
+    std::vector<hid_t> dsetIDs(numDatasets, -1);
+    std::vector<hid_t> spaceIDs(numDatasets, -1);
+
+    // Dataset creation is collective. Every rank creates every dataset.
+    for (size_t idx = 0; idx < numDatasets; ++idx) {
+        const BoxDataset& ds = a_datasets[idx];
+        CH_assert(!ds.fabPtr || ds.fabPtr->box() == ds.region);
+
+        hsize_t dims[SpaceDim + 1];
+        for (int d = 0; d < SpaceDim; ++d) dims[d] = ds.region.size(d);
+        dims[SpaceDim] = a_numComps;
+
+        spaceIDs[idx] = H5Screate_simple(SpaceDim + 1, dims, nullptr);
+        if (H5Lexists(a_groupID, ds.name.c_str(), H5P_DEFAULT) > 0) {
+            dsetIDs[idx] = H5Dopen2(a_groupID, ds.name.c_str(), H5P_DEFAULT);
+        } else {
+            dsetIDs[idx] = H5Dcreate2(a_groupID, ds.name.c_str(),
+                                      H5T_IEEE_F64LE, spaceIDs[idx],
+                                      H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+        }
+        if (dsetIDs[idx] < 0) {
+            MAYDAYERROR("Could not create dataset " << ds.name << " in "
+                        << m_fileName);
+        }
+    }
+
+    // Reorder the local data.
+    std::vector<std::vector<Real>> bufs(numDatasets);
+    for (size_t idx = 0; idx < numDatasets; ++idx) {
+        if (a_datasets[idx].fabPtr) {
+            packFAB(bufs[idx], *a_datasets[idx].fabPtr);
+        }
+    }
+
+#if defined(CH_MPI) && defined(H5_HAVE_PARALLEL) && H5_VERSION_GE(1, 14, 0)
+    {
+        // One collective write for the whole LevelData. Remote boxes
+        // contribute empty selections.
+        static const Real dummy = 0.0;
+
+        std::vector<hid_t>       memTypes(numDatasets, H5T_NATIVE_DOUBLE);
+        std::vector<hid_t>       memSpaces(numDatasets);
+        std::vector<const void*> bufPtrs(numDatasets);
+
+        for (size_t idx = 0; idx < numDatasets; ++idx) {
+            memSpaces[idx] = H5Scopy(spaceIDs[idx]);
+            if (a_datasets[idx].fabPtr) {
+                bufPtrs[idx] = bufs[idx].data();
+            } else {
+                H5Sselect_none(spaceIDs[idx]);
+                H5Sselect_none(memSpaces[idx]);
+                bufPtrs[idx] = &dummy;
+            }
+        }
+
+        hid_t xfer = createCollectiveXfer();
+        if (numDatasets > 0) {
+            H5Dwrite_multi(numDatasets, dsetIDs.data(), memTypes.data(),
+                           memSpaces.data(), spaceIDs.data(), xfer,
+                           bufPtrs.data());
+        }
+        H5Pclose(xfer);
+
+        for (hid_t space : memSpaces) H5Sclose(space);
+    }
+#else
+    // Each rank writes its own boxes independently.
+    for (size_t idx = 0; idx < numDatasets; ++idx) {
+        if (!a_datasets[idx].fabPtr) continue;
+        H5Dwrite(dsetIDs[idx], H5T_NATIVE_DOUBLE, H5S_ALL, H5S_ALL,
+                 H5P_DEFAULT, bufs[idx].data());
+    }
+#endif
+
+    for (size_t idx = 0; idx < numDatasets; ++idx) {
+        H5Dclose(dsetIDs[idx]);
+        H5Sclose(spaceIDs[idx]);
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+HDF5CheckpointWriter::write(const LevelData<FArrayBox>& a_data,
+                            const std::string&          a_groupName,
+                            const std::string&          a_name,
+                            const IntVect&              a_ghost)
+{
+    const DisjointBoxLayout& grids = a_data.getBoxes();
+
+    std::vector<const FArrayBox*> localFabPtrs(grids.size(), nullptr);
+    for (DataIterator dit(grids); dit.ok(); ++dit) {
+        localFabPtrs[dit().intCode()] = &a_data[dit];
+    }
+
+    std::vector<BoxDataset> datasets;
+    datasets.reserve(grids.size());
+    for (LayoutIterator lit = grids.layoutIterator(); lit.ok(); ++lit) {
+        const Box& valid = grids[lit];
+        datasets.push_back({a_name + boxTag(valid.smallEnd()),
+                            grow(valid, a_data.ghostVect()),
+                            localFabPtrs[lit().intCode()]});
+    }
+
+    hid_t groupID = this->openGroup(a_groupName);
+    this->writeBoxLayout(groupID, grids);
+    this->writeDataAttributes(
+        groupID, a_name, a_data.nComp(), a_ghost, "FArrayBox");
+    this->writeDatasets(groupID, datasets, a_data.nComp());
+    H5Gclose(groupID);
+}
+
+
+// -----------------------------------------------------------------------------
+void
+HDF5CheckpointWriter::write(const LevelData<FluxBox>& a_data,
+                            const std::string&        a_groupName,
+                            const std::string&        a_name,
+                            const IntVect&            a_ghost)
+{
+    const DisjointBoxLayout& grids = a_data.getBoxes();
+
+    std::vector<const FluxBox*> localFluxPtrs(grids.size(), nullptr);
+    for (DataIterator dit(grids); dit.ok(); ++dit) {
+        localFluxPtrs[dit().intCode()] = &a_data[dit];
+    }
+
+    std::vector<BoxDataset> datasets;
+    datasets.reserve(SpaceDim * grids.size());
+    for (LayoutIterator lit = grids.layoutIterator(); lit.ok(); ++lit) {
+        const Box&     valid    = grids[lit];
+        const FluxBox* fluxPtr  = localFluxPtrs[lit().intCode()];
+        const Box      ccRegion = grow(valid, a_data.ghostVect());
+
+        for (int dir = 0; dir < SpaceDim; ++dir) {
+            datasets.push_back({a_name + boxTag(valid.smallEnd(), dir),
+                                surroundingNodes(ccRegion, dir),
+                                (fluxPtr ? &(*fluxPtr)[dir] : nullptr)});
+        }
+    }
+
+    // The Python writer labels FluxBoxes as "unknown".
+    hid_t groupID = this->openGroup(a_groupName);
+    this->writeBoxLayout(groupID, grids);
+    this->writeDataAttributes(
+        groupID, a_name, a_data.nComp(), a_ghost, "unknown");
+    this->writeDatasets(groupID, datasets, a_data.nComp());
+    H5Gclose(groupID);
+}
+
+
+
+// ============================= HDF5PlotWriter ================================
+
+// -----------------------------------------------------------------------------
+void
+HDF5PlotWriter::write(const LevelData<FArrayBox>& a_data,
+                      const std::string&          a_groupName,
+                      const std::string&          a_name,
+                      const IntVect&              a_ghost)
+{
+    CH_assert(a_ghost <= a_data.ghostVect());
+
+    const auto startTime = std::chrono::steady_clock::now();
+
+    const DisjointBoxLayout& grids    = a_data.getBoxes();
+    const int                numComps = a_data.nComp();
+    const size_t             numBoxes = grids.size();
+
+    std::vector<const FArrayBox*> localFabPtrs(numBoxes, nullptr);
+    for (DataIterator dit(grids); dit.ok(); ++dit) {
+        localFabPtrs[dit().intCode()] = &a_data[dit];
+    }
+
+    // Block idx of the flattened data spans [offsets[idx], offsets[idx+1]).
+    std::vector<Box>     regions(numBoxes);
+    std::vector<int64_t> offsets(numBoxes + 1, 0);
+    hsize_t              maxBlockSize = 0;
+    {
+        size_t idx = 0;
+        for (LayoutIterator lit = grids.layoutIterator(); lit.ok(); ++lit) {
+            regions[idx]     = grow(grids[lit], a_ghost);
+            offsets[idx + 1] = offsets[idx] + numComps * regions[idx].numPts();
+            maxBlockSize     = std::max<hsize_t>(maxBlockSize,
+                                                 offsets[idx + 1] - offsets[idx]);
+            ++idx;
+        }
+    }
+
+    // Gather the local blocks, in file order, and select them in the file.
+    const hsize_t totalSize = offsets.back();
+    hid_t         fileSpace = H5Screate_simple(1, &totalSize, nullptr);
+    H5Sselect_none(fileSpace);
+
+    std::vector<Real> buf;
+    {
+        size_t localSize = 0;
+        for (size_t idx = 0; idx < numBoxes; ++idx) {
+            if (localFabPtrs[idx]) localSize += offsets[idx + 1] - offsets[idx];
+        }
+        buf.resize(std::max<size_t>(localSize, 1));
+
+        size_t pos = 0;
+        for (size_t idx = 0; idx < numBoxes; ++idx) {
+            if (!localFabPtrs[idx]) continue;
+
+            FArrayBox blockFAB(regions[idx], numComps, buf.data() + pos);
+            blockFAB.copy(*localFabPtrs[idx], regions[idx]);
+
+            const hsize_t start = offsets[idx];
+            const hsize_t count = offsets[idx + 1] - offsets[idx];
+            H5Sselect_hyperslab(
+                fileSpace, H5S_SELECT_OR, &start, nullptr, &count, nullptr);
+            pos += count;
+        }
+    }
+
+    // Bound the error of each comp. The float32 rounding is measured.
+    // The scale-offset filter adds at most half a unit in the last digit.
+    std::vector<Real> maxError(numComps, 0.0);
+    if (m_singlePrecision) {
+        size_t pos = 0;
+        for (size_t idx = 0; idx < numBoxes; ++idx) {
+            if (!localFabPtrs[idx]) continue;
+
+            const size_t numPts = regions[idx].numPts();
+            for (int comp = 0; comp < numComps; ++comp) {
+                Real& err = maxError[comp];
+                for (size_t n = 0; n < numPts; ++n, ++pos) {
+                    const Real x = buf[pos];
+                    err = std::max(err, std::abs(x - Real(float(x))));
+                }
+            }
+        }
+    }
+#ifdef CH_MPI
+    MPI_Allreduce(MPI_IN_PLACE, maxError.data(), numComps, MPI_CH_REAL,
+                  MPI_MAX, m_comm);
+#endif
+    if (m_compression.decimalDigits >= 0) {
+        const Real bound = 0.5 * std::pow(10.0, -m_compression.decimalDigits);
+        for (Real& err : maxError) err += bound;
+    }
+
+    const hsize_t bufSize  = buf.size();
+    hid_t         memSpace = H5Screate_simple(1, &bufSize, nullptr);
+    if (H5Sget_select_npoints(fileSpace) == 0) {
+        H5Sselect_none(memSpace);
+    }
+
+    hid_t groupID = this->openGroup(a_groupName);
+    this->writeBoxLayout(groupID, grids);
+    this->writeDataAttributes(groupID, a_name, numComps, a_ghost, "FArrayBox");
+
+    hid_t xfer = createCollectiveXfer();
+    {
+        const std::string dsetName = a_name + ":datatype=0";
+        const hid_t fileType =
+            (m_singlePrecision ? H5T_IEEE_F32LE : H5T_IEEE_F64LE);
+        hid_t dcpl = this->createDataProps(totalSize, maxBlockSize);
+
+        hid_t dset = H5Dcreate2(groupID, dsetName.c_str(), fileType,
+                                fileSpace, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+        H5Pclose(dcpl);
+        if (dset < 0) {
+            MAYDAYERROR("Could not create dataset " << dsetName << " in "
+                        << m_fileName);
+        }
+
+        if (m_singlePrecision) {
+            // Convert here rather than in H5Dwrite. A type conversion in the
+            // library would break the collective write.
+            std::vector<float> fbuf(buf.begin(), buf.end());
+            buf = std::vector<Real>();
+
+            H5Dwrite(dset, H5T_NATIVE_FLOAT, memSpace, fileSpace, xfer,
+                     fbuf.data());
+        } else {
+            H5Dwrite(dset, H5T_NATIVE_DOUBLE, memSpace, fileSpace, xfer,
+                     buf.data());
+        }
+        H5Dclose(dset);
+    }
+    {
+        // All ranks hold the same offsets. Let rank 0 write them.
+        const hsize_t numOffsets = offsets.size();
+        hid_t offSpace    = H5Screate_simple(1, &numOffsets, nullptr);
+        hid_t offMemSpace = H5Scopy(offSpace);
+        if (procID() != 0) {
+            H5Sselect_none(offSpace);
+            H5Sselect_none(offMemSpace);
+        }
+
+        const std::string dsetName = a_name + ":offsets=0";
+        hid_t dset = H5Dcreate2(groupID, dsetName.c_str(), H5T_STD_I64LE,
+                                offSpace, H5P_DEFAULT, H5P_DEFAULT,
+                                H5P_DEFAULT);
+        H5Dwrite(dset, H5T_NATIVE_INT64, offMemSpace, offSpace, xfer,
+                 offsets.data());
+        H5Dclose(dset);
+        H5Sclose(offMemSpace);
+        H5Sclose(offSpace);
+    }
+    H5Pclose(xfer);
+
+    H5Sclose(memSpace);
+    H5Sclose(fileSpace);
+    H5Gclose(groupID);
+
+    // Update the stats.
+    Real seconds = std::chrono::duration<Real>(
+        std::chrono::steady_clock::now() - startTime).count();
+#ifdef CH_MPI
+    MPI_Allreduce(MPI_IN_PLACE, &seconds, 1, MPI_CH_REAL, MPI_MAX, m_comm);
+#endif
+    m_stats.rawBytes += Real(totalSize) * sizeof(Real);
+    m_stats.seconds  += seconds;
+    if (m_stats.maxError.size() < maxError.size()) {
+        m_stats.maxError.resize(maxError.size(), 0.0);
+    }
+    for (size_t comp = 0; comp < maxError.size(); ++comp) {
+        m_stats.maxError[comp] = std::max(m_stats.maxError[comp], maxError[comp]);
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+hid_t
+HDF5PlotWriter::createDataProps(const hsize_t a_totalSize,
+                                const hsize_t a_maxBlockSize) const
+{
+    hid_t dcpl = H5Pcreate(H5P_DATASET_CREATE);
+    if (!m_compression.isEnabled() || a_totalSize == 0) return dcpl;
+
+    // Chunks cannot exceed 4 GB.
+    const size_t  elemSize = (m_singlePrecision ? sizeof(float) : sizeof(Real));
+    const hsize_t maxChunk = ((hsize_t(1) << 32) - 1) / elemSize;
+    const hsize_t chunk    = std::max<hsize_t>(
+        1, std::min(std::min(a_maxBlockSize, a_totalSize), maxChunk));
+    H5Pset_chunk(dcpl, 1, &chunk);
+
+    if (m_compression.decimalDigits >= 0) {
+        H5Pset_scaleoffset(
+            dcpl, H5Z_SO_FLOAT_DSCALE, m_compression.decimalDigits);
+    }
+    if (m_compression.deflateLevel > 0) {
+        if (m_compression.shuffle) H5Pset_shuffle(dcpl);
+        H5Pset_deflate(dcpl, m_compression.deflateLevel);
+    }
+
+    return dcpl;
+}
+
+
+// -----------------------------------------------------------------------------
+HDF5PlotWriter::Compression
+HDF5PlotWriter::validate(const Compression& a_compression)
+{
+    Compression comp = a_compression;
+
+#if defined(CH_MPI) && defined(H5_HAVE_PARALLEL) && !H5_VERSION_GE(1, 10, 2)
+    // Parallel writes to filtered datasets arrived in HDF5 1.10.2.
+    if (comp.isEnabled() && numProc() > 1) {
+        MAYDAYWARNING("Plotfile compression needs a parallel HDF5 >= 1.10.2. "
+                      "Plotfiles will not be compressed.");
+        return Compression();
+    }
+#endif
+
+    if (comp.deflateLevel > 0 && H5Zfilter_avail(H5Z_FILTER_DEFLATE) <= 0) {
+        MAYDAYWARNING("This HDF5 library does not provide the deflate filter. "
+                      "Plotfiles will not be deflated.");
+        comp.deflateLevel = 0;
+    }
+    if (comp.decimalDigits >= 0 && H5Zfilter_avail(H5Z_FILTER_SCALEOFFSET) <= 0) {
+        MAYDAYWARNING("This HDF5 library does not provide the scale-offset "
+                      "filter. Plotfiles will be written without loss.");
+        comp.decimalDigits = -1;
+    }
+
+    return comp;
+}
+
+
+// -----------------------------------------------------------------------------
+void
+HDF5PlotWriter::report(std::ostream&                   a_os,
+                       const std::vector<std::string>& a_compNames) const
+{
+    hsize_t fileBytes = 0;
+    H5Fget_filesize(m_fileID, &fileBytes);
+
+    constexpr Real MB = 1024.0 * 1024.0;
+    a_os << m_fileName << ": " << fileBytes / MB << " MB on disk, "
+         << m_stats.rawBytes / MB << " MB of data";
+    if (fileBytes > 0) {
+        a_os << " (ratio " << m_stats.rawBytes / Real(fileBytes) << ")";
+    }
+    if (m_stats.seconds > 0.0) {
+        a_os << ", " << m_stats.rawBytes / MB / m_stats.seconds << " MB/s";
+    }
+    a_os << "\n";
+
+    if (m_singlePrecision || m_compression.decimalDigits >= 0) {
+        for (size_t comp = 0; comp < m_stats.maxError.size(); ++comp) {
+            a_os << "    max error of ";
+            if (comp < a_compNames.size()) {
+                a_os << a_compNames[comp];
+            } else {
+                a_os << "comp " << comp;
+            }
+            a_os << " <= " << m_stats.maxError[comp] << "\n";
+        }
+    }
+}
+
+
+// ======================= HDF5CheckpointReader ================================
+
+// -----------------------------------------------------------------------------
+HDF5CheckpointReader::HDF5CheckpointReader(const std::string& a_fileName)
+: m_fileName(a_fileName)
+, m_fileID(-1)
+{
+    hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+
+    // Without parallel HDF5, each rank simply opens the file on its own.
+#if defined(CH_MPI) && defined(H5_HAVE_PARALLEL)
+    H5Pset_fapl_mpio(fapl, Chombo_MPI::comm, MPI_INFO_NULL);
+#endif
+
+    m_fileID = H5Fopen(m_fileName.c_str(), H5F_ACC_RDONLY, fapl);
+    H5Pclose(fapl);
+
+    if (m_fileID < 0) {
+        MAYDAYERROR("Could not open " << m_fileName);
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+HDF5CheckpointReader::~HDF5CheckpointReader()
+{
+    if (m_fileID >= 0) {
+        H5Fclose(m_fileID);
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+HDF5CheckpointReader::readBoxLayout(Vector<Box>&       a_boxes,
+                                    Vector<int>&       a_procMap,
+                                    const std::string& a_groupName)
+{
+    // Layout: numBoxes, numRanks, then 2*SpaceDim ints and a rank per box.
+    std::vector<int> buf;
+
+    if (procID() == 0) {
+        hid_t groupID = H5Gopen2(m_fileID, a_groupName.c_str(), H5P_DEFAULT);
+        if (groupID < 0) {
+            MAYDAYERROR("Could not open " << a_groupName << " in "
+                        << m_fileName);
+        }
+
+        hid_t boxDset  = H5Dopen2(groupID, "boxes", H5P_DEFAULT);
+        hid_t procDset = H5Dopen2(groupID, "Processors", H5P_DEFAULT);
+        if (boxDset < 0 || procDset < 0) {
+            MAYDAYERROR(a_groupName << " in " << m_fileName
+                        << " does not have a box layout.");
+        }
+
+        hid_t   space    = H5Dget_space(boxDset);
+        hsize_t numBoxes = H5Sget_simple_extent_npoints(space);
+        H5Sclose(space);
+
+        // Fields are matched by name, so the padding does not matter.
+        std::vector<int> boxBuf((2 * SpaceDim + 1) * numBoxes);
+        std::vector<int64_t> procBuf(numBoxes);
+        if (numBoxes > 0) {
+            hid_t type = createBoxType();
+            H5Dread(boxDset, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, boxBuf.data());
+            H5Tclose(type);
+            H5Dread(procDset, H5T_NATIVE_INT64, H5S_ALL, H5S_ALL, H5P_DEFAULT,
+                    procBuf.data());
+        }
+
+        // Files written by Python do not record the rank count.
+        int numRanks = -1;
+        if (H5Aexists(procDset, "numRanks") > 0) {
+            hid_t attr = H5Aopen(procDset, "numRanks", H5P_DEFAULT);
+            H5Aread(attr, H5T_NATIVE_INT, &numRanks);
+            H5Aclose(attr);
+        }
+
+        H5Dclose(procDset);
+        H5Dclose(boxDset);
+        H5Gclose(groupID);
+
+        buf.resize(2 + (2 * SpaceDim + 1) * numBoxes);
+        buf[0] = numBoxes;
+        buf[1] = numRanks;
+        for (hsize_t idx = 0; idx < numBoxes; ++idx) {
+            int*       dst = &buf[2 + (2 * SpaceDim + 1) * idx];
+            const int* src = &boxBuf[(2 * SpaceDim + 1) * idx];
+            for (int d = 0; d < 2 * SpaceDim; ++d) dst[d] = src[d];
+            dst[2 * SpaceDim] = procBuf[idx];
+        }
+    }
+
+#ifdef CH_MPI
+    int bufSize = buf.size();
+    MPI_Bcast(&bufSize, 1, MPI_INT, 0, Chombo_MPI::comm);
+    buf.resize(bufSize);
+    MPI_Bcast(buf.data(), bufSize, MPI_INT, 0, Chombo_MPI::comm);
+#endif
+
+    const int numBoxes = buf[0];
+    const int numRanks = buf[1];
+
+    a_boxes.resize(numBoxes);
+    a_procMap.resize(numBoxes);
+
+    int maxProcID = -1;
+    for (int idx = 0; idx < numBoxes; ++idx) {
+        const int* src = &buf[2 + (2 * SpaceDim + 1) * idx];
+        a_boxes[idx] = Box(IntVect(D_DECL(src[0], src[1], src[2])),
+                           IntVect(D_DECL(src[SpaceDim],
+                                          src[SpaceDim + 1],
+                                          src[SpaceDim + 2])));
+        a_procMap[idx] = src[2 * SpaceDim];
+        maxProcID = std::max(maxProcID, a_procMap[idx]);
+    }
+
+    // Reuse the stored distribution only if it fits this run.
+    const bool sameRanks = (numRanks >= 0 ? numRanks == int(numProc())
+                                          : maxProcID < int(numProc()));
+    if (!sameRanks) {
+        a_procMap.clear();
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+HDF5CheckpointReader::readDataset(FArrayBox&         a_fab,
+                                  hid_t              a_groupID,
+                                  const std::string& a_dsetName,
+                                  const Box&         a_validBox,
+                                  const int          a_faceDir)
+{
+    hid_t dset = H5Dopen2(a_groupID, a_dsetName.c_str(), H5P_DEFAULT);
+    if (dset < 0) {
+        MAYDAYERROR("Could not find " << a_dsetName << " in " << m_fileName
+                    << ". Does this box belong to the checkpoint's layout?");
+    }
+
+    hid_t fileSpace = H5Dget_space(dset);
+    if (H5Sget_simple_extent_ndims(fileSpace) != SpaceDim + 1) {
+        MAYDAYERROR(a_dsetName << " in " << m_fileName
+                    << " has the wrong rank.");
+    }
+    hsize_t dims[SpaceDim + 1];
+    H5Sget_simple_extent_dims(fileSpace, dims, nullptr);
+
+    // Recover the region that was written, including its ghosts.
+    Box fileRegion = a_validBox;
+    if (a_faceDir >= 0) fileRegion.surroundingNodes(a_faceDir);
+    {
+        IntVect ghost;
+        for (int d = 0; d < SpaceDim; ++d) {
+            ghost[d] = (int(dims[d]) - fileRegion.size(d)) / 2;
+        }
+        fileRegion.grow(ghost);
+    }
+
+    const Box overlap  = fileRegion & a_fab.box();
+    const int numComps = std::min<int>(dims[SpaceDim], a_fab.nComp());
+    if (overlap.isEmpty() || numComps <= 0) {
+        H5Sclose(fileSpace);
+        H5Dclose(dset);
+        return;
+    }
+
+    hsize_t start[SpaceDim + 1], count[SpaceDim + 1];
+    for (int d = 0; d < SpaceDim; ++d) {
+        start[d] = overlap.smallEnd(d) - fileRegion.smallEnd(d);
+        count[d] = overlap.size(d);
+    }
+    start[SpaceDim] = 0;
+    count[SpaceDim] = numComps;
+    H5Sselect_hyperslab(fileSpace, H5S_SELECT_SET, start, nullptr, count,
+                        nullptr);
+
+    hid_t memSpace = H5Screate_simple(SpaceDim + 1, count, nullptr);
+
+    std::vector<Real> buf(overlap.numPts() * numComps);
+    H5Dread(dset, H5T_NATIVE_DOUBLE, memSpace, fileSpace, H5P_DEFAULT,
+            buf.data());
+
+    H5Sclose(memSpace);
+    H5Sclose(fileSpace);
+    H5Dclose(dset);
+
+    // Undo the C ordering. See HDF5CheckpointWriter::packFAB.
+    const IntVect n      = overlap.size();
+    const long    numPts = overlap.numPts();
+    long srcStride[SpaceDim];
+    {
+        long s = numComps;
+        for (int d = SpaceDim - 1; d >= 0; --d) {
+            srcStride[d] = s;
+            s *= n[d];
+        }
+    }
+
+    const long numRows = numPts / n[0];
+    for (int comp = 0; comp < numComps; ++comp) {
+        for (long row = 0; row < numRows; ++row) {
+            IntVect iv    = overlap.smallEnd();
+            long    offset = comp;
+            long    r      = row;
+            for (int d = 1; d < SpaceDim; ++d) {
+                iv[d] += r % n[d];
+                offset += (r % n[d]) * srcStride[d];
+                r /= n[d];
+            }
+
+            const Real* srcRow = buf.data() + offset;
+            Real*       dstRow = &a_fab(iv, comp);
+            for (int i = 0; i < n[0]; ++i) {
+                dstRow[i] = srcRow[i * srcStride[0]];
+            }
+        }
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+HDF5CheckpointReader::read(LevelData<FArrayBox>& a_data,
+                           const std::string&    a_groupName,
+                           const std::string&    a_name)
+{
+    const DisjointBoxLayout& grids = a_data.getBoxes();
+
+    hid_t groupID = H5Gopen2(m_fileID, a_groupName.c_str(), H5P_DEFAULT);
+    if (groupID < 0) {
+        MAYDAYERROR("Could not open " << a_groupName << " in " << m_fileName);
+    }
+
+    for (DataIterator dit(grids); dit.ok(); ++dit) {
+        const Box& valid = grids[dit];
+        this->readDataset(a_data[dit],
+                          groupID,
+                          a_name + HDF5CheckpointWriter::boxTag(valid.smallEnd()),
+                          valid,
+                          -1);
+    }
+
+    H5Gclose(groupID);
+}
+
+
+// -----------------------------------------------------------------------------
+void
+HDF5CheckpointReader::read(LevelData<FluxBox>& a_data,
+                           const std::string&  a_groupName,
+                           const std::string&  a_name)
+{
+    const DisjointBoxLayout& grids = a_data.getBoxes();
+
+    hid_t groupID = H5Gopen2(m_fileID, a_groupName.c_str(), H5P_DEFAULT);
+    if (groupID < 0) {
+        MAYDAYERROR("Could not open " << a_groupName << " in " << m_fileName);
+    }
+
+    for (DataIterator dit(grids); dit.ok(); ++dit) {
+        const Box& valid = grids[dit];
+        for (int dir = 0; dir < SpaceDim; ++dir) {
+            this->readDataset(
+                a_data[dit][dir],
+                groupID,
+                a_name + HDF5CheckpointWriter::boxTag(valid.smallEnd(), dir),
+                valid,
+                dir);
+        }
+    }
+
+    H5Gclose(groupID);
+}
+
+
+#endif  // SOMAR_USE_HDF5
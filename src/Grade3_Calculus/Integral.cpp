@@ -131,8 +131,10 @@ Integral::sum(Real&                       a_vol,
                                    a_levGeo.getCCJ(),
                                    a_comp);
 
-    Comm::reduce(localSum, MPI_SUM);
-    Comm::reduce(localVol, MPI_SUM);
+    Comm::ReductionBatch batch;
+    batch.add(localSum, MPI_SUM);
+    batch.add(localVol, MPI_SUM);
+    batch.reduce();
 
     a_vol = localVol;
     return localSum;
@@ -153,6 +155,57 @@ Integral::sum(Real&                                a_vol,
               const bool                           a_sumJPhi,
               const int                            a_comp,
               const int                            a_lBase)
+{
+    Real localSum =
+        localAMRSum(a_vol, a_phi, a_levGeo, a_sumJPhi, a_comp, a_lBase);
+
+    Comm::ReductionBatch batch;
+    batch.add(localSum, MPI_SUM);
+    batch.add(a_vol, MPI_SUM);
+    batch.reduce();
+
+    return localSum;
+}
+
+
+// -----------------------------------------------------------------------------
+// Same as the AMR sum above, but the MPI reduction is queued in a_batch
+// instead of being done right away. a_sum (and *a_volPtr, if not NULL)
+// will hold the global results after a_batch.end() is called.
+// -----------------------------------------------------------------------------
+void
+Integral::queueSum(Comm::ReductionBatch&                a_batch,
+                   Real&                                a_sum,
+                   Real*                                a_volPtr,
+                   const Vector<LevelData<FArrayBox>*>& a_phi,
+                   const LevelGeometry&                 a_levGeo,
+                   const bool                           a_sumJPhi,
+                   const int                            a_comp,
+                   const int                            a_lBase)
+{
+    Real localVol = 0.0;
+    a_sum =
+        localAMRSum(localVol, a_phi, a_levGeo, a_sumJPhi, a_comp, a_lBase);
+    a_batch.add(a_sum, MPI_SUM);
+
+    if (a_volPtr) {
+        *a_volPtr = localVol;
+        a_batch.add(*a_volPtr, MPI_SUM);
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+// Performs the computation for the AMR sum functions. This version does
+// not perform MPI communication.
+// -----------------------------------------------------------------------------
+Real
+Integral::localAMRSum(Real&                                a_vol,
+                      const Vector<LevelData<FArrayBox>*>& a_phi,
+                      const LevelGeometry&                 a_levGeo,
+                      const bool                           a_sumJPhi,
+                      const int                            a_comp,
+                      const int                            a_lBase)
 {
     // Sanity check on a_lBase
     const int vectorSize = a_phi.size();
@@ -207,9 +260,6 @@ Integral::sum(Real&                                a_vol,
         }
     }
 
-    Comm::reduce(localSum, MPI_SUM);
-    Comm::reduce(localVol, MPI_SUM);
-
     a_vol = localVol;
     return localSum;
 }
@@ -263,8 +313,10 @@ Integral::sum(Real&                       a_sum,
             a_vol, a_phi, a_dXi, IntVect::Unit, nullptr, nullptr, a_comp);
     }
 
-    Comm::reduce(a_sum, MPI_SUM);
-    Comm::reduce(a_vol, MPI_SUM);
+    Comm::ReductionBatch batch;
+    batch.add(a_sum, MPI_SUM);
+    batch.add(a_vol, MPI_SUM);
+    batch.reduce();
 }
 
 
@@ -319,26 +319,25 @@ LevelGeometry::redistributeCache (const DisjointBoxLayout& a_newGrids)
 
     // Copy the data to the new grids (non local operation).
     {
-        Copier cp;
-        LayoutTools::defineImpartialCopier(cp,
-                                           oldJ.boxLayout(),
-                                           m_grids,
-                                           m_domain,
-                                           oldJ.ghostVect(),
-                                           oldJ.ghostVect());
+        // If oldJ and oldJinv have the same ghosts, this Copier is reused.
+        const auto cpPtr =
+            LayoutTools::cachedImpartialCopier(oldJ.boxLayout(),
+                                               m_grids,
+                                               m_domain,
+                                               oldJ.ghostVect(),
+                                               oldJ.ghostVect());
         m_CCJCache.define(m_grids, oldJ.nComp(), oldJ.ghostVect());
-        oldJ.copyTo(m_CCJCache, cp);
+        oldJ.copyTo(m_CCJCache, *cpPtr);
     }
     {
-        Copier cp;
-        LayoutTools::defineImpartialCopier(cp,
-                                           oldJinv.boxLayout(),
-                                           m_grids,
-                                           m_domain,
-                                           oldJinv.ghostVect(),
-                                           oldJinv.ghostVect());
+        const auto cpPtr =
+            LayoutTools::cachedImpartialCopier(oldJinv.boxLayout(),
+                                               m_grids,
+                                               m_domain,
+                                               oldJinv.ghostVect(),
+                                               oldJinv.ghostVect());
         m_CCJinvCache.define(m_grids, oldJinv.nComp(), oldJinv.ghostVect());
-        oldJinv.copyTo(m_CCJinvCache, cp);
+        oldJinv.copyTo(m_CCJinvCache, *cpPtr);
     }
     {
         std::array<StaggeredCopier, CH_SPACEDIM> cp;
@@ -0,0 +1,245 @@
+/*******************************************************************************
+ *  SOMAR - Stratified Ocean Model with Adaptive Refinement
+ *  Developed by Ed Santilli & Alberto Scotti
+ *  Copyright (C) 2024 Thomas Jefferson University and Arizona State University
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ *
+ *  For up-to-date contact information, please visit the repository homepage,
+ *  https://github.com/MUON-CFD/SOMAR.
+ ******************************************************************************/
+#include "TimeIntegrator.H"
+#include "PARK.H"
+#include "ForwardEuler.H"
+#include "SDC.H"
+#include "RKW3CN.H"
+#include "Debug.H"
+
+
+// -----------------------------------------------------------------------------
+// Forwards every TimeIntegrator call to a concrete integrator, T.
+// T can be any PARK<RKC>, ForwardEuler, SDC, or RKW3CN.
+// -----------------------------------------------------------------------------
+template <class T>
+class TimeIntegratorModel: public TimeIntegrator
+{
+public:
+    TimeIntegratorModel(const std::string&       a_name,
+                        const DisjointBoxLayout& a_grids,
+                        const int                a_velNumComps,
+                        const IntVect&           a_velGhostVect,
+                        const int                a_pNumComps,
+                        const IntVect&           a_pGhostVect,
+                        const int                a_qNumComps,
+                        const IntVect&           a_qGhostVect)
+    : m_name(a_name)
+    , m_integrator(a_grids,
+                   a_velNumComps,
+                   a_velGhostVect,
+                   a_pNumComps,
+                   a_pGhostVect,
+                   a_qNumComps,
+                   a_qGhostVect)
+    {
+    }
+
+    virtual ~TimeIntegratorModel() {}
+
+    virtual const std::string&
+    name() const override
+    {
+        return m_name;
+    }
+
+    virtual void
+    advance(LevelData<FluxBox>&   a_vel,
+            LevelData<FArrayBox>& a_p,
+            LevelData<FArrayBox>& a_q,
+            const Real            a_oldTime,
+            const Real            a_dt,
+            PARKRHS*              a_rhsPtr) override
+    {
+        m_integrator.advance(a_vel, a_p, a_q, a_oldTime, a_dt, a_rhsPtr);
+    }
+
+    virtual void
+    FEadvance(LevelData<FluxBox>&   a_vel,
+              LevelData<FArrayBox>& a_p,
+              LevelData<FArrayBox>& a_q,
+              const Real            a_oldTime,
+              const Real            a_dt,
+              PARKRHS*              a_rhsPtr) override
+    {
+        m_integrator.FEadvance(a_vel, a_p, a_q, a_oldTime, a_dt, a_rhsPtr);
+    }
+
+    virtual Real
+    ERKStabilityRe() const override
+    {
+        return m_integrator.ERKStabilityRe();
+    }
+
+    virtual Real
+    ERKStabilityIm() const override
+    {
+        return m_integrator.ERKStabilityIm();
+    }
+
+    virtual Real
+    controllerDt(const Real a_tol,
+                 const bool a_useImplicit,
+                 const bool a_useElementary,
+                 const bool a_usePI,
+                 const bool a_usePID) const override
+    {
+        return m_integrator.controllerDt(
+            a_tol, a_useImplicit, a_useElementary, a_usePI, a_usePID);
+    }
+
+    virtual bool
+    readyToInterp() const override
+    {
+        return m_integrator.readyToInterp();
+    }
+
+    virtual Real
+    velTimeInterp(LevelData<FluxBox>& a_vel,
+                  const Real          a_time,
+                  int                 a_srcComp,
+                  int                 a_destComp,
+                  int                 a_numComp) const override
+    {
+        return m_integrator.velTimeInterp(
+            a_vel, a_time, a_srcComp, a_destComp, a_numComp);
+    }
+
+    virtual Real
+    pTimeInterp(LevelData<FArrayBox>& a_p,
+                const Real            a_time,
+                int                   a_srcComp,
+                int                   a_destComp,
+                int                   a_numComp) const override
+    {
+        return m_integrator.pTimeInterp(
+            a_p, a_time, a_srcComp, a_destComp, a_numComp);
+    }
+
+    virtual Real
+    qTimeInterp(LevelData<FArrayBox>& a_q,
+                const Real            a_time,
+                int                   a_srcComp,
+                int                   a_destComp,
+                int                   a_numComp) const override
+    {
+        return m_integrator.qTimeInterp(
+            a_q, a_time, a_srcComp, a_destComp, a_numComp);
+    }
+
+protected:
+    const std::string m_name;
+    T                 m_integrator;
+};
+
+
+// -----------------------------------------------------------------------------
+const std::vector<std::string>&
+TimeIntegrator::availableIntegrators()
+{
+    static const std::vector<std::string> s_names{
+        "PARK", "ForwardEuler", "SDC", "RKW3CN"};
+    return s_names;
+}
+
+
+// -----------------------------------------------------------------------------
+// #/#/# = explicit/implicit/implicit stage order.
+// -----------------------------------------------------------------------------
+const std::vector<std::string>&
+TimeIntegrator::availableTableaux()
+{
+    static const std::vector<std::string> s_names{
+        "ForwardEuler",     // 1/-/1
+        "Midpoint",         //
+        "CN_RKW3",          // 3/2A/1
+        "IMEXRKCB2",        // 2SSP/2L/1
+        "IMEXRKCB3c",       // 3SSP/3L/1 large ERK stability extent
+        "IMEXRKCB3f",       // 3/3L/2
+        "ARK3_2_4L_2_SA",   // 3/3L/2
+        "ARK4_3_6L_2_SA",   // 4/3L/2  (Best for IB)
+        "RK4"};
+    return s_names;
+}
+
+
+// -----------------------------------------------------------------------------
+TimeIntegrator*
+TimeIntegrator::create(const std::string&       a_integrator,
+                       const std::string&       a_tableau,
+                       const DisjointBoxLayout& a_grids,
+                       const int                a_velNumComps,
+                       const IntVect&           a_velGhostVect,
+                       const int                a_pNumComps,
+                       const IntVect&           a_pGhostVect,
+                       const int                a_qNumComps,
+                       const IntVect&           a_qGhostVect)
+{
+#define CREATE_INTEGRATOR(T, NAME)                                             \
+    return new TimeIntegratorModel<T>(NAME,                                    \
+                                      a_grids,                                 \
+                                      a_velNumComps,                           \
+                                      a_velGhostVect,                          \
+                                      a_pNumComps,                             \
+                                      a_pGhostVect,                            \
+                                      a_qNumComps,                             \
+                                      a_qGhostVect)
+
+#define CREATE_PARK(TABLEAU)                                                   \
+    if (a_tableau == #TABLEAU) {                                               \
+        CREATE_INTEGRATOR(PARK<TABLEAU##_Coeffs>, "PARK<" #TABLEAU ">");       \
+    }
+
+    if (a_integrator == "PARK") {
+        CREATE_PARK(ForwardEuler)
+        CREATE_PARK(Midpoint)
+        CREATE_PARK(CN_RKW3)
+        CREATE_PARK(IMEXRKCB2)
+        CREATE_PARK(IMEXRKCB3c)
+        CREATE_PARK(IMEXRKCB3f)
+        CREATE_PARK(ARK3_2_4L_2_SA)
+        CREATE_PARK(ARK4_3_6L_2_SA)
+        CREATE_PARK(RK4)
+
+        MAYDAYERROR("time.tableau = " << a_tableau
+                    << " is not a recognized PARK tableau.");
+
+    } else if (a_integrator == "ForwardEuler") {
+        CREATE_INTEGRATOR(ForwardEuler, "ForwardEuler");
+
+    } else if (a_integrator == "SDC") {
+        CREATE_INTEGRATOR(SDC, "SDC");
+
+    } else if (a_integrator == "RKW3CN") {
+        CREATE_INTEGRATOR(RKW3CN, "RKW3CN");
+    }
+
+#undef CREATE_PARK
+#undef CREATE_INTEGRATOR
+
+    MAYDAYERROR("time.integrator = " << a_integrator
+                << " is not recognized. Try PARK, ForwardEuler, SDC, or "
+                   "RKW3CN.");
+    return nullptr;
+}
@@ -76,9 +76,19 @@ AMRNSLevel::computeDt()
         CH_assert(newDt > 0.0);
     }
 
+    // The stability limits below are computed locally, then reduced together
+    // in one batch while the embedded RK controller does its own work.
+    Comm::ReductionBatch dtBatch;
+    Real advDt  = 1.0e100;
+    Real viscDt = 1.0e100;
+    Real diffDt = 1.0e100;
+    const bool doDiffusiveLimit =
+        !ctx->rhs.doImplicitDiffusion &&
+        (ctx->rhs.doViscousForcing || ctx->rhs.doTemperatureDiffusion ||
+         ctx->rhs.doSalinityDiffusion || ctx->rhs.doScalarDiffusion);
+
     // Advective stability limit...
     {
-        Real advDt = 1.0e100;
         for (dit.reset(); dit.ok(); ++dit) {
             const GeoSourceInterface& geoSrc    = m_levGeoPtr->getGeoSource();
             const FluxBox&            cartVelFB = m_statePtr->vel[dit];
@@ -99,23 +109,12 @@ AMRNSLevel::computeDt()
                 CHF_CONST_REALVECT(dXi));
         }
 
-        Comm::reduce(advDt, MPI_MIN);
-        advDt *= m_parkPtr->ERKStabilityIm();
-
-        if (s_verbosity >= verbThresh) {
-            pout() << "dt advective limit = " << advDt << endl;
-        }
-        newDt = min(newDt, advDt);
+        dtBatch.add(advDt, MPI_MIN);
     } // end advective limiting.
 
 
     // Viscous and diffusive stability limits...
-    if (!ctx->rhs.doImplicitDiffusion &&
-        (ctx->rhs.doViscousForcing || ctx->rhs.doTemperatureDiffusion ||
-         ctx->rhs.doSalinityDiffusion || ctx->rhs.doScalarDiffusion)) {
-        Real viscDt = 1.0e100;
-        Real diffDt = 1.0e100;
-
+    if (doDiffusiveLimit) {
         for (dit.reset(); dit.ok(); ++dit) {
             const FArrayBox& nuTFAB = m_statePtr->eddyNu[dit];
             const Box&       valid  = grids[dit];
@@ -207,25 +206,12 @@ AMRNSLevel::computeDt()
             }
         } // dit
 
-        Comm::reduce(viscDt, MPI_MIN);
-        Comm::reduce(diffDt, MPI_MIN);
-
-        viscDt *= m_parkPtr->ERKStabilityRe();
-        diffDt *= m_parkPtr->ERKStabilityRe();
-
-        if (s_verbosity >= verbThresh) {
-            if (viscDt < 1.0e100) {
-                pout() << "dt viscous limit = " << viscDt << endl;
-            }
-
-            if (diffDt < 1.0e100) {
-                pout() << "dt diffusive limit = " << diffDt << endl;
-            }
-        }
-        newDt = min(newDt, viscDt);
-        newDt = min(newDt, diffDt);
+        dtBatch.add(viscDt, MPI_MIN);
+        dtBatch.add(diffDt, MPI_MIN);
     } // end viscous / diffusive limiting.
 
+    dtBatch.begin();
+
 
     // // Internal wave speed limit
     // const bool doGravityForcing = ctx->rhs.doGravityForcing;
@@ -266,30 +252,23 @@ AMRNSLevel::computeDt()
     // }
 
     // Embedded RK controllers
-    if (ctx->time.useElementaryController ||
-        ctx->time.usePIController ||
-        ctx->time.usePIDController)
-    {
+    const bool useController = ctx->time.useElementaryController ||
+                               ctx->time.usePIController ||
+                               ctx->time.usePIDController;
+    Real controllerDt = 1.0e100;
+    if (useController) {
         const auto velNorm = Analysis::pNorm(*m_velPtr, 0);
         const Real velScale = std::max({D_DECL(velNorm[0], velNorm[1], velNorm[2])});
         // const Real tol = std::max(ctx->time.absTol, ctx->time.relTol * velScale);
         const Real tol = ctx->time.absTol + ctx->time.relTol * velScale;
 
-        const Real controllerDt = m_parkPtr->controllerDt(
+        controllerDt = m_parkPtr->controllerDt(
             tol,
             ctx->rhs.doImplicitDiffusion,
             ctx->time.useElementaryController,
             ctx->time.usePIController,
             ctx->time.usePIDController);
 
-        if (s_verbosity >= verbThresh) {
-            pout() << Format::scientific
-                    << "dt controller limit = " << controllerDt
-                    << endl;
-        }
-
-        newDt = std::min(newDt, controllerDt);
-
 // CHECKPOINT();
 // if (m_time > 0.0 && controllerDt < 1000.0) {
 //     pout() << "Forcing controller dt.\n";
@@ -299,8 +278,44 @@ AMRNSLevel::computeDt()
 // }
     }
 
-    // Communicate: compute the minimum over all procs.
-    Comm::reduce(newDt, MPI_MIN);
+    // Communicate: compute the minimum stability limits over all procs.
+    dtBatch.end();
+
+    advDt *= m_parkPtr->ERKStabilityIm();
+    if (s_verbosity >= verbThresh) {
+        pout() << "dt advective limit = " << advDt << endl;
+    }
+    newDt = min(newDt, advDt);
+
+    if (doDiffusiveLimit) {
+        viscDt *= m_parkPtr->ERKStabilityRe();
+        diffDt *= m_parkPtr->ERKStabilityRe();
+
+        if (s_verbosity >= verbThresh) {
+            if (viscDt < 1.0e100) {
+                pout() << "dt viscous limit = " << viscDt << endl;
+            }
+
+            if (diffDt < 1.0e100) {
+                pout() << "dt diffusive limit = " << diffDt << endl;
+            }
+        }
+        newDt = min(newDt, viscDt);
+        newDt = min(newDt, diffDt);
+    }
+
+    if (useController) {
+        if (s_verbosity >= verbThresh) {
+            pout() << Format::scientific
+                    << "dt controller limit = " << controllerDt
+                    << endl;
+        }
+
+        newDt = std::min(newDt, controllerDt);
+    }
+
+    // Every limit above is already global, so newDt needs no more
+    // communication.
 
     // Report
     if (s_verbosity >= verbThresh) {
@@ -548,6 +563,11 @@ AMRNSLevel::postTimeStep(int a_step)
         this->setBCsDownToThis();
     } // end if not finest level.
 
+    // In-situ sampling. All levels are synchronized by now.
+    if (m_level == 0) {
+        this->writeProbes(a_step);
+    }
+
     // Finally, write diagnostic info to terminal.
     this->printDiagnostics(a_step, false);
 }
@@ -867,16 +887,17 @@ AMRNSLevel::printDiagnostics(const int  a_step,
                 }
 
                 // bdrySum[vel]
+                // This is a global reduction, so only do it if it's reported.
                 LevelData<FluxBox> vel(levPtr->getBoxes(), 1);
                 levPtr->sendToAdvectingVelocity(vel, levPtr->m_statePtr->vel);
-                Real bdrySum = Integral::bdrySum(vel, *levPtr->m_levGeoPtr);
-                levPtr->sendToCartesianVelocity(vel, vel);
-
                 if (s_verbosity >= 2) {
+                    Real bdrySum = Integral::bdrySum(vel, *levPtr->m_levGeoPtr);
+
                     pout() << "Level " << Format::fixed << levPtr->m_level
                            << " bdry momentum = " << Format::scientific
                            << bdrySum << endl;
                 }
+                levPtr->sendToCartesianVelocity(vel, vel);
 
                 // Send to CC vel.
                 levPtr->m_levGeoPtr->multByJ(vel);
@@ -906,12 +927,16 @@ AMRNSLevel::printDiagnostics(const int  a_step,
             }
         }
 
-        // Integrate the momentum and energy
+        // Integrate the momentum, energy, T, S, and scalars. All of the
+        // reductions are queued and sent together.
+        Comm::ReductionBatch sumBatch;
+
         RealVect totalMom;
         for (int dir = 0; dir < SpaceDim; ++dir) {
             // Remember, vel is alredy scaled by J.
             const bool scaleByJ = false;
-            totalMom[dir] = Integral::sum(amrVel, *m_levGeoPtr, scaleByJ, dir);
+            Integral::queueSum(sumBatch, totalMom[dir], nullptr,
+                               amrVel, *m_levGeoPtr, scaleByJ, dir);
         }
 
         // RealVect bdryMom(D_DECL(0., 0., 0.));
@@ -936,34 +961,22 @@ AMRNSLevel::printDiagnostics(const int  a_step,
         // }
         // pout() << "Net boundary momentum = " << bdryMom.sum() << endl;
 
-        const Real totalE = Integral::sum(amrE, *m_levGeoPtr);
-        static Real lastTotalE = 0.0;
-        Real dEonE = (totalE - lastTotalE) / lastTotalE;
-        lastTotalE = totalE;
-
-        // Integrate T and S.
-        {
-            Real totalT = Integral::sum(amrT, *m_levGeoPtr, true, 0);
-            Real totalS = Integral::sum(amrS, *m_levGeoPtr, true, 0);
+        Real totalE;
+        Integral::queueSum(sumBatch, totalE, nullptr, amrE, *m_levGeoPtr);
 
-            if (s_verbosity >= 2) {
-                pout() << "Sum[T] = " << totalT << endl;
-                pout() << "Sum[S] = " << totalS << endl;
-            }
-        }
+        Real totalT, totalS;
+        Integral::queueSum(sumBatch, totalT, nullptr, amrT, *m_levGeoPtr, true, 0);
+        Integral::queueSum(sumBatch, totalS, nullptr, amrS, *m_levGeoPtr, true, 0);
 
-        // Integrate the scalars.
         Vector<Real> totalScalars(nScal, -1.0);
         for (int comp = 0; comp < nScal; ++comp) {
-            totalScalars[comp] =
-                Integral::sum(amrScalars, *m_levGeoPtr, true, comp);
-
-            if (s_verbosity >= 2) {
-                pout() << "Sum[" << this->getScalarName(comp)
-                    << "] = " << totalScalars[comp] << endl;
-            }
+            Integral::queueSum(sumBatch, totalScalars[comp], nullptr,
+                               amrScalars, *m_levGeoPtr, true, comp);
         }
 
+        // Send while we free memory.
+        sumBatch.begin();
+
         // Free memory
         for (unsigned int idx = 0; idx < amrVel.size(); ++idx) {
             if (nScal > 0) {
@@ -987,6 +1000,23 @@ AMRNSLevel::printDiagnostics(const int  a_step,
         amrE.resize(0);
         amrVel.resize(0);
 
+        // Receive.
+        sumBatch.end();
+
+        static Real lastTotalE = 0.0;
+        Real dEonE = (totalE - lastTotalE) / lastTotalE;
+        lastTotalE = totalE;
+
+        if (s_verbosity >= 2) {
+            pout() << "Sum[T] = " << totalT << endl;
+            pout() << "Sum[S] = " << totalS << endl;
+
+            for (int comp = 0; comp < nScal; ++comp) {
+                pout() << "Sum[" << this->getScalarName(comp)
+                    << "] = " << totalScalars[comp] << endl;
+            }
+        }
+
 
         // Write!
         IO::tout(0) << Format::pushFlags;
@@ -24,8 +24,11 @@
 #include "AMRNSLevel.H"
 #include "AMRNSLevelF_F.H"
 #include "Convert.H"
+#include "LayoutTools.H"
 #include "FourthOrder.H"
+#include "ScratchArena.H"
 #include "Debug.H"
+#include "ThreadTools.H"
 
 
 // =============================================================================
@@ -92,6 +95,229 @@ AMRNSLevel::computeMomentumAdvection(LevelData<FluxBox>&       a_kvel,
 }
 
 
+// -----------------------------------------------------------------------------
+void
+AMRNSLevel::computeMomentumAdvectionFused(LevelData<FluxBox>&       a_kvel,
+                                          const LevelData<FluxBox>& a_cartVel,
+                                          const LevelData<FluxBox>& a_advVel,
+                                          const Real                a_refluxDt)
+{
+    CH_assert(a_kvel.nComp() == 1);
+    CH_assert(a_cartVel.nComp() == 1);
+    CH_assert(a_advVel.nComp() == 1);
+
+    debugCheckValidFaceOverlap(a_kvel);
+    debugCheckValidFaceOverlap(a_cartVel);
+    debugCheckValidFaceOverlap(a_advVel);
+
+    static const RHSParameters& rhs = ProblemContext::getInstance()->rhs;
+    static const auto           velReconstruction = rhs.velReconstruction;
+    static const Real           momAdvSkewness    = rhs.momAdvSkewness;
+
+    const GeoSourceInterface& geoSrc = m_levGeoPtr->getGeoSource();
+    const RealVect&           dXi    = m_levGeoPtr->getDXi();
+    const DisjointBoxLayout&  grids  = m_levGeoPtr->getBoxes();
+
+    const bool fourthOrder =
+        (velReconstruction == RHSParameters::Reconstruction::FourthOrder);
+
+    // The 4th-order stencil needs two layers of ghosts. Prepare them just as
+    // momAdvFlux_Cons_Form_FourthOrder does. The exchange is left running
+    // while we compute the interior.
+    LevelData<FluxBox> cartVelGrow, advVelGrow;
+    if (fourthOrder) {
+        cartVelGrow.define(grids, 1, 2 * IntVect::Unit);
+        advVelGrow.define(grids, 1, 2 * IntVect::Unit);
+
+        debugInitLevel(cartVelGrow);
+        debugInitLevel(advVelGrow);
+
+        for (DataIterator dit(grids); dit.ok(); ++dit) {
+            cartVelGrow[dit].copy(a_cartVel[dit]);
+            advVelGrow[dit].copy(a_advVel[dit]);
+        }
+
+        const bool    extrapOrder = 4;
+        const IntVect skipGhosts  = IntVect::Unit;
+        BCTools::extrapAllGhosts(cartVelGrow, extrapOrder, skipGhosts);
+        BCTools::extrapAllGhosts(advVelGrow, extrapOrder, skipGhosts);
+
+        LayoutTools::exchangeBegin(cartVelGrow);
+        LayoutTools::exchangeBegin(advVelGrow);
+    }
+    const LevelData<FluxBox>& cartVel = fourthOrder ? cartVelGrow : a_cartVel;
+    const LevelData<FluxBox>& advVel  = fourthOrder ? advVelGrow : a_advVel;
+
+    // The fluxes that the divergence over a_divRegion reads.
+    auto fluxStencilBox = [](const Box& a_divRegion, const int a_derivDir) {
+        Box fluxBox = a_divRegion;
+        if (fluxBox.type(a_derivDir) == IndexType::CELL) {
+            fluxBox.surroundingNodes(a_derivDir);
+        } else {
+            fluxBox.enclosedCells(a_derivDir);
+            fluxBox.grow(a_derivDir, 1);
+        }
+        return fluxBox;
+    };
+
+    // We split the divergence region, not the fluxes, so that no flux needs
+    // to outlive its pass. Pass 0 takes the faces whose fluxes are three cells
+    // inside the box, as in momAdvFlux_Cons_Form_FourthOrder. Pass 1 waits for
+    // the exchange and takes the strips. The fluxes within one face of the
+    // interior are computed by both passes. The 2nd-order path has all the
+    // ghosts it needs and does everything in pass 0.
+    constexpr int fluxDepth = 3;
+    const int     numPasses = (fourthOrder ? 2 : 1);
+    const bool    doReflux  = !RealCmp::isZero(a_refluxDt);
+
+    const DataIterator dit      = grids.dataIterator();
+    const int          numBoxes = dit.size();
+    std::vector<double>& boxCosts = BoxCostModel::costs(m_level, grids);
+
+    for (int pass = 0; pass < numPasses; ++pass) {
+        if (pass == 1) {
+            LayoutTools::exchangeEnd(cartVelGrow);
+            LayoutTools::exchangeEnd(advVelGrow);
+        }
+        const bool lastPass = (pass == numPasses - 1);
+
+        OMP_PARALLEL_FOR
+        for (int ibox = 0; ibox < numBoxes; ++ibox) {
+            const DataIndex& di = dit[ibox];
+            BoxCostModel::Scope costScope(&boxCosts, di);
+
+            // velComp = advectED vel component.
+            for (int velComp = 0; velComp < SpaceDim; ++velComp) {
+                const FArrayBox& uaFAB   = cartVel[di][velComp];
+                FArrayBox&       kuaFAB  = a_kvel[di][velComp];
+                const Box        fcValid = grids[di].surroundingNodes(velComp);
+
+                Box         divInterior = fcValid;
+                Vector<Box> divStrips;
+                if (fourthOrder) {
+                    LayoutTools::splitInterior(
+                        divInterior, divStrips, fcValid, grids[di], fluxDepth + 1);
+                }
+                const Vector<Box> divRegions =
+                    (pass == 0) ? Vector<Box>(1, divInterior) : divStrips;
+
+                if (lastPass) {
+                    checkForNAN(uaFAB, uaFAB.box());
+                }
+
+                // Same centerings as StaggeredFluxLD[derivDir][velComp].
+                // Slot 0 holds J, so the fluxes start at slot 1.
+                Box       fluxRegions[SpaceDim];
+                FArrayBox fluxFABs[SpaceDim];
+                for (int derivDir = 0; derivDir < SpaceDim; ++derivDir) {
+                    fluxRegions[derivDir] =
+                        (derivDir == velComp)
+                            ? grow(grids[di], BASISV(derivDir))
+                            : surroundingNodes(fcValid, derivDir);
+                    ScratchArena::define(
+                        fluxFABs[derivDir], 1 + derivDir, fluxRegions[derivDir]);
+
+                    // The flux registers read the whole FAB. Whatever this
+                    // pass does not compute must not count.
+                    if (doReflux && !lastPass) {
+                        fluxFABs[derivDir].setVal(0.0);
+                    }
+                }
+
+                for (const Box& divRegion : divRegions) {
+                    if (divRegion.isEmpty()) continue;
+
+                    // The flux stencil reaches two faces past the fluxes.
+                    FArrayBox JFAB;
+                    ScratchArena::define(
+                        JFAB, 0, grow(divRegion, fluxDepth) & uaFAB.box());
+                    geoSrc.fill_J(JFAB, 0, dXi);
+
+                    // derivDir = advectING vel component and derivative dir.
+                    for (int derivDir = 0; derivDir < SpaceDim; ++derivDir) {
+                        const FArrayBox& JubFAB  = advVel[di][derivDir];
+                        FArrayBox&       fluxFAB = fluxFABs[derivDir];
+                        const Real       dXiDir  = dXi[derivDir];
+                        const Box        fluxBox =
+                            fluxStencilBox(divRegion, derivDir)
+                            & fluxRegions[derivDir];
+
+                        if (lastPass) {
+                            checkForNAN(JubFAB, JubFAB.box());
+                        }
+
+                        if (fourthOrder) {
+                            FORT_MOMADVFLUX_FOURTHORDER(
+                                CHF_FRA1(fluxFAB, 0),
+                                CHF_BOX(fluxBox),
+                                CHF_CONST_FRA1(JubFAB, 0),
+                                CHF_CONST_FRA1(uaFAB, 0),
+                                CHF_CONST_FRA1(JFAB, 0),
+                                CHF_CONST_INT(derivDir),
+                                CHF_CONST_INT(velComp),
+                                CHF_CONST_REAL(dXiDir));
+                        } else {
+                            FORT_MOMADVFLUX_SECONDORDER(
+                                CHF_FRA1(fluxFAB, 0),
+                                CHF_BOX(fluxBox),
+                                CHF_CONST_FRA1(JubFAB, 0),
+                                CHF_CONST_FRA1(uaFAB, 0),
+                                CHF_CONST_FRA1(JFAB, 0),
+                                CHF_CONST_INT(derivDir),
+                                CHF_CONST_INT(velComp),
+                                CHF_CONST_REAL(dXiDir));
+                        }
+
+                        // Conservative form component. Same as
+                        // levelVectorDivergence.
+                        if (momAdvSkewness < 1.0) {
+                            constexpr bool accum = true;
+                            FiniteDiff::partialD(kuaFAB,
+                                                 0,
+                                                 divRegion,
+                                                 fluxFAB,
+                                                 0,
+                                                 derivDir,
+                                                 dXiDir / (1.0 - momAdvSkewness),
+                                                 accum);
+                        }
+                    } // derivDir
+                } // divRegion
+
+                // The flux registers are not thread-safe.
+                if (doReflux) {
+                    for (int derivDir = 0; derivDir < SpaceDim; ++derivDir) {
+                        FArrayBox& fluxFAB = fluxFABs[derivDir];
+
+                        // Pass 0 already counted the interior fluxes.
+                        if (pass == 1 && !divInterior.isEmpty()) {
+                            fluxFAB.setVal(
+                                0.0, fluxStencilBox(divInterior, derivDir), 0);
+                        }
+
+                        OMP_CRITICAL
+                        {
+                            this->incrementFluxRegisters(
+                                fluxFAB, di, velComp, derivDir, a_refluxDt);
+                        }
+                    }
+                }
+            } // velComp
+        } // dit
+    } // pass
+
+    if (momAdvSkewness > 0.0) {
+        // Has an advective form component.
+        this->momAdvForce_AdvForm_SecondOrder(a_kvel,
+                                              a_cartVel,
+                                              a_advVel,
+                                              momAdvSkewness);
+    }
+
+    LayoutTools::averageOverlappingValidFaces(a_kvel);
+}
+
+
 // -----------------------------------------------------------------------------
 void
 AMRNSLevel::momAdvFlux_Cons_Form_SecondOrder(
@@ -103,10 +329,18 @@ AMRNSLevel::momAdvFlux_Cons_Form_SecondOrder(
     const RealVect&           dXi    = m_levGeoPtr->getDXi();
     const DisjointBoxLayout&  grids  = m_levGeoPtr->getBoxes();
 
-    for (DataIterator dit(grids); dit.ok(); ++dit) {
+    const DataIterator dit      = grids.dataIterator();
+    const int          numBoxes = dit.size();
+    std::vector<double>& boxCosts = BoxCostModel::costs(m_level, grids);
+
+    OMP_PARALLEL_FOR
+    for (int ibox = 0; ibox < numBoxes; ++ibox) {
+        const DataIndex& di = dit[ibox];
+        BoxCostModel::Scope costScope(&boxCosts, di);
+
         // velComp = advectED vel component.
         for (int velComp = 0; velComp < SpaceDim; ++velComp) {
-            const FArrayBox& uaFAB = a_cartVel[dit][velComp];
+            const FArrayBox& uaFAB = a_cartVel[di][velComp];
 
             checkForNAN(uaFAB, uaFAB.box());
 
@@ -115,8 +349,8 @@ AMRNSLevel::momAdvFlux_Cons_Form_SecondOrder(
 
             // derivDir = advectING vel component and derivative dir.
             for (int derivDir = 0; derivDir < SpaceDim; ++derivDir) {
-                const FArrayBox& JubFAB = a_advVel[dit][derivDir];
-                FArrayBox& fluxFAB    = a_momentumFlux[derivDir][velComp][dit];
+                const FArrayBox& JubFAB = a_advVel[di][derivDir];
+                FArrayBox& fluxFAB    = a_momentumFlux[derivDir][velComp][di];
                 const Box& fluxRegion = fluxFAB.box();
                 const Real dXiDir     = dXi[derivDir];
 
@@ -151,7 +385,8 @@ AMRNSLevel::momAdvFlux_Cons_Form_FourthOrder(
     const RealVect&           dXi         = m_levGeoPtr->getDXi();
     const DisjointBoxLayout&  grids       = m_levGeoPtr->getBoxes();
 
-    // Prepare source data.
+    // Prepare source data. The exchange is left running while we compute
+    // the fluxes that do not need ghosts.
     LevelData<FluxBox> cartVelGrow(grids, 1, 2 * IntVect::Unit);
     LevelData<FluxBox> advVelGrow(grids, 1, 2 * IntVect::Unit);
     {
@@ -168,43 +403,79 @@ AMRNSLevel::momAdvFlux_Cons_Form_FourthOrder(
         BCTools::extrapAllGhosts(cartVelGrow, extrapOrder, skipGhosts);
         BCTools::extrapAllGhosts(advVelGrow, extrapOrder, skipGhosts);
 
-        cartVelGrow.exchange();
-        advVelGrow.exchange();
+        LayoutTools::exchangeBegin(cartVelGrow);
+        LayoutTools::exchangeBegin(advVelGrow);
     }
 
-    for (DataIterator dit(grids); dit.ok(); ++dit) {
-        // velComp = advectED vel component.
-        for (int velComp = 0; velComp < SpaceDim; ++velComp) {
-            const FArrayBox& uaFAB  = cartVelGrow[dit][velComp];
+    // The flux stencil reaches two faces out. Points three cells from the
+    // box edges are computed in pass 0, the strips around them in pass 1.
+    constexpr int interiorDepth = 3;
 
-            checkForNAN(uaFAB, uaFAB.box());
+    const DataIterator dit      = grids.dataIterator();
+    const int          numBoxes = dit.size();
+    std::vector<double>& boxCosts = BoxCostModel::costs(m_level, grids);
 
-            FArrayBox JFAB(uaFAB.box(), 1);
-            geoSrc.fill_J(JFAB, 0, dXi);
+    LevelData<FluxBox> JGrow(grids, 1, 2 * IntVect::Unit);
 
-            // derivDir = advectING vel component and derivative dir.
-            for (int derivDir = 0; derivDir < SpaceDim; ++derivDir) {
-                const FArrayBox& JubFAB = advVelGrow[dit][derivDir];
-                FArrayBox& fluxFAB    = a_momentumFlux[derivDir][velComp][dit];
-                const Box& fluxRegion = fluxFAB.box();
-                const Real dXiDir     = dXi[derivDir];
+    for (int pass = 0; pass < 2; ++pass) {
+        if (pass == 1) {
+            LayoutTools::exchangeEnd(cartVelGrow);
+            LayoutTools::exchangeEnd(advVelGrow);
+        }
 
-                checkForNAN(JubFAB, JubFAB.box());
-                debugInit(fluxFAB);
+        OMP_PARALLEL_FOR
+        for (int ibox = 0; ibox < numBoxes; ++ibox) {
+            const DataIndex& di = dit[ibox];
+            BoxCostModel::Scope costScope(&boxCosts, di);
 
-                FORT_MOMADVFLUX_FOURTHORDER(
-                    CHF_FRA1(fluxFAB, 0),
-                    CHF_BOX(fluxRegion),
-                    CHF_CONST_FRA1(JubFAB, 0),
-                    CHF_CONST_FRA1(uaFAB, 0),
-                    CHF_CONST_FRA1(JFAB, 0),
-                    CHF_CONST_INT(derivDir),
-                    CHF_CONST_INT(velComp),
-                    CHF_CONST_REAL(dXiDir));
+            // velComp = advectED vel component.
+            for (int velComp = 0; velComp < SpaceDim; ++velComp) {
+                const FArrayBox& uaFAB = cartVelGrow[di][velComp];
+                FArrayBox&       JFAB  = JGrow[di][velComp];
 
-            } // derivDir
-        } // velComp
-    } // dit
+                if (pass == 0) {
+                    geoSrc.fill_J(JFAB, 0, dXi);
+                } else {
+                    checkForNAN(uaFAB, uaFAB.box());
+                }
+
+                // derivDir = advectING vel component and derivative dir.
+                for (int derivDir = 0; derivDir < SpaceDim; ++derivDir) {
+                    const FArrayBox& JubFAB = advVelGrow[di][derivDir];
+                    FArrayBox& fluxFAB = a_momentumFlux[derivDir][velComp][di];
+                    const Real dXiDir  = dXi[derivDir];
+
+                    Box         interior;
+                    Vector<Box> strips;
+                    LayoutTools::splitInterior(
+                        interior, strips, fluxFAB.box(), grids[di], interiorDepth);
+
+                    if (pass == 0) {
+                        debugInit(fluxFAB);
+                    } else {
+                        checkForNAN(JubFAB, JubFAB.box());
+                    }
+
+                    const Vector<Box> regions =
+                        (pass == 0) ? Vector<Box>(1, interior) : strips;
+
+                    for (const Box& fluxRegion : regions) {
+                        if (fluxRegion.isEmpty()) continue;
+
+                        FORT_MOMADVFLUX_FOURTHORDER(
+                            CHF_FRA1(fluxFAB, 0),
+                            CHF_BOX(fluxRegion),
+                            CHF_CONST_FRA1(JubFAB, 0),
+                            CHF_CONST_FRA1(uaFAB, 0),
+                            CHF_CONST_FRA1(JFAB, 0),
+                            CHF_CONST_INT(derivDir),
+                            CHF_CONST_INT(velComp),
+                            CHF_CONST_REAL(dXiDir));
+                    }
+                } // derivDir
+            } // velComp
+        } // dit
+    } // pass
 }
 
 #else
@@ -241,7 +512,7 @@ AMRNSLevel::momAdvFlux_Cons_Form_FourthOrder(
                 }
             }
         }
-        cartVelGrow.exchange();
+        LayoutTools::exchange(cartVelGrow);
     }
 
     // Prepare advectING velocity.
@@ -253,7 +524,7 @@ AMRNSLevel::momAdvFlux_Cons_Form_FourthOrder(
         }
         BCTools::extrapAllGhosts(advVelGrow, 4, IntVect::Unit);
         FourthOrder::nodalToAvg(advVelGrow);
-        advVelGrow.exchange();
+        LayoutTools::exchange(advVelGrow);
     }
 
     for (DataIterator dit(grids); dit.ok(); ++dit) {
@@ -362,15 +633,23 @@ AMRNSLevel::momAdvForce_AdvForm_SecondOrder(
     const DisjointBoxLayout& grids = m_levGeoPtr->getBoxes();
     const RealVect&          dXi   = m_levGeoPtr->getDXi();
 
-    for (DataIterator dit(grids); dit.ok(); ++dit) {
+    const DataIterator dit      = grids.dataIterator();
+    const int          numBoxes = dit.size();
+    std::vector<double>& boxCosts = BoxCostModel::costs(m_level, grids);
+
+    OMP_PARALLEL_FOR
+    for (int ibox = 0; ibox < numBoxes; ++ibox) {
+        const DataIndex& di = dit[ibox];
+        BoxCostModel::Scope costScope(&boxCosts, di);
+
         for (int velComp = 0; velComp < SpaceDim; ++velComp) { // advectED
-            const FArrayBox& uFAB    = a_cartVel[dit][velComp];
-            const Box        fcValid = grids[dit].surroundingNodes(velComp);
+            const FArrayBox& uFAB    = a_cartVel[di][velComp];
+            const Box        fcValid = grids[di].surroundingNodes(velComp);
 
             FArrayBox kuFAB(fcValid, 1);
 
             for (int derivDir = 0; derivDir < SpaceDim; ++derivDir) { // advectING
-                const FArrayBox& JuFAB  = a_advVel[dit][derivDir];
+                const FArrayBox& JuFAB  = a_advVel[di][derivDir];
                 const Real       dXiDir = dXi[derivDir];
 
                 debugInit(kuFAB);
@@ -385,7 +664,7 @@ AMRNSLevel::momAdvForce_AdvForm_SecondOrder(
                     CHF_CONST_REAL(dXiDir)
                 );
 
-                a_kvel[dit][velComp].plus(kuFAB, a_scale);
+                a_kvel[di][velComp].plus(kuFAB, a_scale);
             } // derivDir
         } // velComp
     } // dit
@@ -402,6 +681,7 @@ AMRNSLevel::computeScalarAdvection(LevelData<FArrayBox>&       a_kq,
                                    const LevelData<FArrayBox>& a_q,
                                    const LevelData<FluxBox>&   a_advVel) const
 {
+    PhaseTimer::Scope phaseTimer("Advection", m_level);
     CH_assert(a_kq.nComp() == 1);
     CH_assert(a_qFlux.nComp() == 1);
     CH_assert(a_q.nComp() == 1);
@@ -441,16 +721,24 @@ AMRNSLevel::scalAdvFlux_Cons_Form_SecondOrder(
     const RealVect&           dXi    = m_levGeoPtr->getDXi();
     const DisjointBoxLayout&  grids  = a_q.getBoxes();
 
-    for (DataIterator dit(grids); dit.ok(); ++dit) {
-        FArrayBox JqFAB(a_q[dit].box(), 1);
+    const DataIterator dit      = grids.dataIterator();
+    const int          numBoxes = dit.size();
+    std::vector<double>& boxCosts = BoxCostModel::costs(m_level, grids);
+
+    OMP_PARALLEL_FOR
+    for (int ibox = 0; ibox < numBoxes; ++ibox) {
+        const DataIndex& di = dit[ibox];
+        BoxCostModel::Scope costScope(&boxCosts, di);
+
+        FArrayBox JqFAB(a_q[di].box(), 1);
         geoSrc.fill_J(JqFAB, 0, dXi);
-        JqFAB.mult(a_q[dit]);
+        JqFAB.mult(a_q[di]);
 
-        Convert::CellsToAllFaces(a_qFlux[dit], JqFAB);
-        m_levGeoPtr->divByJ(a_qFlux[dit], dit());
+        Convert::CellsToAllFaces(a_qFlux[di], JqFAB);
+        m_levGeoPtr->divByJ(a_qFlux[di], di);
 
-        a_qFlux[dit].mult(a_advVel[dit], grids[dit], 0, 0, 1);
-        a_qFlux[dit].negate();
+        a_qFlux[di].mult(a_advVel[di], grids[di], 0, 0, 1);
+        a_qFlux[di].negate();
     }
     checkForValidNAN(a_qFlux);
 }
@@ -464,13 +752,19 @@ AMRNSLevel::scalAdvFlux_Cons_Form_FourthOrder(
     const LevelData<FArrayBox>& a_q,
     const LevelData<FluxBox>&   a_advVel) const
 {
-    const DisjointBoxLayout& grids = a_q.getBoxes();
+    const DisjointBoxLayout& grids    = a_q.getBoxes();
+    const DataIterator       dit      = grids.dataIterator();
+    const int                numBoxes = dit.size();
+    std::vector<double>& boxCosts = BoxCostModel::costs(m_level, grids);
 
     // Create q that we can modify.
     LevelData<FArrayBox> Jq(grids, 1, IntVect::Unit);
-    for (DataIterator dit(grids); dit.ok(); ++dit) {
-        Jq[dit].copy(a_q[dit]);
-        m_levGeoPtr->multByJ(Jq[dit], dit());
+    OMP_PARALLEL_FOR
+    for (int ibox = 0; ibox < numBoxes; ++ibox) {
+        const DataIndex& di = dit[ibox];
+        BoxCostModel::Scope costScope(&boxCosts, di);
+        Jq[di].copy(a_q[di]);
+        m_levGeoPtr->multByJ(Jq[di], di);
     }
 
     // Construct 2nd order FC Jq.
@@ -479,11 +773,15 @@ AMRNSLevel::scalAdvFlux_Cons_Form_FourthOrder(
     // Upgrade to 4th order...
     // Compute slopes.
     LevelData<FluxBox> deltaJq(grids, 1, IntVect::Unit);
-    for (DataIterator dit(grids); dit.ok(); ++dit) {
+    OMP_PARALLEL_FOR
+    for (int ibox = 0; ibox < numBoxes; ++ibox) {
+        const DataIndex& di = dit[ibox];
+        BoxCostModel::Scope costScope(&boxCosts, di);
+
         for (int fcDir = 0; fcDir < SpaceDim; ++fcDir) {
-            FArrayBox&       deltaJqFAB = deltaJq[dit][fcDir];
-            const FArrayBox& JqFAB      = Jq[dit];
-            const Box        fcValid    = grids[dit].surroundingNodes(fcDir);
+            FArrayBox&       deltaJqFAB = deltaJq[di][fcDir];
+            const FArrayBox& JqFAB      = Jq[di];
+            const Box        fcValid    = grids[di].surroundingNodes(fcDir);
             constexpr Real   dummyDXi   = 1.0;
 
             deltaJqFAB.setVal(quietNAN);
@@ -493,31 +791,61 @@ AMRNSLevel::scalAdvFlux_Cons_Form_FourthOrder(
     }
     constexpr bool extrapOrder = 2;
     BCTools::extrapAllGhosts(deltaJq, extrapOrder);
-    deltaJq.exchange();
+    LayoutTools::exchangeBegin(deltaJq);
 
-    // Promote FC Jq to 4th order.
-    for (DataIterator dit(grids); dit.ok(); ++dit) {
-        for (int fcDir = 0; fcDir < SpaceDim; ++fcDir) {
-            FArrayBox&       JqFAB      = a_qFlux[dit][fcDir];
-            const FArrayBox& deltaJqFAB = deltaJq[dit][fcDir];
-            const IntVect    e          = BASISV(fcDir);
-            constexpr Real   coeff      = 1.0 / 12.0;
+    // Promote FC Jq to 4th order. The stencil reaches one face out, so faces
+    // two cells from the box edges are promoted while the slopes are being
+    // exchanged (pass 0). The strips around them wait for the ghosts (pass 1).
+    constexpr int interiorDepth = 2;
+
+    for (int pass = 0; pass < 2; ++pass) {
+        if (pass == 1) {
+            LayoutTools::exchangeEnd(deltaJq);
+        }
 
-            const Box upgradeBox =
-                grids[dit].surroundingNodes(fcDir);
+        OMP_PARALLEL_FOR
+        for (int ibox = 0; ibox < numBoxes; ++ibox) {
+            const DataIndex& di = dit[ibox];
+            BoxCostModel::Scope costScope(&boxCosts, di);
 
-            for (BoxIterator bit(upgradeBox); bit.ok(); ++bit) {
-                const IntVect& fc = bit();
-                JqFAB(fc) -= coeff * (deltaJqFAB(fc + e) - deltaJqFAB(fc - e));
+            for (int fcDir = 0; fcDir < SpaceDim; ++fcDir) {
+                FArrayBox&       JqFAB      = a_qFlux[di][fcDir];
+                const FArrayBox& deltaJqFAB = deltaJq[di][fcDir];
+                const IntVect    e          = BASISV(fcDir);
+                constexpr Real   coeff      = 1.0 / 12.0;
+
+                const Box upgradeBox =
+                    grids[di].surroundingNodes(fcDir);
+
+                Box         interior;
+                Vector<Box> strips;
+                LayoutTools::splitInterior(
+                    interior, strips, upgradeBox, grids[di], interiorDepth);
+
+                const Vector<Box> regions =
+                    (pass == 0) ? Vector<Box>(1, interior) : strips;
+
+                for (const Box& region : regions) {
+                    if (region.isEmpty()) continue;
+
+                    for (BoxIterator bit(region); bit.ok(); ++bit) {
+                        const IntVect& fc = bit();
+                        JqFAB(fc) -= coeff * (deltaJqFAB(fc + e) - deltaJqFAB(fc - e));
+                    }
+                }
             }
         }
     }
 
     // Compute FC flux.
-    for (DataIterator dit(grids); dit.ok(); ++dit) {
-        m_levGeoPtr->divByJ(a_qFlux[dit], dit());
-        a_qFlux[dit].mult(a_advVel[dit], grids[dit], 0, 0, 1);
-        a_qFlux[dit].negate();
+    OMP_PARALLEL_FOR
+    for (int ibox = 0; ibox < numBoxes; ++ibox) {
+        const DataIndex& di = dit[ibox];
+        BoxCostModel::Scope costScope(&boxCosts, di);
+
+        m_levGeoPtr->divByJ(a_qFlux[di], di);
+        a_qFlux[di].mult(a_advVel[di], grids[di], 0, 0, 1);
+        a_qFlux[di].negate();
     }
     checkForValidNAN(a_qFlux);
 }
@@ -542,7 +870,7 @@ AMRNSLevel::scalAdvFlux_Cons_Form_FourthOrder(
             }
             BCTools::extrapAllGhosts(advVelGrow, 4, IntVect::Unit);
             FourthOrder::nodalToAvg(advVelGrow);
-            advVelGrow.exchange();
+            LayoutTools::exchange(advVelGrow);
         }
 
 
@@ -553,7 +881,7 @@ AMRNSLevel::scalAdvFlux_Cons_Form_FourthOrder(
             m_levGeoPtr->multByJ(ccJq[dit], dit());
         }
         BCTools::extrapAllGhosts(ccJq, 4, IntVect::Unit);
-        ccJq.exchange();
+        LayoutTools::exchange(ccJq);
         for (DataIterator dit(grids); dit.ok(); ++dit) {
             FourthOrder::nodalToAvg(ccJq[dit], ccJq[dit].box());
         }
@@ -577,7 +905,7 @@ AMRNSLevel::scalAdvFlux_Cons_Form_FourthOrder(
                 }
             }
         }
-        fcJq.exchange();
+        LayoutTools::exchange(fcJq);
 
         // Compute FC flux.
         for (DataIterator dit(grids); dit.ok(); ++dit) {
@@ -1,4 +1,6 @@
 #include "AMRNSLevel.H"
+#include "LayoutTools.H"
+#include "CopierCache.H"
 #include "ScalarBC.H"
 #include "Subspace.H"
 #include "VelBC.H"
@@ -458,17 +460,17 @@ AMRNSLevel::setVelBC(LevelData<FluxBox>&       a_vel,
     // Do exchanges.
     if (hasGhosts) {
         if (exCopiersAreCached) {
-            a_vel.exchangeBegin(m_statePtr->velExCopier);
-            a_vel.exchangeEnd();
+            LayoutTools::exchangeBegin(a_vel, m_statePtr->velExCopier);
+            LayoutTools::exchangeEnd(a_vel);
 
-            a_vel.exchangeBegin(m_statePtr->velExCornerCopier1);
-            a_vel.exchangeEnd();
+            LayoutTools::exchangeBegin(a_vel, m_statePtr->velExCornerCopier1);
+            LayoutTools::exchangeEnd(a_vel);
 
-            a_vel.exchangeBegin(m_statePtr->velExCornerCopier2);
-            a_vel.exchangeEnd();
+            LayoutTools::exchangeBegin(a_vel, m_statePtr->velExCornerCopier2);
+            LayoutTools::exchangeEnd(a_vel);
 
         } else {
-            a_vel.exchange();
+            LayoutTools::exchange(a_vel);
         }
     }
 
@@ -539,11 +541,11 @@ AMRNSLevel::setPressureBC(LevelData<FArrayBox>&       a_p,
     // Do exchange #1.
     // This must be done before we potentially call BCTools::neum.
     if (exCopiersAreCached) {
-        a_p.exchange(m_statePtr->pExCopier);
+        LayoutTools::exchange(a_p, m_statePtr->pExCopier);
     } else {
-        Copier cp;
-        m_statePtr->pDefineExCopier(cp, a_p);
-        a_p.exchange(cp);
+        const auto cpPtr = CopierCache::trimmedExchangeCopier(
+            a_p.getBoxes(), a_p.ghostVect());
+        LayoutTools::exchange(a_p, *cpPtr);
     }
 
     // Set physical BCs.
@@ -553,11 +555,11 @@ AMRNSLevel::setPressureBC(LevelData<FArrayBox>&       a_p,
     // Do exchange #2.
     // This must be done after all other ghosts are filled.
     if (exCopiersAreCached) {
-        a_p.exchange(m_statePtr->pExCornerCopier);
+        LayoutTools::exchange(a_p, m_statePtr->pExCornerCopier);
     } else {
-        CornerCopier ccp;
-        m_statePtr->pDefineExCornerCopier(ccp, a_p);
-        a_p.exchange(ccp);
+        const auto ccpPtr = CornerCopier::cachedExchangeCopier(
+            a_p.getBoxes(), a_p.ghostVect());
+        LayoutTools::exchange(a_p, *ccpPtr);
     }
 
     // Fill ghosts at corners of domain. This must happen last!
@@ -634,11 +636,11 @@ AMRNSLevel::setTemperatureBC(LevelData<FArrayBox>&       a_T,
     Subspace::addHorizontalExtrusion(a_T, 0, *m_TbarPtr, 0, 1, -1.0);
     if (hasGhosts) {
         if (exCopiersAreCached) {
-            a_T.exchange(m_statePtr->qExCopier);
+            LayoutTools::exchange(a_T, m_statePtr->qExCopier);
         } else {
-            Copier cp;
-            m_statePtr->qDefineExCopier(cp, a_T);
-            a_T.exchange(cp);
+            const auto cpPtr = CopierCache::trimmedExchangeCopier(
+                a_T.getBoxes(), a_T.ghostVect());
+            LayoutTools::exchange(a_T, *cpPtr);
         }
     }
     Subspace::addHorizontalExtrusion(a_T, 0, *m_TbarPtr, 0, 1, 1.0);
@@ -652,11 +654,11 @@ AMRNSLevel::setTemperatureBC(LevelData<FArrayBox>&       a_T,
     Subspace::addHorizontalExtrusion(a_T, 0, *m_TbarPtr, 0, 1, -1.0);
     if (hasGhosts) {
         if (exCopiersAreCached) {
-            a_T.exchange(m_statePtr->qExCornerCopier);
+            LayoutTools::exchange(a_T, m_statePtr->qExCornerCopier);
         } else {
-            CornerCopier ccp;
-            m_statePtr->qDefineExCornerCopier(ccp, a_T);
-            a_T.exchange(ccp);
+            const auto ccpPtr = CornerCopier::cachedExchangeCopier(
+                a_T.getBoxes(), a_T.ghostVect());
+            LayoutTools::exchange(a_T, *ccpPtr);
         }
     }
 
@@ -735,11 +737,11 @@ AMRNSLevel::setSalinityBC(LevelData<FArrayBox>&       a_S,
     Subspace::addHorizontalExtrusion(a_S, 0, *m_SbarPtr, 0, 1, -1.0);
     if (hasGhosts) {
         if (exCopiersAreCached) {
-            a_S.exchange(m_statePtr->qExCopier);
+            LayoutTools::exchange(a_S, m_statePtr->qExCopier);
         } else {
-            Copier cp;
-            m_statePtr->qDefineExCopier(cp, a_S);
-            a_S.exchange(cp);
+            const auto cpPtr = CopierCache::trimmedExchangeCopier(
+                a_S.getBoxes(), a_S.ghostVect());
+            LayoutTools::exchange(a_S, *cpPtr);
         }
     }
     Subspace::addHorizontalExtrusion(a_S, 0, *m_SbarPtr, 0, 1, 1.0);
@@ -753,11 +755,11 @@ AMRNSLevel::setSalinityBC(LevelData<FArrayBox>&       a_S,
     Subspace::addHorizontalExtrusion(a_S, 0, *m_SbarPtr, 0, 1, -1.0);
     if (hasGhosts) {
         if (exCopiersAreCached) {
-            a_S.exchange(m_statePtr->qExCornerCopier);
+            LayoutTools::exchange(a_S, m_statePtr->qExCornerCopier);
         } else {
-            CornerCopier ccp;
-            m_statePtr->qDefineExCornerCopier(ccp, a_S);
-            a_S.exchange(ccp);
+            const auto ccpPtr = CornerCopier::cachedExchangeCopier(
+                a_S.getBoxes(), a_S.ghostVect());
+            LayoutTools::exchange(a_S, *ccpPtr);
         }
     }
 
@@ -836,11 +838,11 @@ AMRNSLevel::setScalarBC(LevelData<FArrayBox>&       a_s,
     // This must be done before we potentially call BCTools::neum.
     if (hasGhosts) {
         if (exCopiersAreCached) {
-            a_s.exchange(m_statePtr->qExCopier);
+            LayoutTools::exchange(a_s, m_statePtr->qExCopier);
         } else {
-            Copier cp;
-            m_statePtr->qDefineExCopier(cp, a_s);
-            a_s.exchange(cp);
+            const auto cpPtr = CopierCache::trimmedExchangeCopier(
+                a_s.getBoxes(), a_s.ghostVect());
+            LayoutTools::exchange(a_s, *cpPtr);
         }
     }
 
@@ -851,11 +853,11 @@ AMRNSLevel::setScalarBC(LevelData<FArrayBox>&       a_s,
     // This must be done after all other ghosts are filled.
     if (hasGhosts) {
         if (exCopiersAreCached) {
-            a_s.exchange(m_statePtr->qExCornerCopier);
+            LayoutTools::exchange(a_s, m_statePtr->qExCornerCopier);
         } else {
-            CornerCopier ccp;
-            m_statePtr->qDefineExCornerCopier(ccp, a_s);
-            a_s.exchange(ccp);
+            const auto ccpPtr = CornerCopier::cachedExchangeCopier(
+                a_s.getBoxes(), a_s.ghostVect());
+            LayoutTools::exchange(a_s, *ccpPtr);
         }
     }
 
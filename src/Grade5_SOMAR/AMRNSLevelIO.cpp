@@ -29,15 +29,107 @@
 #include "Subspace.H"
 #include "Masks.H"
 #include "ProblemContext.H"
+#include "HDF5Checkpoint.H"
+#include "AsyncPlotWriter.H"
 #ifdef CH_USE_PYTHON
 #include "PyGlue.H"
 #endif
 
 
-// #define WRITE_METRIC_TO_HDF5
-// #define WRITE_GRADP_TO_HDF5
-// #define WRITE_Sij_TO_HDF5
-// #define WRITE_VORTICITY_TO_HDF5
+#ifdef SOMAR_USE_HDF5
+namespace {
+// The open checkpoint, when output.nativeCheckpoint is set. Lives between
+// openFile and closeFile.
+std::unique_ptr<HDF5CheckpointWriter> s_chkWriterPtr;
+
+// When output.asyncPlot is set, plotfiles are collected here between
+// openFile and closeFile, then handed to the background writer.
+std::unique_ptr<AsyncPlotWriter::Snapshot> s_plotSnapPtr;
+std::unique_ptr<AsyncPlotWriter>           s_asyncPlotWriterPtr;
+
+// The open plotfile, when output.nativePlot is set and output.asyncPlot is
+// not. Lives between openFile and closeFile.
+std::unique_ptr<HDF5PlotWriter> s_plotWriterPtr;
+
+
+// The plotfile filters requested in the input file, minus the ones this HDF5
+// library cannot provide.
+const HDF5PlotWriter::Compression&
+getPlotCompression()
+{
+    static const HDF5PlotWriter::Compression compression = [] {
+        const auto& output = ProblemContext::getInstance()->output;
+
+        HDF5PlotWriter::Compression comp;
+        comp.deflateLevel  = output.plotCompression;
+        comp.shuffle       = output.plotShuffle;
+        comp.decimalDigits = output.plotDecimalDigits;
+        return HDF5PlotWriter::validate(comp);
+    }();
+    return compression;
+}
+};
+#endif
+
+
+// -----------------------------------------------------------------------------
+// The fields that output.plotFields can select, in the order they are written.
+// -----------------------------------------------------------------------------
+static const std::vector<std::string>&
+allPlotFields()
+{
+    static const std::vector<std::string> fields = {
+        "scalars", "vel",    "divVel", "p",         "T",
+        "S",       "b",      "Tpert",  "Spert",     "bpert",
+        "eddyNu",  "gradP",  "metric", "Sij",       "vorticity",
+        "displacement"};
+    return fields;
+}
+
+
+// -----------------------------------------------------------------------------
+// Is a_field in the plotfile? If output.plotFields is not set, we write
+// everything but gradP, metric, Sij, and vorticity.
+// -----------------------------------------------------------------------------
+static bool
+isPlotFieldSelected(const std::string& a_field)
+{
+    const auto& selected = ProblemContext::getInstance()->output.plotFields;
+
+    if (selected.empty()) {
+        return a_field != "gradP" && a_field != "metric" && a_field != "Sij" &&
+               a_field != "vorticity";
+    }
+    return std::find(selected.begin(), selected.end(), a_field) !=
+           selected.end();
+}
+
+
+// -----------------------------------------------------------------------------
+// Sends header data to the native checkpoint writer or the plotfile snapshot,
+// if one is open, or to the Python IO module.
+// -----------------------------------------------------------------------------
+static void
+writeHeaderData(const HeaderData&  a_header,
+                const std::string& a_fileName,
+                const std::string& a_groupName)
+{
+#ifdef SOMAR_USE_HDF5
+    if (s_chkWriterPtr && s_chkWriterPtr->fileName() == a_fileName) {
+        s_chkWriterPtr->writeHeader(a_header, a_groupName);
+        return;
+    }
+    if (s_plotSnapPtr && s_plotSnapPtr->fileName == a_fileName) {
+        s_plotSnapPtr->addHeader(a_header, a_groupName);
+        return;
+    }
+    if (s_plotWriterPtr && s_plotWriterPtr->fileName() == a_fileName) {
+        s_plotWriterPtr->writeHeader(a_header, a_groupName);
+        return;
+    }
+#endif
+    a_header.writeToFile(a_fileName, a_groupName);
+}
 
 // -----------------------------------------------------------------------------
 // write checkpoint header
@@ -47,6 +139,7 @@ AMRNSLevel::writeCheckpointHeader(HeaderData&        header,
                                   const std::string& a_filename) const
 {
     BEGIN_FLOWCHART();
+    PhaseTimer::Scope phaseTimer("I/O", m_level);
 
     const ProblemContext* ctx = ProblemContext::getInstance();
     char comp_str[80];
@@ -59,7 +152,7 @@ AMRNSLevel::writeCheckpointHeader(HeaderData&        header,
         HeaderData temp;
         temp.m_int["SpaceDim"]  = SpaceDim;
         temp.m_real["testReal"] = (Real)0.0;
-        temp.writeToFile(a_filename, std::string("Chombo_global"));
+        writeHeaderData(temp, a_filename, std::string("Chombo_global"));
     }
 
     // AMR parameters
@@ -129,7 +222,7 @@ AMRNSLevel::writeCheckpointHeader(HeaderData&        header,
     header.m_int["numQComps"] = m_statePtr->numQComps;
 
     // Write the metadata to HDF5 and pout.*
-    header.writeToFile(a_filename, std::string("/"));
+    writeHeaderData(header, a_filename, std::string("/"));
     if (s_verbosity >= 6) {
         pout() << header << endl;
     }
@@ -143,6 +236,7 @@ void
 AMRNSLevel::writeCheckpointLevel(const std::string& a_fileName, int /*level*/) const
 {
     BEGIN_FLOWCHART();
+    PhaseTimer::Scope phaseTimer("I/O", m_level);
 
     // Set group for this level.
     char level_str[20];
@@ -164,13 +258,21 @@ AMRNSLevel::writeCheckpointLevel(const std::string& a_fileName, int /*level*/) c
     header.m_int["finestExtantLevel"] = this->finestNSPtr()->m_level;
 
     // Write the metadata to file and pout.*
-    header.writeToFile(a_fileName, label);
+    writeHeaderData(header, a_fileName, label);
     if (s_verbosity >= 6) {
         pout() << header << endl;
     }
 
     // If this level has valid data, we need to write it to HDF5.
     if (!this->isEmpty()) {
+#ifdef SOMAR_USE_HDF5
+        if (s_chkWriterPtr && s_chkWriterPtr->fileName() == a_fileName) {
+            s_chkWriterPtr->write(*m_velPtr, label, "velData", IntVect::Unit);
+            s_chkWriterPtr->write(*m_pPtr, label, "pData", IntVect::Unit);
+            s_chkWriterPtr->write(*m_qPtr, label, "qData", IntVect::Unit);
+            return;
+        }
+#endif
 #ifdef CH_USE_PYTHON
         std::string name = "velData";
         Py::PythonFunction("IO",
@@ -207,6 +309,7 @@ void
 AMRNSLevel::readCheckpointHeader(const std::string& a_fileName)
 {
     BEGIN_FLOWCHART();
+    PhaseTimer::Scope phaseTimer("I/O", m_level);
 
     const ProblemContext* ctx = ProblemContext::getInstance();
     char comp_str[80];
@@ -548,6 +651,7 @@ void
 AMRNSLevel::readCheckpointLevel(const std::string& a_filename)
 {
     BEGIN_FLOWCHART();
+    PhaseTimer::Scope phaseTimer("I/O", m_level);
 
 #ifdef CH_USE_PYTHON
     const ProblemContext* ctx = ProblemContext::getInstance();
@@ -629,70 +733,96 @@ AMRNSLevel::readCheckpointLevel(const std::string& a_filename)
     // const int finestExtantLevel = header.m_int["finestExtantLevel"];
 
     // Read and create level grids
+#ifdef SOMAR_USE_HDF5
+    // The native reader only touches the datasets of this rank's boxes.
+    std::unique_ptr<HDF5CheckpointReader> readerPtr;
+    if (ctx->output.nativeCheckpoint) {
+        readerPtr.reset(new HDF5CheckpointReader(a_filename));
+    }
+#endif
 
-    const int status =
-        Py::PythonReturnFunction<int>("IO", "OpenFileForRead", a_filename);
-    if (status < 0) MayDay::Error("We can't seem to read data from a_filename");
+    const std::string levelGroup = "level_" + std::to_string(m_level);
+    Vector<Box> boxArrayFromFile;
+    Vector<int> procMap;
 
-    const int grid_size =
-      Py::PythonReturnFunction<int>("IO", "SizeOfBoxLayout", a_filename, m_level);
-    if (grid_size == 0) {
+#ifdef SOMAR_USE_HDF5
+    if (readerPtr) {
+        readerPtr->readBoxLayout(boxArrayFromFile, procMap, levelGroup);
+    } else
+#endif
+    {
+        const int status =
+            Py::PythonReturnFunction<int>("IO", "OpenFileForRead", a_filename);
+        if (status < 0) MayDay::Error("We can't seem to read data from a_filename");
+
+        const int grid_size = Py::PythonReturnFunction<int>(
+            "IO", "SizeOfBoxLayout", a_filename, m_level);
+        boxArrayFromFile.resize(grid_size);
+        procMap.resize(grid_size);
+        for (int i = 0; i < grid_size; ++i) {
+            boxArrayFromFile[i] = Py::PythonReturnFunction<Box>(
+                "IO", "GetBox", a_filename, m_level, i);
+            procMap[i] = Py::PythonReturnFunction<int>(
+                "IO", "getProcID", a_filename, m_level, i);
+        }
+    }
+    if (boxArrayFromFile.size() == 0) {
         MayDay::Warning("Checkfile does not contain a disjointBoxLayout");
     }
-    Vector<Box> boxArrayFromFile(grid_size);
-    for (unsigned int i = 0; i < boxArrayFromFile.size(); ++i) {
-        int j = (int)i;
-        boxArrayFromFile[i] =
-	  Py::PythonReturnFunction<Box>("IO", "GetBox", a_filename, m_level, j);
-      }
-      Vector<int> procMap(grid_size);
-      for (unsigned int i = 0; i < boxArrayFromFile.size(); ++i)
-      {
-          int j = (int)i;
-          procMap[i] =
-	    Py::PythonReturnFunction<int>("IO", "getProcID", a_filename, m_level, j);
-      }
-
-          // If this level has valid data, read it now.
-          if (boxArrayFromFile.size() > 0) {
-              // Allocate and define everything on this level.
-              // These must be called from bottom to top level.
-
-              this->activateLevel(boxArrayFromFile, procMap);
-
-
-              // Final checks...
-              for (int dir = 0; dir < SpaceDim; ++dir) {
-                  if (RealCmp::neq(vec_dx[dir], m_levGeoPtr->getDXi(dir))) {
-                      ostringstream msg;
-                      msg << "vec_dx[" << dir << "] changed from "
-                          << vec_dx[dir] << " to " << m_levGeoPtr->getDXi(dir)
-                          << ".";
-                      MayDay::Error(msg.str().c_str());
-                  }
-              }
-              // Read the data
-              std::string vel = std::string("velData");
-              std::string p   = std::string("pData");
-              std::string q   = std::string("qData");
-              Py::PythonFunction("IO", "ReadFB", a_filename, m_level, *m_velPtr, vel);
-              Py::PythonFunction("IO", "ReadFAB", a_filename,  m_level, *m_pPtr, p);
-              Py::PythonFunction("IO", "ReadFAB", a_filename, m_level, *m_qPtr, q);
-
-              Py::PythonFunction("IO", "CloseFile", a_filename);
-              m_velPtr->exchange();
-              m_qPtr->exchange();
-              m_pPtr->exchange();
-
-              // Reset BCs.
-              this->setBC(*m_statePtr, m_time);
-
-          } else {
-              // Level is empty.
-
-	    Py::PythonFunction("IO", "CloseFile", a_filename);
-              this->deactivateLevel();
-          }
+
+    // If this level has valid data, read it now.
+    if (boxArrayFromFile.size() > 0) {
+        // Allocate and define everything on this level.
+        // These must be called from bottom to top level.
+        // An empty procMap lets activateLevel load balance the boxes itself.
+        this->activateLevel(boxArrayFromFile, procMap);
+
+        // Final checks...
+        for (int dir = 0; dir < SpaceDim; ++dir) {
+            if (RealCmp::neq(vec_dx[dir], m_levGeoPtr->getDXi(dir))) {
+                ostringstream msg;
+                msg << "vec_dx[" << dir << "] changed from "
+                    << vec_dx[dir] << " to " << m_levGeoPtr->getDXi(dir)
+                    << ".";
+                MayDay::Error(msg.str().c_str());
+            }
+        }
+
+        // Read the data
+        const std::string vel = std::string("velData");
+        const std::string p   = std::string("pData");
+        const std::string q   = std::string("qData");
+#ifdef SOMAR_USE_HDF5
+        if (readerPtr) {
+            readerPtr->read(*m_velPtr, levelGroup, vel);
+            readerPtr->read(*m_pPtr, levelGroup, p);
+            readerPtr->read(*m_qPtr, levelGroup, q);
+        } else
+#endif
+        {
+            Py::PythonFunction("IO", "ReadFB", a_filename, m_level, *m_velPtr, vel);
+            Py::PythonFunction("IO", "ReadFAB", a_filename, m_level, *m_pPtr, p);
+            Py::PythonFunction("IO", "ReadFAB", a_filename, m_level, *m_qPtr, q);
+            Py::PythonFunction("IO", "CloseFile", a_filename);
+        }
+
+        m_velPtr->exchange();
+        m_qPtr->exchange();
+        m_pPtr->exchange();
+
+        // Reset BCs.
+        this->setBC(*m_statePtr, m_time);
+
+    } else {
+        // Level is empty.
+#ifdef SOMAR_USE_HDF5
+        if (!readerPtr)
+#endif
+        {
+            Py::PythonFunction("IO", "CloseFile", a_filename);
+        }
+        this->deactivateLevel();
+    }
 #endif
 }
 
@@ -703,6 +833,40 @@ AMRNSLevel::readCheckpointLevel(const std::string& a_filename)
 void
 AMRNSLevel::openFile(const std::string& a_filename, const bool checkpoint) const
 {
+#ifdef SOMAR_USE_HDF5
+    const ProblemContext* ctx = ProblemContext::getInstance();
+    if (!checkpoint && ctx->output.asyncPlot) {
+        if (!s_asyncPlotWriterPtr) {
+            s_asyncPlotWriterPtr.reset(new AsyncPlotWriter(
+                ctx->output.asyncPlotMaxMB, ctx->output.asyncPlotMaxMBps));
+        }
+        s_plotSnapPtr.reset(new AsyncPlotWriter::Snapshot(a_filename));
+        s_plotSnapPtr->singlePrecision = ctx->output.plotSinglePrecision;
+        s_plotSnapPtr->compression     = getPlotCompression();
+        if (s_plotSnapPtr->singlePrecision ||
+            s_plotSnapPtr->compression.isEnabled()) {
+            s_plotSnapPtr->compNames = this->getPlotComponentNames();
+        }
+        return;
+    }
+
+    // HDF5 may not be thread-safe. Let the background plotfile finish first.
+    if (s_asyncPlotWriterPtr) {
+        s_asyncPlotWriterPtr->wait();
+    }
+
+    if (checkpoint && ctx->output.nativeCheckpoint) {
+        s_chkWriterPtr.reset(new HDF5CheckpointWriter(a_filename));
+        return;
+    }
+
+    if (!checkpoint && ctx->output.nativePlot) {
+        s_plotWriterPtr.reset(new HDF5PlotWriter(a_filename));
+        s_plotWriterPtr->setSinglePrecision(ctx->output.plotSinglePrecision);
+        s_plotWriterPtr->setCompression(getPlotCompression());
+        return;
+    }
+#endif
 #ifdef CH_USE_PYTHON
 // if file exists, delete it
     Py::PythonFunction("IO", "DeleteIfFileExists", a_filename);
@@ -717,6 +881,25 @@ AMRNSLevel::openFile(const std::string& a_filename, const bool checkpoint) const
 void
 AMRNSLevel::closeFile(const std::string& a_filename) const
 {
+#ifdef SOMAR_USE_HDF5
+    if (s_chkWriterPtr && s_chkWriterPtr->fileName() == a_filename) {
+        s_chkWriterPtr.reset();
+        return;
+    }
+    if (s_plotSnapPtr && s_plotSnapPtr->fileName == a_filename) {
+        s_asyncPlotWriterPtr->submit(std::move(s_plotSnapPtr));
+        return;
+    }
+    if (s_plotWriterPtr && s_plotWriterPtr->fileName() == a_filename) {
+        const ProblemContext* ctx = ProblemContext::getInstance();
+        if (ctx->output.plotSinglePrecision ||
+            getPlotCompression().isEnabled()) {
+            s_plotWriterPtr->report(pout(), this->getPlotComponentNames());
+        }
+        s_plotWriterPtr.reset();
+        return;
+    }
+#endif
 #ifdef CH_USE_PYTHON
     Py::PythonFunction("IO", "CloseFile", a_filename);
 #endif
@@ -724,308 +907,129 @@ AMRNSLevel::closeFile(const std::string& a_filename) const
 
 
 // -----------------------------------------------------------------------------
-// Write plotfile header. Only called on level 0.
+// The names of the plotfile components, in the order they are written.
+// The fields are selected at runtime via output.plotFields.
 // -----------------------------------------------------------------------------
-void
-AMRNSLevel::writePlotHeader(HeaderData&        a_header,
-                            const std::string& a_filename) const
+std::vector<std::string>
+AMRNSLevel::getPlotComponentNames() const
 {
-    BEGIN_FLOWCHART();
-
-#ifdef CH_USE_PYTHON
-
-    // write some Chombo boilerplate to it (do we need it?)
-    {
-        HeaderData temp;
-        temp.m_int["SpaceDim"]  = SpaceDim;
-        temp.m_real["testReal"] = (Real)0.0;
-        temp.writeToFile(a_filename, std::string("Chombo_global"));
+    // Make sure we know what the user asked for.
+    for (const auto& field : ProblemContext::getInstance()->output.plotFields) {
+        const auto& all = allPlotFields();
+        if (std::find(all.begin(), all.end(), field) == all.end()) {
+            std::ostringstream validFields;
+            for (const auto& f : all) validFields << " " << f;
+            MAYDAYERROR("output.plotFields: " << field
+                        << " is not a valid field. Try one of:"
+                        << validFields.str());
+        }
     }
-    auto& header = a_header;
-    char comp_str[30];
-
-    // This MUST match numComps in writePlotLevel.
-    const int numComps = this->numScalars()
-                       + SpaceDim  // u,(v),w
-                       + 1         // divVel
-                       + 1         // p
-                       + 3         // T,S,b totals
-                       + 3         // T,S,b perturbations
-                       + 1         // eddy viscosity
-#ifdef WRITE_GRADP_TO_HDF5
-                       + SpaceDim  // gradP
-#endif //WRITE_GRADP_TO_HDF5
-#ifdef WRITE_METRIC_TO_HDF5
-                       + SpaceDim  // x^i(Xi)
-                       + SpaceDim  // dx^i/dXi^i
-                       + SpaceDim  // dXi^i/dx^i
-                       + SpaceDim  // Jg^{ii}
-                       + SpaceDim  // g^{ii}
-                       + SpaceDim  // g_{ii}
-                       + 1         // J
-                       + 1         // 1/J
-#endif //WRITE_METRIC_TO_HDF5
-#ifdef WRITE_Sij_TO_HDF5
-                       + SpaceDim * (SpaceDim + 1) / 2 // Sij
-#endif //WRITE_Sij_TO_HDF5
-#ifdef WRITE_VORTICITY_TO_HDF5
-                       + ((SpaceDim == 2) ? 1 : 3)
-#endif //WRITE_VORTICITY_TO_HDF5
-                       + SpaceDim; // Displacement
-    header.m_int["num_components"] = numComps;
-
-    // User-defined scalars
-    int comp = 0;
-    for (int sc = 0; sc < this->numScalars(); ++sc) {
-        sprintf(comp_str, "component_%d", comp);
-        header.m_string[comp_str] = this->getScalarName(sc);
-        comp++;
+    if (SpaceDim > 2 && isPlotFieldSelected("vorticity")) {
+        MAYDAYERROR("output.plotFields: vorticity is only available in 2D.");
     }
 
-    // Velocity
-    D_TERM(sprintf(comp_str, "component_%d", comp);
-           header.m_string[comp_str] = "x_vel";
-           comp++;
-           , sprintf(comp_str, "component_%d", comp);
-           header.m_string[comp_str] = "y_vel";
-           comp++;
-           , sprintf(comp_str, "component_%d", comp);
-           header.m_string[comp_str] = "z_vel";
-           comp++;)
-
-    // divVel
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "div_vel";
-    comp++;
-
-    // Pressure
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "pressure";
-    comp++;
-
-    // Total temperature
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "T_total";
-    comp++;
-
-    // Total salinity
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "S_total";
-    comp++;
-
-    // Total buoyancy
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "b_total";
-    comp++;
-
-    // Temperature perturbation
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "T_pert";
-    comp++;
-
-    // Salinity perturbation
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "S_pert";
-    comp++;
-
-    // Buoyancy perturbation
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "b_pert";
-    comp++;
-
-    // Eddy viscosity
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "eddyNu";
-    comp++;
+    const std::string xyz[3] = {"x", "y", "z"};
+    std::vector<std::string> names;
 
-#ifdef WRITE_GRADP_TO_HDF5
-    // gradP
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "x_gradP";
-    comp++;
-
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "y_gradP";
-    comp++;
-
-    if (SpaceDim > 2) {
-        sprintf(comp_str, "component_%d", comp);
-        header.m_string[comp_str] = "z_gradP";
-        comp++;
+    if (isPlotFieldSelected("scalars")) {
+        for (int sc = 0; sc < this->numScalars(); ++sc) {
+            names.push_back(this->getScalarName(sc));
+        }
     }
-#endif //WRITE_GRADP_TO_HDF5
-
-#ifdef WRITE_METRIC_TO_HDF5
-    // physCoor
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "x_physCoor";
-    comp++;
 
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "y_physCoor";
-    comp++;
-
-    if (SpaceDim > 2) {
-        sprintf(comp_str, "component_%d", comp);
-        header.m_string[comp_str] = "z_physCoor";
-        comp++;
+    if (isPlotFieldSelected("vel")) {
+        for (int d = 0; d < SpaceDim; ++d) names.push_back(xyz[d] + "_vel");
     }
 
-    // dxdXi
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "x_dxdXi";
-    comp++;
-
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "y_dxdXi";
-    comp++;
+    if (isPlotFieldSelected("divVel")) names.push_back("div_vel");
+    if (isPlotFieldSelected("p"))      names.push_back("pressure");
+    if (isPlotFieldSelected("T"))      names.push_back("T_total");
+    if (isPlotFieldSelected("S"))      names.push_back("S_total");
+    if (isPlotFieldSelected("b"))      names.push_back("b_total");
+    if (isPlotFieldSelected("Tpert"))  names.push_back("T_pert");
+    if (isPlotFieldSelected("Spert"))  names.push_back("S_pert");
+    if (isPlotFieldSelected("bpert"))  names.push_back("b_pert");
+    if (isPlotFieldSelected("eddyNu")) names.push_back("eddyNu");
 
-    if (SpaceDim > 2) {
-        sprintf(comp_str, "component_%d", comp);
-        header.m_string[comp_str] = "z_dxdXi";
-        comp++;
+    if (isPlotFieldSelected("gradP")) {
+        for (int d = 0; d < SpaceDim; ++d) names.push_back(xyz[d] + "_gradP");
     }
 
-    // dXidx
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "x_dXidx";
-    comp++;
-
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "y_dXidx";
-    comp++;
-
-    if (SpaceDim > 2) {
-        sprintf(comp_str, "component_%d", comp);
-        header.m_string[comp_str] = "z_dXidx";
-        comp++;
+    if (isPlotFieldSelected("metric")) {
+        for (const char* m : {"_physCoor", "_dxdXi", "_dXidx", "_Jgup", "_gup", "_gdn"}) {
+            for (int d = 0; d < SpaceDim; ++d) names.push_back(xyz[d] + m);
+        }
+        names.push_back("J");
+        names.push_back("Jinv");
     }
 
-    // Jgup
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "x_Jgup";
-    comp++;
-
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "y_Jgup";
-    comp++;
-
-    if (SpaceDim > 2) {
-        sprintf(comp_str, "component_%d", comp);
-        header.m_string[comp_str] = "z_Jgup";
-        comp++;
+    if (isPlotFieldSelected("Sij")) {
+        names.push_back("S_xx");
+        names.push_back("S_yy");
+        if (SpaceDim > 2) names.push_back("S_zz");
+        names.push_back("S_xy");
+        if (SpaceDim > 2) {
+            names.push_back("S_zx");
+            names.push_back("S_yz");
+        }
     }
 
-    // gup
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "x_gup";
-    comp++;
-
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "y_gup";
-    comp++;
-
-    if (SpaceDim > 2) {
-        sprintf(comp_str, "component_%d", comp);
-        header.m_string[comp_str] = "z_gup";
-        comp++;
+    if (isPlotFieldSelected("vorticity")) {
+        names.push_back("vorticity_z");
     }
 
-    // gdn
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "x_gdn";
-    comp++;
-
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "y_gdn";
-    comp++;
-
-    if (SpaceDim > 2) {
-        sprintf(comp_str, "component_%d", comp);
-        header.m_string[comp_str] = "z_gdn";
-        comp++;
-    }
-
-    // J
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "J";
-    comp++;
-
-    // Jinv
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "Jinv";
-    comp++;
-#endif //WRITE_METRIC_TO_HDF5
-
-#ifdef WRITE_Sij_TO_HDF5
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "S_xx";
-    comp++;
-
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "S_yy";
-    comp++;
-
-#if CH_SPACEDIM > 2
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "S_zz";
-    comp++;
-#endif
-
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "S_xy";
-    comp++;
+    if (isPlotFieldSelected("displacement")) {
+        for (int d = 0; d < SpaceDim; ++d) {
+            names.push_back(xyz[d] + "_Displacement");
+        }
+    }
 
-#if CH_SPACEDIM > 2
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "S_zx";
-    comp++;
+    if (names.empty()) {
+        MAYDAYERROR("output.plotFields does not select any components.");
+    }
 
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "S_yz";
-    comp++;
-#endif
-#endif //WRITE_Sij_TO_HDF5
+    return names;
+}
 
-#ifdef WRITE_VORTICITY_TO_HDF5
-#if CH_SPACEDIM > 2
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "vorticity_x";
-    comp++;
 
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "vorticity_y";
-    comp++;
-#endif
+// -----------------------------------------------------------------------------
+// Write plotfile header. Only called on level 0.
+// -----------------------------------------------------------------------------
+void
+AMRNSLevel::writePlotHeader(HeaderData&        a_header,
+                            const std::string& a_filename) const
+{
+    BEGIN_FLOWCHART();
+    PhaseTimer::Scope phaseTimer("I/O", m_level);
 
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "vorticity_z";
-    comp++;
-#endif //WRITE_VORTICITY_TO_HDF5
+#if defined(CH_USE_PYTHON) || defined(SOMAR_USE_HDF5)
 
-    // Displacement
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "x_Displacement";
-    comp++;
+    // write some Chombo boilerplate to it (do we need it?)
+    {
+        HeaderData temp;
+        temp.m_int["SpaceDim"]  = SpaceDim;
+        temp.m_real["testReal"] = (Real)0.0;
+        writeHeaderData(temp, a_filename, std::string("Chombo_global"));
+    }
+    auto& header = a_header;
+    char comp_str[30];
 
-    sprintf(comp_str, "component_%d", comp);
-    header.m_string[comp_str] = "y_Displacement";
-    comp++;
+    // writePlotLevel fills the components in this order.
+    const std::vector<std::string> compNames = this->getPlotComponentNames();
+    const int                      numComps  = compNames.size();
+    header.m_int["num_components"] = numComps;
 
-    if constexpr (SpaceDim > 2) {
+    for (int comp = 0; comp < numComps; ++comp) {
         sprintf(comp_str, "component_%d", comp);
-        header.m_string[comp_str] = "z_Displacement";
-        comp++;
+        header.m_string[comp_str] = compNames[comp];
     }
 
-    CH_assert(comp == numComps);
-
-    header.writeToFile(a_filename, std::string("/"));
+    writeHeaderData(header, a_filename, std::string("/"));
 
     if (s_verbosity >= 5) {
         pout() << header << endl;
     }
-#endif //CH_USE_PYTHON
+#endif
 }
 
 
@@ -1036,6 +1040,7 @@ void
 AMRNSLevel::writePlotLevel(const std::string& a_filename, int /*level*/) const
 {
     BEGIN_FLOWCHART();
+    PhaseTimer::Scope phaseTimer("I/O", m_level);
 
     char level_str[20];
     sprintf(level_str, "%d", m_level);
@@ -1048,46 +1053,22 @@ AMRNSLevel::writePlotLevel(const std::string& a_filename, int /*level*/) const
     header.m_real["dt"]           = m_dt;
     header.m_real["time"]         = m_time;
     header.m_box["prob_domain"]   = m_problem_domain.domainBox();
-    header.writeToFile(a_filename, label);
+    writeHeaderData(header, a_filename, label);
 
     // if (s_verbosity >= 5) {
     //   pout() << header << endl;
     // }
 
-    // This MUST match numComps in writePlotHeader.
-    const int numComps = this->numScalars()
-                       + SpaceDim  // u,(v),w
-                       + 1         // divVel
-                       + 1         // p
-                       + 3         // T,S,b totals
-                       + 3         // T,S,b perturbations
-                       + 1         // eddy viscosity
-#ifdef WRITE_GRADP_TO_HDF5
-                       + SpaceDim  // gradP
-#endif //WRITE_GRADP_TO_HDF5
-#ifdef WRITE_METRIC_TO_HDF5
-                       + SpaceDim  // x^i(Xi)
-                       + SpaceDim  // dx^i/dXi^i
-                       + SpaceDim  // dXi^i/dx^i
-                       + SpaceDim  // Jg^{ii}
-                       + SpaceDim  // g^{ii}
-                       + SpaceDim  // g_{ii}
-                       + 1         // J
-                       + 1         // 1/J
-#endif //WRITE_METRIC_TO_HDF5
-#ifdef WRITE_Sij_TO_HDF5
-                       + SpaceDim * (SpaceDim + 1) / 2
-#endif //WRITE_Sij_TO_HDF5
-#ifdef WRITE_VORTICITY_TO_HDF5
-                       + ((SpaceDim == 2) ? 1 : 3)
-#endif //WRITE_VORTICITY_TO_HDF5
-                       + SpaceDim; // Displacement
+    const int numComps = this->getPlotComponentNames().size();
 
     const DisjointBoxLayout& grids = m_levGeoPtr->getBoxes();
     DataIterator dit = grids.dataIterator();
 
-    // One ghost helps VisIt's interpolation
-    LevelData<FArrayBox> plotData(grids, numComps, IntVect::Unit);
+    // One ghost helps VisIt's interpolation. This is allocated on the heap so
+    // that an async plotfile can take it over instead of copying it.
+    auto plotDataPtr = std::make_unique<LevelData<FArrayBox>>(
+        grids, numComps, IntVect::Unit);
+    LevelData<FArrayBox>& plotData = *plotDataPtr;
 
     // Two ghosts help us convert the FC vel to CC with fourth-order accuracy.
     const LevelData<FluxBox>& cartVel = m_statePtr->vel;
@@ -1099,7 +1080,7 @@ AMRNSLevel::writePlotLevel(const std::string& a_filename, int /*level*/) const
 
     // User-defined scalars
     int comp = 0;
-    if (this->numScalars() > 0) {
+    if (isPlotFieldSelected("scalars") && this->numScalars() > 0) {
         LevelData<FArrayBox> dest;
         const Interval destIvl(comp, comp + this->numScalars() - 1);
         aliasLevelData(dest, &plotData, destIvl);
@@ -1112,7 +1093,7 @@ AMRNSLevel::writePlotLevel(const std::string& a_filename, int /*level*/) const
     }
 
     // Velocity
-    {
+    if (isPlotFieldSelected("vel")) {
         LevelData<FArrayBox> dest;
         aliasLevelData(dest, &plotData, Interval(comp, comp + SpaceDim - 1));
 
@@ -1157,7 +1138,7 @@ AMRNSLevel::writePlotLevel(const std::string& a_filename, int /*level*/) const
     }
 
     // divVel
-    {
+    if (isPlotFieldSelected("divVel")) {
         LevelData<FArrayBox> dest;
         aliasLevelData(dest, &plotData, Interval(comp, comp));
 
@@ -1196,7 +1177,7 @@ AMRNSLevel::writePlotLevel(const std::string& a_filename, int /*level*/) const
     }
 
     // pressure
-    {
+    if (isPlotFieldSelected("p")) {
         LevelData<FArrayBox> dest;
         aliasLevelData(dest, &plotData, Interval(comp, comp));
 
@@ -1208,7 +1189,7 @@ AMRNSLevel::writePlotLevel(const std::string& a_filename, int /*level*/) const
     }
 
     // Total temperature
-    {
+    if (isPlotFieldSelected("T")) {
         LevelData<FArrayBox> dest;
         aliasLevelData(dest, &plotData, Interval(comp, comp));
 
@@ -1220,7 +1201,7 @@ AMRNSLevel::writePlotLevel(const std::string& a_filename, int /*level*/) const
     }
 
     // Total salinity
-    {
+    if (isPlotFieldSelected("S")) {
         LevelData<FArrayBox> dest;
         aliasLevelData(dest, &plotData, Interval(comp, comp));
 
@@ -1232,9 +1213,14 @@ AMRNSLevel::writePlotLevel(const std::string& a_filename, int /*level*/) const
     }
 
     // Total buoyancy
-    LevelData<FArrayBox> b; // We're gonna need this later.
-    {
-        aliasLevelData(b, &plotData, Interval(comp, comp));
+    LevelData<FArrayBox> b; // The perturbation needs this too.
+    if (isPlotFieldSelected("b") || isPlotFieldSelected("bpert")) {
+        if (isPlotFieldSelected("b")) {
+            aliasLevelData(b, &plotData, Interval(comp, comp));
+            comp += 1;
+        } else {
+            b.define(grids, 1, IntVect::Unit);
+        }
 
         for (dit.reset(); dit.ok(); ++dit) {
             FArrayBox zFAB(b[dit].box(), 1);
@@ -1242,12 +1228,10 @@ AMRNSLevel::writePlotLevel(const std::string& a_filename, int /*level*/) const
             this->equationOfState(
                 b[dit], m_statePtr->T[dit], m_statePtr->S[dit], zFAB);
         }
-
-        comp += 1;
     }
 
     // Temperature perturbation
-    {
+    if (isPlotFieldSelected("Tpert")) {
         LevelData<FArrayBox> dest;
         aliasLevelData(dest, &plotData, Interval(comp, comp));
 
@@ -1261,7 +1245,7 @@ AMRNSLevel::writePlotLevel(const std::string& a_filename, int /*level*/) const
     }
 
     // Salinity perturbation
-    {
+    if (isPlotFieldSelected("Spert")) {
         LevelData<FArrayBox> dest;
         aliasLevelData(dest, &plotData, Interval(comp, comp));
 
@@ -1275,7 +1259,7 @@ AMRNSLevel::writePlotLevel(const std::string& a_filename, int /*level*/) const
     }
 
     // Buoyancy perturbation
-    {
+    if (isPlotFieldSelected("bpert")) {
         LevelData<FArrayBox> dest;
         aliasLevelData(dest, &plotData, Interval(comp, comp));
 
@@ -1289,7 +1273,7 @@ AMRNSLevel::writePlotLevel(const std::string& a_filename, int /*level*/) const
     }
 
     // eddyNu
-    {
+    if (isPlotFieldSelected("eddyNu")) {
         // In incremental PARK, eddyNu is already filled, but in standard form,
         // eddyNu is all zeros. This happens because RK in standard form always
         // starts with q^{n} and adds forces to it. But there are no forces that
@@ -1312,9 +1296,8 @@ AMRNSLevel::writePlotLevel(const std::string& a_filename, int /*level*/) const
         comp += 1;
     }
 
-#ifdef WRITE_GRADP_TO_HDF5
     // gradP
-    {
+    if (isPlotFieldSelected("gradP")) {
         LevelData<FArrayBox> dest;
         aliasLevelData(dest, &plotData, Interval(comp, comp + SpaceDim - 1));
 
@@ -1333,124 +1316,123 @@ AMRNSLevel::writePlotLevel(const std::string& a_filename, int /*level*/) const
 
         comp += SpaceDim;
     }
-#endif //WRITE_GRADP_TO_HDF5
 
-#ifdef WRITE_METRIC_TO_HDF5
-    // physCoor
-    {
-        LevelData<FArrayBox> dest;
-        aliasLevelData(dest, &plotData, Interval(comp, comp + SpaceDim - 1));
+    if (isPlotFieldSelected("metric")) {
+        // physCoor
+        {
+            LevelData<FArrayBox> dest;
+            aliasLevelData(dest, &plotData, Interval(comp, comp + SpaceDim - 1));
 
-        for (dit.reset(); dit.ok(); ++dit) {
-            m_levGeoPtr->fill_physCoor(dest[dit]);
-        }
+            for (dit.reset(); dit.ok(); ++dit) {
+                m_levGeoPtr->fill_physCoor(dest[dit]);
+            }
 
-        comp += SpaceDim;
-    }
+            comp += SpaceDim;
+        }
 
-    // dxdXi
-    {
-        LevelData<FArrayBox> dest;
-        aliasLevelData(dest, &plotData, Interval(comp, comp + SpaceDim - 1));
+        // dxdXi
+        {
+            LevelData<FArrayBox> dest;
+            aliasLevelData(dest, &plotData, Interval(comp, comp + SpaceDim - 1));
 
-        for (dit.reset(); dit.ok(); ++dit) {
-            for (int d = 0; d < SpaceDim; ++d) {
-                m_levGeoPtr->getGeoSource().fill_dxdXi(
-                    dest[dit], d, d, m_levGeoPtr->getDXi());
+            for (dit.reset(); dit.ok(); ++dit) {
+                for (int d = 0; d < SpaceDim; ++d) {
+                    m_levGeoPtr->getGeoSource().fill_dxdXi(
+                        dest[dit], d, d, m_levGeoPtr->getDXi());
+                }
             }
-        }
 
-        comp += SpaceDim;
-    }
+            comp += SpaceDim;
+        }
 
-    // dXidx
-    {
-        LevelData<FArrayBox> dest;
-        aliasLevelData(dest, &plotData, Interval(comp, comp + SpaceDim - 1));
+        // dXidx
+        {
+            LevelData<FArrayBox> dest;
+            aliasLevelData(dest, &plotData, Interval(comp, comp + SpaceDim - 1));
 
-        for (dit.reset(); dit.ok(); ++dit) {
-            for (int d = 0; d < SpaceDim; ++d) {
-                m_levGeoPtr->getGeoSource().fill_dXidx(
-                    dest[dit], d, d, m_levGeoPtr->getDXi());
+            for (dit.reset(); dit.ok(); ++dit) {
+                for (int d = 0; d < SpaceDim; ++d) {
+                    m_levGeoPtr->getGeoSource().fill_dXidx(
+                        dest[dit], d, d, m_levGeoPtr->getDXi());
+                }
             }
-        }
 
-        comp += SpaceDim;
-    }
-
-    // Jgup
-    {
-        LevelData<FArrayBox> dest;
-        aliasLevelData(dest, &plotData, Interval(comp, comp + SpaceDim - 1));
-        Convert::FacesToCells(dest, m_levGeoPtr->getFCJgup());
-        // for (dit.reset(); dit.ok(); ++dit) {
-        //     for (int d = 0; d < SpaceDim; ++d) {
-        //         m_levGeoPtr->getGeoSource().fill_Jgup(
-        //             dest[dit], d, d, m_levGeoPtr->getDXi());
-        //     }
-        // }
+            comp += SpaceDim;
+        }
 
-        comp += SpaceDim;
-    }
+        // Jgup
+        {
+            LevelData<FArrayBox> dest;
+            aliasLevelData(dest, &plotData, Interval(comp, comp + SpaceDim - 1));
+            Convert::FacesToCells(dest, m_levGeoPtr->getFCJgup());
+            // for (dit.reset(); dit.ok(); ++dit) {
+            //     for (int d = 0; d < SpaceDim; ++d) {
+            //         m_levGeoPtr->getGeoSource().fill_Jgup(
+            //             dest[dit], d, d, m_levGeoPtr->getDXi());
+            //     }
+            // }
+
+            comp += SpaceDim;
+        }
 
-    // gup
-    {
-        LevelData<FArrayBox> dest;
-        aliasLevelData(dest, &plotData, Interval(comp, comp + SpaceDim - 1));
+        // gup
+        {
+            LevelData<FArrayBox> dest;
+            aliasLevelData(dest, &plotData, Interval(comp, comp + SpaceDim - 1));
 
-        for (dit.reset(); dit.ok(); ++dit) {
-            for (int d = 0; d < SpaceDim; ++d) {
-                m_levGeoPtr->getGeoSource().fill_gup(
-                    dest[dit], d, d, m_levGeoPtr->getDXi());
+            for (dit.reset(); dit.ok(); ++dit) {
+                for (int d = 0; d < SpaceDim; ++d) {
+                    m_levGeoPtr->getGeoSource().fill_gup(
+                        dest[dit], d, d, m_levGeoPtr->getDXi());
+                }
             }
-        }
 
-        comp += SpaceDim;
-    }
+            comp += SpaceDim;
+        }
 
-    // gdn
-    {
-        LevelData<FArrayBox> dest;
-        aliasLevelData(dest, &plotData, Interval(comp, comp + SpaceDim - 1));
+        // gdn
+        {
+            LevelData<FArrayBox> dest;
+            aliasLevelData(dest, &plotData, Interval(comp, comp + SpaceDim - 1));
 
-        for (dit.reset(); dit.ok(); ++dit) {
-            for (int d = 0; d < SpaceDim; ++d) {
-                m_levGeoPtr->getGeoSource().fill_gdn(
-                    dest[dit], d, d, m_levGeoPtr->getDXi());
+            for (dit.reset(); dit.ok(); ++dit) {
+                for (int d = 0; d < SpaceDim; ++d) {
+                    m_levGeoPtr->getGeoSource().fill_gdn(
+                        dest[dit], d, d, m_levGeoPtr->getDXi());
+                }
             }
+
+            comp += SpaceDim;
         }
 
-        comp += SpaceDim;
-    }
+        // J
+        {
+            LevelData<FArrayBox> dest;
+            aliasLevelData(dest, &plotData, Interval(comp, comp));
 
-    // J
-    {
-        LevelData<FArrayBox> dest;
-        aliasLevelData(dest, &plotData, Interval(comp, comp));
+            for (dit.reset(); dit.ok(); ++dit) {
+                dest[dit].copy(m_levGeoPtr->getCCJ()[dit]);
+            }
 
-        for (dit.reset(); dit.ok(); ++dit) {
-            dest[dit].copy(m_levGeoPtr->getCCJ()[dit]);
+            comp += 1;
         }
 
-        comp += 1;
-    }
+        // Jinv
+        {
+            LevelData<FArrayBox> dest;
+            aliasLevelData(dest, &plotData, Interval(comp, comp));
 
-    // Jinv
-    {
-        LevelData<FArrayBox> dest;
-        aliasLevelData(dest, &plotData, Interval(comp, comp));
+            for (dit.reset(); dit.ok(); ++dit) {
+                dest[dit].copy(m_levGeoPtr->getCCJinv()[dit]);
+            }
 
-        for (dit.reset(); dit.ok(); ++dit) {
-            dest[dit].copy(m_levGeoPtr->getCCJinv()[dit]);
+            comp += 1;
         }
-
-        comp += 1;
-    }
-#endif //WRITE_METRIC_TO_HDF5
+    } // end if metric
 
 
-#ifdef WRITE_Sij_TO_HDF5
-    {
+    // Sij
+    if (isPlotFieldSelected("Sij")) {
         const RealVect nuDummy(D_DECL(0.5, 0.5, 0.5));
 
         LevelData<FArrayBox> eddyNuDummy(grids, 1, IntVect::Unit);
@@ -1484,10 +1466,9 @@ AMRNSLevel::writePlotLevel(const std::string& a_filename, int /*level*/) const
             }
         }
     }
-#endif //WRITE_Sij_TO_HDF5
 
-#ifdef WRITE_VORTICITY_TO_HDF5
-    if (SpaceDim == 2) {
+    // Vorticity
+    if (isPlotFieldSelected("vorticity")) {
         LevelData<FArrayBox> dest;
         aliasLevelData(dest, &plotData, Interval(comp, comp));
         ++comp;
@@ -1523,13 +1504,10 @@ AMRNSLevel::writePlotLevel(const std::string& a_filename, int /*level*/) const
             m_levGeoPtr->divByJ(dest[dit], dit());
         }
 
-    } else {
-        UNDEFINED_FUNCTION();
     }
-#endif //WRITE_VORTICITY_TO_HDF5
 
     // Displacement
-    {
+    if (isPlotFieldSelected("displacement")) {
         LevelData<FArrayBox> dest;
         aliasLevelData(dest, &plotData, Interval(comp, comp + SpaceDim - 1));
 
@@ -1546,8 +1524,19 @@ AMRNSLevel::writePlotLevel(const std::string& a_filename, int /*level*/) const
     BCTools::extrapAllGhosts(plotData, 2);
     plotData.exchange();
 
+#ifdef SOMAR_USE_HDF5
+    if (s_plotSnapPtr && s_plotSnapPtr->fileName == a_filename) {
+        s_plotSnapPtr->addField(
+            std::move(plotDataPtr), label, name, IntVect::Unit);
+        return;
+    }
+    if (s_plotWriterPtr && s_plotWriterPtr->fileName() == a_filename) {
+        s_plotWriterPtr->write(plotData, label, name, IntVect::Unit);
+        return;
+    }
+#endif
 #ifdef CH_USE_PYTHON
-    // Bottleneck! (But we don't need to call this often.)
+    // Bottleneck! Only used when output.nativePlot is off.
     Py::PythonFunction("IO",
                        "WriteLevelDataFAB",
                        a_filename,
@@ -1557,3 +1546,22 @@ AMRNSLevel::writePlotLevel(const std::string& a_filename, int /*level*/) const
                        IntVect::Unit);
 #endif
 }
+
+
+// -----------------------------------------------------------------------------
+// Called at the end of the run.
+// -----------------------------------------------------------------------------
+void
+AMRNSLevel::conclude(int /*a_step*/) const
+{
+    if (m_level == 0) {
+        this->closeProbes();
+    }
+
+#ifdef SOMAR_USE_HDF5
+    // Collective. Every rank has level 0.
+    if (m_level == 0) {
+        s_asyncPlotWriterPtr.reset();
+    }
+#endif
+}
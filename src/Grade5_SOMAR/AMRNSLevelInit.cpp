@@ -66,7 +66,8 @@ AMRNSLevel::AMRNSLevel()
   m_velFluxRegPtr(nullptr),
   m_qFluxRegPtr(nullptr),
   m_c1(quietNAN),
-  m_parkPtr(nullptr)
+  m_parkPtr(nullptr),
+  m_keepGridsOnRegrid(false)
 {
     // Set by base constructor:
     // m_coarser_level_ptr = nullptr;
@@ -353,21 +354,7 @@ AMRNSLevel::deactivateLevel()
     m_amrOpsValid       = false;
     m_amrSolversValid   = false;
 
-    if (m_level > 0) {
-        // The next coarser level's AMR ops and solvers depend on this level
-        // for refluxing, so they get invalidated.
-        AMRNSLevel* levPtr = this->crseNSPtr();
-        CH_assert(levPtr);
-        levPtr->m_amrOpsValid       = false;
-        levPtr->m_amrSolversValid   = false;
-
-        // The AMR solvers on all levels become invalidated.
-        levPtr = levPtr->crseNSPtr();
-        while (levPtr) {
-            levPtr->m_amrSolversValid = false;
-            levPtr = levPtr->crseNSPtr();
-        }
-    }
+    this->invalidateCrseOpsAndSolvers();
 
     // Notes and warnings:
     //
@@ -407,6 +394,9 @@ AMRNSLevel::deactivateLevel()
     m_levelProjSolverPtr.reset();
     m_projOpPtr.reset();
 
+    m_viscousOpPtr.reset();
+    m_diffusiveOpPtrs.clear();
+
     delete m_finiteDiffPtr;
     m_finiteDiffPtr = nullptr;
 
@@ -449,6 +439,10 @@ AMRNSLevel::activateLevel(const Vector<Box>& a_new_grids,
         pout() << "Activating level " << m_level << "." << endl;
     }
 
+    // If this level did not exist, deactivateLevel() did not get a chance
+    // to tell the coarser levels about it.
+    this->invalidateCrseOpsAndSolvers();
+
     // Copy this level's new grids, sort them, then balance the load.
     // From Wikipedia: Morton ordering maps multidimensional data to one
     // dimension while preserving locality of the data points.
@@ -574,13 +568,18 @@ AMRNSLevel::activateLevel(const Vector<Box>& a_new_grids,
     }
 
     // Set up the time integrator.
-    m_parkPtr = new PARKType(grids,
-                             m_velPtr->nComp(),
-                             m_velPtr->ghostVect(),
-                             m_pPtr->nComp(),
-                             m_pPtr->ghostVect(),
-                             m_qPtr->nComp(),
-                             m_qPtr->ghostVect());
+    {
+        const TimeParameters& timeParams = ProblemContext::getInstance()->time;
+        m_parkPtr = TimeIntegrator::create(timeParams.integrator,
+                                           timeParams.tableau,
+                                           grids,
+                                           m_velPtr->nComp(),
+                                           m_velPtr->ghostVect(),
+                                           m_pPtr->nComp(),
+                                           m_pPtr->ghostVect(),
+                                           m_qPtr->nComp(),
+                                           m_qPtr->ghostVect());
+    }
 }
 
 
@@ -621,6 +620,10 @@ AMRNSLevel::validateOpsAndSolvers()
         AMRNSLevel* levPtr = this->coarsestNSPtr();
         while (levPtr) {
             if (!levPtr->m_amrOpsValid) {
+                // The calls column of this phase counts the rebuilds.
+                PhaseTimer::Scope phaseTimer("Rebuild proj ops",
+                                             levPtr->m_level);
+
                 // Redefining this op invalidates its associated level solver.
                 levPtr->m_levelSolversValid = false;
 
@@ -642,10 +645,16 @@ AMRNSLevel::validateOpsAndSolvers()
                                                         1,
                                                         this->pressurePhysBC()));
 
+                levPtr->m_levelOpsValid = true;
+                levPtr->m_amrOpsValid   = true;
+
                 if (s_verbosity >= verbThresh) {
                     pout() << "m_projOpPtr redefined on level "
                            << levPtr->m_level << endl;
                 }
+            } else if (s_verbosity >= verbThresh) {
+                pout() << "m_projOpPtr kept on level " << levPtr->m_level
+                       << endl;
             }
 
             vAMRMGOps[levPtr->m_level] = levPtr->m_projOpPtr;
@@ -656,14 +665,22 @@ AMRNSLevel::validateOpsAndSolvers()
         levPtr = this->coarsestNSPtr();
         while (levPtr) {
             if (!levPtr->m_levelSolversValid) {
+                PhaseTimer::Scope phaseTimer("Rebuild proj solvers",
+                                             levPtr->m_level);
+
                 levPtr->m_levelProjSolverPtr.reset(new LevelProjSolver);
                 levPtr->m_levelProjSolverPtr->define(
                     levPtr->m_projOpPtr, LevelProjSolver::getDefaultOptions());
 
+                levPtr->m_levelSolversValid = true;
+
                 if (s_verbosity >= verbThresh) {
                     pout() << "m_levelProjSolverPtr redefined on level "
                            << levPtr->m_level << endl;
                 }
+            } else if (s_verbosity >= verbThresh) {
+                pout() << "m_levelProjSolverPtr kept on level "
+                       << levPtr->m_level << endl;
             }
             levPtr = levPtr->fineNSPtr();
         }
@@ -672,6 +689,9 @@ AMRNSLevel::validateOpsAndSolvers()
         levPtr = this->coarsestNSPtr();
         while (levPtr) {
             if (!levPtr->m_amrSolversValid) {
+                PhaseTimer::Scope phaseTimer("Rebuild proj solvers",
+                                             levPtr->m_level);
+
                 levPtr->m_amrProjSolverPtr.reset(new AMRProjSolver);
                 levPtr->m_amrProjSolverPtr->define(
                     vAMRMGOps,
@@ -679,21 +699,56 @@ AMRNSLevel::validateOpsAndSolvers()
                     lmax,
                     AMRProjSolver::getDefaultOptions());
 
+                levPtr->m_amrSolversValid = true;
+
                 if (s_verbosity >= verbThresh) {
                     pout() << "m_amrProjSolverPtr redefined on level "
                            << levPtr->m_level << endl;
                 }
+            } else if (s_verbosity >= verbThresh) {
+                pout() << "m_amrProjSolverPtr kept on level "
+                       << levPtr->m_level << endl;
             }
             levPtr = levPtr->fineNSPtr();
         }
+    } else {
+        // Nothing to build.
+        AMRNSLevel* levPtr = this->coarsestNSPtr();
+        while (levPtr) {
+            levPtr->m_levelOpsValid     = true;
+            levPtr->m_levelSolversValid = true;
+            levPtr->m_amrOpsValid       = true;
+            levPtr->m_amrSolversValid   = true;
+            levPtr = levPtr->fineNSPtr();
+        }
     }
 
-    m_levelOpsValid     = true;
-    m_levelSolversValid = true;
-    m_amrOpsValid       = true;
-    m_amrSolversValid   = true;
-
     if (s_verbosity >= verbThresh) {
         pout() << Format::unindent << endl;
     }
 }
+
+
+// -----------------------------------------------------------------------------
+// Invalidates the ops and solvers on coarser levels that depend on this
+// level's grids. Called whenever this level appears or vanishes.
+// -----------------------------------------------------------------------------
+void
+AMRNSLevel::invalidateCrseOpsAndSolvers()
+{
+    if (m_level == 0) return;
+
+    // The next coarser level's AMR ops and solvers depend on this level
+    // for refluxing, so they get invalidated.
+    AMRNSLevel* levPtr = this->crseNSPtr();
+    CH_assert(levPtr);
+    levPtr->m_amrOpsValid       = false;
+    levPtr->m_amrSolversValid   = false;
+
+    // The AMR solvers on all levels become invalidated.
+    levPtr = levPtr->crseNSPtr();
+    while (levPtr) {
+        levPtr->m_amrSolversValid = false;
+        levPtr = levPtr->crseNSPtr();
+    }
+}
@@ -0,0 +1,609 @@
+/*******************************************************************************
+ *  SOMAR - Stratified Ocean Model with Adaptive Refinement
+ *  Developed by Ed Santilli & Alberto Scotti
+ *  Copyright (C) 2024 Thomas Jefferson University and Arizona State University
+ *
+ *  This library is free software; you can redistribute it and/or
+ *  modify it under the terms of the GNU Lesser General Public
+ *  License as published by the Free Software Foundation; either
+ *  version 2.1 of the License, or (at your option) any later version.
+ *
+ *  This library is distributed in the hope that it will be useful,
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+ *  Lesser General Public License for more details.
+ *
+ *  You should have received a copy of the GNU Lesser General Public
+ *  License along with this library; if not, write to the Free Software
+ *  Foundation, Inc., 51 Franklin Street, Fifth Floor, Boston, MA  02110-1301
+ *  USA
+ *
+ *  For up-to-date contact information, please visit the repository homepage,
+ *  https://github.com/MUON-CFD/SOMAR.
+ ******************************************************************************/
+#include "AMRNSLevel.H"
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+#include "ProblemContext.H"
+#include "PhaseTimer.H"
+#include "Subspace.H"
+#include "SPMD.H"
+#include "Debug.H"
+
+
+namespace {
+// One slice, line, or the set of all points. The samples are the cells of
+// pieces, in BoxIterator order, at the resolution of probeLevel.
+struct ProbeSet
+{
+    std::string      name;
+    std::string      description;  // Goes into the .hdr file.
+    std::vector<Box> pieces;
+    size_t           offset;       // Of the first sample in the list of all.
+    size_t           numSamples;
+};
+
+// Everything the probes need between calls.
+struct ProbeCache
+{
+    int                      probeLevel;
+    std::vector<IntVect>     ratios;     // From each level to probeLevel.
+    std::vector<ProbeSet>    sets;
+    size_t                   numSamples; // In all sets.
+    std::vector<std::string> compNames;
+
+    // The grids that sampleRanges was built for.
+    std::vector<DisjointBoxLayout> grids;
+
+    // The samples that fall on this rank's boxes, in the order their values
+    // are packed. Each sample is listed on the finest level that covers it.
+    std::vector<int>     localSamples;  // Index in the list of all samples.
+    std::vector<IntVect> localCells;    // Its cell, at probeLevel.
+
+    // [level][layout index] -> [begin, end) in localSamples.
+    // Empty for boxes on other ranks.
+    std::vector<std::vector<std::pair<size_t, size_t>>> sampleRanges;
+
+    // Rank 0 only. How many samples each rank sends, and every rank's
+    // localSamples, back to back.
+    std::vector<int> recvCounts;
+    std::vector<int> recvSamples;
+
+    // Rank 0 only.
+    std::vector<std::unique_ptr<std::ofstream>> files;
+};
+
+std::unique_ptr<ProbeCache> s_probeCachePtr;
+};
+
+
+// -----------------------------------------------------------------------------
+// The fields that output.probeFields can select, and their components.
+// -----------------------------------------------------------------------------
+static std::vector<std::string>
+getProbeComponentNames(const AMRNSLevel& a_level)
+{
+    const std::string xyz[3] = {"x", "y", "z"};
+    std::vector<std::string> names;
+
+    for (const auto& field : ProblemContext::getInstance()->output.probeFields) {
+        if (field == "scalars") {
+            for (int sc = 0; sc < a_level.numScalars(); ++sc) {
+                names.push_back(a_level.getScalarName(sc));
+            }
+        } else if (field == "vel") {
+            for (int d = 0; d < SpaceDim; ++d) names.push_back(xyz[d] + "_vel");
+        } else if (field == "p") {
+            names.push_back("pressure");
+        } else if (field == "T") {
+            names.push_back("T_total");
+        } else if (field == "S") {
+            names.push_back("S_total");
+        } else if (field == "b") {
+            names.push_back("b_total");
+        } else if (field == "Tpert") {
+            names.push_back("T_pert");
+        } else if (field == "Spert") {
+            names.push_back("S_pert");
+        } else if (field == "bpert") {
+            names.push_back("b_pert");
+        } else {
+            MAYDAYERROR("output.probeFields: " << field
+                        << " is not a valid field. Try one of: scalars vel p "
+                           "T S b Tpert Spert bpert");
+        }
+    }
+
+    if (names.empty()) {
+        MAYDAYERROR("output.probeFields does not select any components.");
+    }
+    return names;
+}
+
+
+// -----------------------------------------------------------------------------
+// The index of the cell that contains the mapped location a_Xi.
+// -----------------------------------------------------------------------------
+static IntVect
+probeCell(const RealVect& a_Xi, const RealVect& a_dXi, const Box& a_domBox)
+{
+    IntVect iv;
+    for (int d = 0; d < SpaceDim; ++d) {
+        iv[d] = static_cast<int>(std::floor(a_Xi[d] / a_dXi[d]));
+        iv[d] = std::max(a_domBox.smallEnd(d), std::min(a_domBox.bigEnd(d), iv[d]));
+    }
+    return iv;
+}
+
+
+// -----------------------------------------------------------------------------
+// Position of a_iv within a_box, in BoxIterator order.
+// -----------------------------------------------------------------------------
+static size_t
+linearIndex(const IntVect& a_iv, const Box& a_box)
+{
+    size_t idx    = 0;
+    size_t stride = 1;
+    for (int d = 0; d < SpaceDim; ++d) {
+        idx    += stride * (a_iv[d] - a_box.smallEnd(d));
+        stride *= a_box.size(d);
+    }
+    return idx;
+}
+
+
+// -----------------------------------------------------------------------------
+// Builds the probe sets from output.* and opens the files.
+// -----------------------------------------------------------------------------
+static std::unique_ptr<ProbeCache>
+defineProbes(const AMRNSLevel& a_level0, const RealVect& a_dXi0)
+{
+    const ProblemContext*   ctx    = ProblemContext::getInstance();
+    const OutputParameters& output = ctx->output;
+
+    auto  cachePtr = std::make_unique<ProbeCache>();
+    auto& cache    = *cachePtr;
+
+    cache.probeLevel =
+        std::max(0, std::min(ctx->amr.maxLevel, output.probeLevel));
+
+    // Refinement from each level to probeLevel.
+    cache.ratios.assign(cache.probeLevel + 1, IntVect::Unit);
+    for (int lev = cache.probeLevel - 1; lev >= 0; --lev) {
+        cache.ratios[lev] = cache.ratios[lev + 1] * ctx->amr.refRatios[lev];
+    }
+
+    const IntVect  ratio0 = cache.ratios[0];
+    const Box      domBox = refine(a_level0.getBoxes().physDomain().domainBox(),
+                                   ratio0);
+    const RealVect dXi    = a_dXi0 / RealVect(ratio0);
+
+    std::ostringstream common;
+    common << "level = " << cache.probeLevel << "\n";
+    common << "dXi =";
+    for (int d = 0; d < SpaceDim; ++d) common << " " << dXi[d];
+    common << "\n";
+
+    // Slices
+    for (size_t idx = 0; idx < output.probeSliceDirs.size(); ++idx) {
+        const int  dir = output.probeSliceDirs[idx];
+        const Real pos = output.probeSlicePos[idx];
+
+        Box slice = domBox;
+        RealVect Xi = RealVect::Zero;
+        Xi[dir] = pos;
+        const int i = probeCell(Xi, dXi, domBox)[dir];
+        slice.setRange(dir, i, 1);
+
+        ProbeSet set;
+        set.name = "slice" + std::to_string(idx);
+        set.pieces.push_back(slice);
+
+        std::ostringstream desc;
+        desc << "kind = slice\n";
+        desc << "dir = " << dir << "\n";
+        desc << "pos = " << pos << "\n";
+        desc << "shape =";
+        for (int d = 0; d < SpaceDim; ++d) {
+            if (d != dir) desc << " " << slice.size(d);
+        }
+        desc << "\n";
+        desc << "loCell =";
+        for (int d = 0; d < SpaceDim; ++d) desc << " " << slice.smallEnd(d);
+        desc << "\n";
+        set.description = desc.str();
+
+        cache.sets.push_back(set);
+    }
+
+    // Lines
+    for (size_t idx = 0; idx < output.probeLineDirs.size(); ++idx) {
+        const int       dir = output.probeLineDirs[idx];
+        const RealVect& pos = output.probeLinePos[idx];
+
+        const IntVect iv = probeCell(pos, dXi, domBox);
+        Box line(iv, iv);
+        line.setRange(dir, domBox.smallEnd(dir), domBox.size(dir));
+
+        ProbeSet set;
+        set.name = "line" + std::to_string(idx);
+        set.pieces.push_back(line);
+
+        std::ostringstream desc;
+        desc << "kind = line\n";
+        desc << "dir = " << dir << "\n";
+        desc << "pos =";
+        for (int d = 0; d < SpaceDim; ++d) desc << " " << pos[d];
+        desc << "\n";
+        desc << "shape = " << line.size(dir) << "\n";
+        desc << "loCell =";
+        for (int d = 0; d < SpaceDim; ++d) desc << " " << line.smallEnd(d);
+        desc << "\n";
+        set.description = desc.str();
+
+        cache.sets.push_back(set);
+    }
+
+    // Points all go into one set.
+    if (!output.probePoints.empty()) {
+        ProbeSet set;
+        set.name = "points";
+
+        std::ostringstream desc;
+        desc << "kind = points\n";
+        desc << "shape = " << output.probePoints.size() << "\n";
+        for (const RealVect& pos : output.probePoints) {
+            const IntVect iv = probeCell(pos, dXi, domBox);
+            set.pieces.push_back(Box(iv, iv));
+
+            desc << "pos =";
+            for (int d = 0; d < SpaceDim; ++d) desc << " " << pos[d];
+            desc << "\n";
+        }
+        set.description = desc.str();
+
+        cache.sets.push_back(set);
+    }
+
+    // Number the samples. The cells themselves are only listed for the
+    // local boxes, in writeProbes.
+    cache.numSamples = 0;
+    for (ProbeSet& set : cache.sets) {
+        set.offset = cache.numSamples;
+        for (const Box& piece : set.pieces) {
+            cache.numSamples += piece.numPts();
+        }
+        set.numSamples = cache.numSamples - set.offset;
+    }
+
+    cache.compNames = getProbeComponentNames(a_level0);
+
+    // Open the files. Records are appended to what is already there, unless
+    // the samples have changed since the file was started.
+    if (procID() == 0) {
+        for (ProbeSet& set : cache.sets) {
+            std::ostringstream hdr;
+            hdr << "# SOMAR probe. Read with Slicer.ReadProbe.\n";
+            hdr << set.description << common.str();
+            hdr << "comps =";
+            for (const auto& name : cache.compNames) hdr << " " << name;
+            hdr << "\n";
+            hdr << "bytesPerReal = " << sizeof(Real) << "\n";
+            hdr << "record = step time data[comp][sample]\n";
+
+            const std::string fileName = output.probePrefix + set.name;
+            std::ios::openmode mode = std::ios::binary | std::ios::app;
+            {
+                std::ifstream oldHdr(fileName + ".hdr");
+                if (oldHdr) {
+                    std::stringstream oldText;
+                    oldText << oldHdr.rdbuf();
+                    if (oldText.str() != hdr.str()) {
+                        MAYDAYWARNING(fileName << ".hdr does not match the "
+                                      "current probes. Starting over.");
+                        mode = std::ios::binary | std::ios::trunc;
+                    }
+                }
+            }
+            std::ofstream(fileName + ".hdr") << hdr.str();
+
+            cache.files.emplace_back(
+                new std::ofstream(fileName + ".dat", mode));
+            if (!*cache.files.back()) {
+                MAYDAYERROR("Could not open " << fileName << ".dat");
+            }
+        }
+    }
+
+    return cachePtr;
+}
+
+
+// -----------------------------------------------------------------------------
+// Samples the fields selected by output.probeFields along the slices, lines
+// and points given in output.*, and appends them to the probe files.
+// Each sample takes the value of the cell that contains it on the finest level
+// that covers it, up to probeLevel. Only called on level 0.
+// -----------------------------------------------------------------------------
+void
+AMRNSLevel::writeProbes(const int a_step) const
+{
+    const OutputParameters& output = ProblemContext::getInstance()->output;
+    if (output.probeInterval <= 0 || a_step % output.probeInterval != 0) return;
+
+    BEGIN_FLOWCHART();
+    PhaseTimer::Scope phaseTimer("I/O", m_level);
+    CH_assert(m_level == 0);
+
+    if (!s_probeCachePtr) {
+        s_probeCachePtr = defineProbes(*this, m_levGeoPtr->getDXi());
+    }
+    ProbeCache& cache = *s_probeCachePtr;
+
+    // The levels we sample.
+    std::vector<const AMRNSLevel*> levels;
+    for (const AMRNSLevel* levPtr = this; levPtr; levPtr = levPtr->fineNSPtr()) {
+        if (levPtr->m_level > cache.probeLevel || levPtr->isEmpty()) break;
+        levels.push_back(levPtr);
+    }
+    const int numLevels = levels.size();
+
+    // Find the level and box of each sample. This only changes on regrids.
+    bool sameGrids = (int(cache.grids.size()) == numLevels);
+    for (int lev = 0; sameGrids && lev < numLevels; ++lev) {
+        sameGrids = (cache.grids[lev] == levels[lev]->getBoxes());
+    }
+    if (!sameGrids) {
+        cache.grids.resize(numLevels);
+        cache.sampleRanges.assign(numLevels, {});
+        cache.localSamples.clear();
+        cache.localCells.clear();
+
+        for (int lev = 0; lev < numLevels; ++lev) {
+            const DisjointBoxLayout& grids  = levels[lev]->getBoxes();
+            const IntVect&           ratio  = cache.ratios[lev];
+            auto&                    ranges = cache.sampleRanges[lev];
+
+            cache.grids[lev] = grids;
+            ranges.assign(grids.size(), {0, 0});
+
+            // The next finer level's boxes, at probeLevel. Samples under
+            // them are taken from that level instead.
+            std::vector<Box> fineBoxes;
+            if (lev + 1 < numLevels) {
+                const DisjointBoxLayout& fineGrids = levels[lev + 1]->getBoxes();
+                for (LayoutIterator lit = fineGrids.layoutIterator(); lit.ok();
+                     ++lit) {
+                    fineBoxes.push_back(
+                        refine(fineGrids[lit], cache.ratios[lev + 1]));
+                }
+            }
+
+            for (DataIterator dit(grids); dit.ok(); ++dit) {
+                const Box fineBox = refine(grids[dit], ratio);
+                auto&     range   = ranges[dit().intCode()];
+                range.first       = cache.localSamples.size();
+
+                for (const ProbeSet& set : cache.sets) {
+                    size_t pieceOffset = set.offset;
+                    for (const Box& piece : set.pieces) {
+                        const Box region = fineBox & piece;
+                        if (!region.isEmpty()) {
+                            std::vector<Box> covered;
+                            for (const Box& b : fineBoxes) {
+                                if (b.intersectsNotEmpty(region)) {
+                                    covered.push_back(b & region);
+                                }
+                            }
+
+                            for (BoxIterator bit(region); bit.ok(); ++bit) {
+                                bool isCovered = false;
+                                for (const Box& b : covered) {
+                                    if (b.contains(bit())) {
+                                        isCovered = true;
+                                        break;
+                                    }
+                                }
+                                if (isCovered) continue;
+
+                                cache.localSamples.push_back(
+                                    int(pieceOffset + linearIndex(bit(), piece)));
+                                cache.localCells.push_back(bit());
+                            }
+                        }
+                        pieceOffset += piece.numPts();
+                    }
+                }
+
+                range.second = cache.localSamples.size();
+            }
+        }
+
+        // Tell rank 0 where each rank's values will go.
+#ifdef CH_MPI
+        const int numLocal = cache.localSamples.size();
+        std::vector<int> displs;
+        if (procID() == 0) {
+            cache.recvCounts.resize(numProc());
+            displs.resize(numProc());
+        }
+        MPI_Gather(&numLocal, 1, MPI_INT,
+                   cache.recvCounts.data(), 1, MPI_INT,
+                   0, Chombo_MPI::comm);
+        if (procID() == 0) {
+            int total = 0;
+            for (int r = 0; r < int(numProc()); ++r) {
+                displs[r] = total;
+                total += cache.recvCounts[r];
+            }
+            cache.recvSamples.resize(total);
+        }
+        MPI_Gatherv(cache.localSamples.data(), numLocal, MPI_INT,
+                    cache.recvSamples.data(), cache.recvCounts.data(),
+                    displs.data(), MPI_INT, 0, Chombo_MPI::comm);
+#else
+        cache.recvCounts.assign(1, int(cache.localSamples.size()));
+        cache.recvSamples = cache.localSamples;
+#endif
+    }
+
+    // Sample. Values are packed sample by sample, in localSamples order.
+    const int         numComps   = cache.compNames.size();
+    const size_t      numSamples = cache.numSamples;
+    std::vector<Real> localVals(numComps * cache.localSamples.size());
+
+    for (int lev = 0; lev < numLevels; ++lev) {
+        const AMRNSLevel&        levRef = *levels[lev];
+        const DisjointBoxLayout& grids  = levRef.getBoxes();
+        const IntVect&           ratio  = cache.ratios[lev];
+        const State&             state  = *levRef.m_statePtr;
+
+        for (DataIterator dit(grids); dit.ok(); ++dit) {
+            const auto& range = cache.sampleRanges[lev][dit().intCode()];
+            if (range.first == range.second) continue;
+
+            // Fill the fields on the smallest box that holds our samples.
+            Box bbox;
+            for (size_t k = range.first; k < range.second; ++k) {
+                const IntVect iv = coarsen(cache.localCells[k], ratio);
+                bbox.minBox(Box(iv, iv));
+            }
+
+            FArrayBox fab(bbox, numComps);
+            FArrayBox bFAB;
+            bool      haveB = false;
+            int       comp  = 0;
+
+            for (const auto& field : output.probeFields) {
+                if (field == "scalars") {
+                    const int num = levRef.numScalars();
+                    if (num > 0) {
+                        fab.copy(state.scalars[dit], bbox, 0, bbox, comp, num);
+                    }
+                    comp += num;
+
+                } else if (field == "vel") {
+                    for (int d = 0; d < SpaceDim; ++d, ++comp) {
+                        const FArrayBox& velFAB = state.vel[dit][d];
+                        const IntVect&   e      = BASISV(d);
+                        for (BoxIterator bit(bbox); bit.ok(); ++bit) {
+                            const IntVect& cc = bit();
+                            fab(cc, comp) = 0.5 * (velFAB(cc) + velFAB(cc + e));
+                        }
+                    }
+
+                } else if (field == "p") {
+                    fab.copy(state.p[dit], bbox, 0, bbox, comp, 1);
+                    comp += 1;
+
+                } else if (field == "T" || field == "Tpert") {
+                    fab.copy(state.T[dit], bbox, 0, bbox, comp, 1);
+                    if (field == "Tpert") {
+                        Subspace::addHorizontalExtrusion(
+                            fab, comp, *levRef.m_TbarPtr, 0, 1, -1.0);
+                    }
+                    comp += 1;
+
+                } else if (field == "S" || field == "Spert") {
+                    fab.copy(state.S[dit], bbox, 0, bbox, comp, 1);
+                    if (field == "Spert") {
+                        Subspace::addHorizontalExtrusion(
+                            fab, comp, *levRef.m_SbarPtr, 0, 1, -1.0);
+                    }
+                    comp += 1;
+
+                } else if (field == "b" || field == "bpert") {
+                    if (!haveB) {
+                        bFAB.define(bbox, 1);
+                        FArrayBox zFAB(bbox, 1);
+                        levRef.m_levGeoPtr->fill_physCoor(zFAB, 0, SpaceDim - 1);
+                        levRef.equationOfState(
+                            bFAB, state.T[dit], state.S[dit], zFAB);
+                        haveB = true;
+                    }
+                    fab.copy(bFAB, bbox, 0, bbox, comp, 1);
+                    if (field == "bpert") {
+                        Subspace::addHorizontalExtrusion(
+                            fab, comp, *levRef.m_bbarPtr, 0, 1, -1.0);
+                    }
+                    comp += 1;
+                }
+            }
+            CH_assert(comp == numComps);
+
+            for (size_t k = range.first; k < range.second; ++k) {
+                const IntVect iv = coarsen(cache.localCells[k], ratio);
+                for (comp = 0; comp < numComps; ++comp) {
+                    localVals[k * numComps + comp] = fab(iv, comp);
+                }
+            }
+        } // dit
+    } // lev
+
+    // Only rank 0 holds every sample.
+    std::vector<Real> recvVals;
+#ifdef CH_MPI
+    {
+        std::vector<int> counts, displs;
+        if (procID() == 0) {
+            counts.resize(numProc());
+            displs.resize(numProc());
+            int total = 0;
+            for (int r = 0; r < int(numProc()); ++r) {
+                counts[r] = numComps * cache.recvCounts[r];
+                displs[r] = total;
+                total += counts[r];
+            }
+            recvVals.resize(total);
+        }
+        MPI_Gatherv(localVals.data(), localVals.size(), MPI_CH_REAL,
+                    recvVals.data(), counts.data(), displs.data(),
+                    MPI_CH_REAL, 0, Chombo_MPI::comm);
+    }
+#else
+    recvVals.swap(localVals);
+#endif
+
+    if (procID() != 0) return;
+
+    // Each sample was filled by exactly one rank.
+    std::vector<Real> vals(numComps * numSamples, 0.0);
+    for (size_t k = 0; k < cache.recvSamples.size(); ++k) {
+        const size_t n = cache.recvSamples[k];
+        for (int comp = 0; comp < numComps; ++comp) {
+            vals[comp * numSamples + n] = recvVals[k * numComps + comp];
+        }
+    }
+
+    const Real step = a_step;
+    for (size_t setIdx = 0; setIdx < cache.sets.size(); ++setIdx) {
+        const ProbeSet& set = cache.sets[setIdx];
+        std::ofstream&  os  = *cache.files[setIdx];
+
+        os.write(reinterpret_cast<const char*>(&step), sizeof(Real));
+        os.write(reinterpret_cast<const char*>(&m_time), sizeof(Real));
+        for (int comp = 0; comp < numComps; ++comp) {
+            os.write(
+                reinterpret_cast<const char*>(&vals[comp * numSamples + set.offset]),
+                set.numSamples * sizeof(Real));
+        }
+        os.flush();
+
+        if (!os) {
+            MAYDAYWARNING("Could not write to " << output.probePrefix
+                          << set.name << ".dat");
+        }
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+// Closes the probe files.
+// -----------------------------------------------------------------------------
+void
+AMRNSLevel::closeProbes() const
+{
+    s_probeCachePtr.reset();
+}
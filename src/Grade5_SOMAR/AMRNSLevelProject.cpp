@@ -66,6 +66,7 @@ AMRNSLevel::projectPredict(LevelData<FluxBox>&   a_vel,
                            const Real            a_projDt)
 {
     BEGIN_FLOWCHART();
+    PhaseTimer::Scope phaseTimer("Projection", m_level);
 
     const ProblemContext* ctx = ProblemContext::getInstance();
     if (!ctx->proj.doLevelProj) return;
@@ -250,6 +251,7 @@ AMRNSLevel::projectCorrect(LevelData<FluxBox>&   a_vel,
                            const Real            a_gammaDt)
 {
     BEGIN_FLOWCHART();
+    PhaseTimer::Scope phaseTimer("Projection", m_level);
 
     const ProblemContext* ctx = ProblemContext::getInstance();
 
@@ -371,6 +373,7 @@ AMRNSLevel::projectCorrect(LevelData<FluxBox>&   a_vel,
 void
 AMRNSLevel::projectDownToThis(const bool a_sync)
 {
+    PhaseTimer::Scope phaseTimer("Projection", m_level);
 #if 0
     // This is code that I used to test the line relaxation method.
     // Will delete in a future push.
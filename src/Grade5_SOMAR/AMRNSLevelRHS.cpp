@@ -37,6 +37,7 @@
 #include "Subspace.H"
 #include <chrono>
 #include "GNUC_Extensions.H"
+#include "ThreadTools.H"
 
 // Viscous solver stuff
 #include "LevelSolver.H"
@@ -74,10 +75,16 @@ AMRNSLevel::setExplicitRHS(LevelData<FluxBox>&   a_kvel,
                            const Real            a_time,
                            const Real            a_refluxDt)
 {
+    PhaseTimer::Scope phaseTimer("Explicit RHS", m_level);
+
     // Collect references
-    const DisjointBoxLayout& grids = m_levGeoPtr->getBoxes();
-    DataIterator             dit   = grids.dataIterator();
-    const ProblemContext*    ctx   = ProblemContext::getInstance();
+    const DisjointBoxLayout& grids    = m_levGeoPtr->getBoxes();
+    DataIterator             dit      = grids.dataIterator();
+    const int                numBoxes = dit.size();
+    const ProblemContext*    ctx      = ProblemContext::getInstance();
+
+    // Per-box run times, used by loadBalance at the next regrid.
+    std::vector<double>& boxCosts = BoxCostModel::costs(m_level, grids);
 
     // Prepare state variables
     LevelData<FluxBox> cartVel;
@@ -144,7 +151,6 @@ AMRNSLevel::setExplicitRHS(LevelData<FluxBox>&   a_kvel,
     }
 
     // Create workspace
-    StaggeredFluxLD      momentumFlux(grids);
     LevelData<FluxBox>   qFlux(grids, 1);
     LevelData<FArrayBox> qDiv(grids, 1);
 
@@ -154,11 +160,23 @@ AMRNSLevel::setExplicitRHS(LevelData<FluxBox>&   a_kvel,
 
     // Momentum advection
     if (ctx->rhs.doMomentumAdvection) {
-        this->computeMomentumAdvection(a_kvel, momentumFlux, cartVel, advVel);
-
-        // Refluxing
-        if (ctx->rhs.doMomAdvRefluxing) {
-            this->incrementFluxRegisters(momentumFlux, a_refluxDt);
+        // Both paths report here, including the two-pass path's flux
+        // allocation, so rhs.fuseMomentumAdvection = 0/1 runs compare directly.
+        PhaseTimer::Scope momAdvTimer("Momentum advection", m_level);
+
+        if (ctx->rhs.fuseMomentumAdvection) {
+            const Real refluxDt = ctx->rhs.doMomAdvRefluxing ? a_refluxDt : 0.0;
+            this->computeMomentumAdvectionFused(
+                a_kvel, cartVel, advVel, refluxDt);
+        } else {
+            StaggeredFluxLD momentumFlux(grids);
+            this->computeMomentumAdvection(
+                a_kvel, momentumFlux, cartVel, advVel);
+
+            // Refluxing
+            if (ctx->rhs.doMomAdvRefluxing) {
+                this->incrementFluxRegisters(momentumFlux, a_refluxDt);
+            }
         }
 
         nanCheck(a_kvel);
@@ -247,6 +265,8 @@ AMRNSLevel::setExplicitRHS(LevelData<FluxBox>&   a_kvel,
 
     // Viscous forcing (w/ debugging)
     if (ctx->rhs.doViscousForcing) {
+        StaggeredFluxLD momentumFlux(grids);
+
         const RealVect nu = RealVect::Unit * ctx->rhs.nu;
         const Real primaryScale   = ctx->rhs.doImplicitDiffusion ? 0.0 : 1.0;
         const Real transposeScale = 1.0;
@@ -375,23 +395,27 @@ AMRNSLevel::setExplicitRHS(LevelData<FluxBox>&   a_kvel,
 
     // ------------------------------------------------------------------
     // All of the forces above this line need to be scaled by 1/J.
-    for(dit.reset(); dit.ok(); ++dit) {
+    OMP_PARALLEL_FOR
+    for (int ibox = 0; ibox < numBoxes; ++ibox) {
+        const DataIndex& di = dit[ibox];
+        BoxCostModel::Scope costScope(&boxCosts, di);
+
         // The CC fields are easy.
-        const FArrayBox& ccJinvFAB = m_levGeoPtr->getCCJinv()[dit];
-        const Box        ccValid   = grids[dit];
+        const FArrayBox& ccJinvFAB = m_levGeoPtr->getCCJinv()[di];
+        const Box        ccValid   = grids[di];
         for (int comp = 0; comp < a_kq.nComp(); ++comp) {
-            a_kq[dit].mult(ccJinvFAB, ccValid, 0, comp, 1);
+            a_kq[di].mult(ccJinvFAB, ccValid, 0, comp, 1);
         }
 
         // The FC fields require a harmonic average of Jinv.
         // That is, first average J to FC, then reciprocate.
-        const FArrayBox& ccJFAB = m_levGeoPtr->getCCJ()[dit];
+        const FArrayBox& ccJFAB = m_levGeoPtr->getCCJ()[di];
         for (int fcDir = 0; fcDir < SpaceDim; ++fcDir) {
             const Box fcValid = surroundingNodes(ccValid, fcDir);
 
             FArrayBox fcJFAB(fcValid, 1);
             Convert::Simple(fcJFAB, ccJFAB);
-            a_kvel[dit][fcDir].divide(fcJFAB, fcValid, 0, 0, 1);
+            a_kvel[di][fcDir].divide(fcJFAB, fcValid, 0, 0, 1);
         }
     }
 
@@ -401,11 +425,15 @@ AMRNSLevel::setExplicitRHS(LevelData<FluxBox>&   a_kvel,
     // Gravity forcing
     if (ctx->rhs.doGravityForcing) {
         // Original version...
-        for (dit.reset(); dit.ok(); ++dit) {
-            FArrayBox&       kwFAB    = a_kvel[dit][SpaceDim - 1];
-            const FArrayBox& bpertFAB = bpert[dit];
-            const FArrayBox& ccJFAB   = m_levGeoPtr->getCCJ()[dit];
-            const Box        fcValid  = grids[dit].surroundingNodes(SpaceDim - 1);
+        OMP_PARALLEL_FOR
+        for (int ibox = 0; ibox < numBoxes; ++ibox) {
+            const DataIndex& di = dit[ibox];
+            BoxCostModel::Scope costScope(&boxCosts, di);
+
+            FArrayBox&       kwFAB    = a_kvel[di][SpaceDim - 1];
+            const FArrayBox& bpertFAB = bpert[di];
+            const FArrayBox& ccJFAB   = m_levGeoPtr->getCCJ()[di];
+            const Box        fcValid  = grids[di].surroundingNodes(SpaceDim - 1);
 
             FORT_ADDEXPLICITGRAVITYFORCING (
                 CHF_FRA1(kwFAB, 0),
@@ -466,16 +494,20 @@ AMRNSLevel::setExplicitRHS(LevelData<FluxBox>&   a_kvel,
         const Real coriolisFy = ctx->rhs.coriolisF[SpaceDim - 2];
         const Real coriolisFz = ctx->rhs.coriolisF[SpaceDim - 1];
 
-        for (dit.reset(); dit.ok(); ++dit) {
-            FArrayBox&       kuFAB = a_kvel[dit][0];
-            FArrayBox&       kvFAB = a_kvel[dit][1];
-            FArrayBox&       kwFAB = a_kvel[dit][SpaceDim - 1];
-            const FArrayBox& uFAB  = a_vel[dit][0];
-            const FArrayBox& vFAB  = a_vel[dit][1];
-            const FArrayBox& wFAB  = a_vel[dit][SpaceDim - 1];
-            const Box&       kuBox = surroundingNodes(grids[dit], 0);
-            const Box&       kvBox = surroundingNodes(grids[dit], 1);
-            const Box&       kwBox = surroundingNodes(grids[dit], SpaceDim - 1);
+        OMP_PARALLEL_FOR
+        for (int ibox = 0; ibox < numBoxes; ++ibox) {
+            const DataIndex& di = dit[ibox];
+            BoxCostModel::Scope costScope(&boxCosts, di);
+
+            FArrayBox&       kuFAB = a_kvel[di][0];
+            FArrayBox&       kvFAB = a_kvel[di][1];
+            FArrayBox&       kwFAB = a_kvel[di][SpaceDim - 1];
+            const FArrayBox& uFAB  = a_vel[di][0];
+            const FArrayBox& vFAB  = a_vel[di][1];
+            const FArrayBox& wFAB  = a_vel[di][SpaceDim - 1];
+            const Box&       kuBox = surroundingNodes(grids[di], 0);
+            const Box&       kvBox = surroundingNodes(grids[di], 1);
+            const Box&       kwBox = surroundingNodes(grids[di], SpaceDim - 1);
 
             FORT_ADDEXPLICITCORIOLISFORCING3D(
                 CHF_FRA1(kuFAB, 0),
@@ -656,6 +688,7 @@ AMRNSLevel::solveImplicit(LevelData<FluxBox>&   a_vel,
                           const Real            a_time,
                           const Real            /*a_refluxDt*/)
 {
+    PhaseTimer::Scope phaseTimer("Diffusion", m_level);
     const ProblemContext* ctx = ProblemContext::getInstance();
     if (!ctx->rhs.doImplicitDiffusion) return;
 
@@ -823,6 +856,7 @@ AMRNSLevel::computeMomentumDiffusion(LevelData<FluxBox>&         a_kvel,
                                      const Real                  a_primaryScale,
                                      const Real                  a_transposeScale) const
 {
+    PhaseTimer::Scope phaseTimer("Diffusion", m_level);
     CH_assert(a_kvel.nComp() == 1);
     CH_assert(a_cartVel.nComp() == 1);
     CH_assert(a_eddyNu.nComp() == 1);
@@ -831,14 +865,20 @@ AMRNSLevel::computeMomentumDiffusion(LevelData<FluxBox>&         a_kvel,
     CH_assert(a_momentumFlux.getBoxes() == m_levGeoPtr->getBoxes());
     CH_assert(a_cartVel     .getBoxes() == m_levGeoPtr->getBoxes());
 
-    const RealVect&          dXi   = m_levGeoPtr->getDXi();
-    const DisjointBoxLayout& grids = m_levGeoPtr->getBoxes();
-    DataIterator             dit   = grids.dataIterator();
+    const RealVect&          dXi      = m_levGeoPtr->getDXi();
+    const DisjointBoxLayout& grids    = m_levGeoPtr->getBoxes();
+    const DataIterator       dit      = grids.dataIterator();
+    const int                numBoxes = dit.size();
+    std::vector<double>& boxCosts = BoxCostModel::costs(m_level, grids);
 
     // Compute J*grad[u] components. Last index will be Cartesian-based.
     m_finiteDiffPtr->levelVectorGradient(a_momentumFlux, a_cartVel);
 
-    for (dit.reset(); dit.ok(); ++dit) {
+    OMP_PARALLEL_FOR
+    for (int ibox = 0; ibox < numBoxes; ++ibox) {
+        const DataIndex& di = dit[ibox];
+        BoxCostModel::Scope costScope(&boxCosts, di);
+
         // In what follows, we are computing du^a/dt.
         // a is the Cartesian velocity component that we are updating.
 
@@ -847,15 +887,15 @@ AMRNSLevel::computeMomentumDiffusion(LevelData<FluxBox>&         a_kvel,
 
             // Easy, diagonal elements first.
             {
-                FArrayBox& SaaFAB = a_momentumFlux[a][a][dit];
+                FArrayBox& SaaFAB = a_momentumFlux[a][a][di];
                 SaaFAB *= (a_primaryScale + a_transposeScale);
                 checkForNAN(SaaFAB, SaaFAB.box());
             }
 
             // Off-diagonal comps need to be symmetrized.
             for (int i = a + 1; i < SpaceDim; ++i) {
-                FArrayBox& SiaFAB = a_momentumFlux[i][a][dit];
-                FArrayBox& SaiFAB = a_momentumFlux[a][i][dit];
+                FArrayBox& SiaFAB = a_momentumFlux[i][a][di];
+                FArrayBox& SaiFAB = a_momentumFlux[a][i][di];
                 const Box& ecBox  = SiaFAB.box();
 
                 // Send last index to mapped basis.
@@ -887,9 +927,9 @@ AMRNSLevel::computeMomentumDiffusion(LevelData<FluxBox>&         a_kvel,
             // 2. Convert 2*S^{ia} into the viscous stresses for each i,
             //    T^{ia} = (nu + eddyNu) * 2*J*S^{ia}.
             for (int i = 0; i < SpaceDim; ++i) {
-                FArrayBox&       TiaFAB    = a_momentumFlux[i][a][dit];
+                FArrayBox&       TiaFAB    = a_momentumFlux[i][a][di];
                 const Real       nuDir     = a_nu[i];
-                const FArrayBox& eddyNuFAB = a_eddyNu[dit];
+                const FArrayBox& eddyNuFAB = a_eddyNu[di];
                 const Box&       region    = TiaFAB.box();
 
                 if (a == i) {
@@ -904,8 +944,8 @@ AMRNSLevel::computeMomentumDiffusion(LevelData<FluxBox>&         a_kvel,
 
 
             // 3. Compute the viscous force and add it to a_kvel.
-            FArrayBox& FaFAB = a_kvel[dit][a];
-            const Box  fcBox = surroundingNodes(grids[dit], a);
+            FArrayBox& FaFAB = a_kvel[di][a];
+            const Box  fcBox = surroundingNodes(grids[di], a);
             const Real scale = 1.0;
 
             D_TERM(
@@ -914,9 +954,9 @@ AMRNSLevel::computeMomentumDiffusion(LevelData<FluxBox>&         a_kvel,
             const int i2 = (a + 2) % SpaceDim;)
 
             D_TERM(
-            const FArrayBox& T0aFAB = a_momentumFlux[i0][a][dit];,
-            const FArrayBox& T1aFAB = a_momentumFlux[i1][a][dit];,
-            const FArrayBox& T2aFAB = a_momentumFlux[i2][a][dit];)
+            const FArrayBox& T0aFAB = a_momentumFlux[i0][a][di];,
+            const FArrayBox& T1aFAB = a_momentumFlux[i1][a][di];,
+            const FArrayBox& T2aFAB = a_momentumFlux[i2][a][di];)
 
             checkForNAN(FaFAB, fcBox);
             D_TERM(
@@ -972,6 +1012,7 @@ AMRNSLevel::computeScalarDiffusion(
     const LevelData<FArrayBox>& a_eddyNu,
     const Real                  a_eddyPrandtl) const
 {
+    PhaseTimer::Scope phaseTimer("Diffusion", m_level);
     CH_assert(a_kq.nComp() == 1);
     CH_assert(a_qFlux.nComp() == 1);
     CH_assert(a_q.nComp() == 1);
@@ -1011,6 +1052,7 @@ AMRNSLevel::solveMomentumDiffusion(LevelData<FluxBox>&         a_cartVel,
                                    const Real                  a_gammaDt,
                                    const Real                  a_time) const
 {
+    PhaseTimer::Scope phaseTimer("Diffusion", m_level);
     const ProblemContext* ctx = ProblemContext::getInstance();
     CH_assert(ctx->rhs.doImplicitDiffusion);
     CH_assert(ctx->rhs.doViscousForcing);
@@ -1040,9 +1082,23 @@ AMRNSLevel::solveMomentumDiffusion(LevelData<FluxBox>&         a_cartVel,
     LevelData<FluxBox>* crseVelPtr = m_level ? &crseVel : nullptr;
     this->setVelBC(a_cartVel, a_time, false, crseVelPtr);
 
-    // Create op
-    std::shared_ptr<Elliptic::ViscousOp> opPtr(new Elliptic::ViscousOp(
-        m_levGeoPtr, 1.0, -a_gammaDt, a_totalNu, this->velPhysBC()));
+    // Create or update the op. Without an eddy viscosity, nu is constant and
+    // only gammaDt can change between solves.
+    if (!m_viscousOpPtr) {
+        m_viscousOpPtr.reset(new Elliptic::ViscousOp(
+            m_levGeoPtr,
+            1.0,
+            -a_gammaDt,
+            a_totalNu,
+            this->velPhysBC(),
+            ctx->rhs.diffusionRelaxMethod ==
+                RHSParameters::DiffusionRelaxMethod::VERTLINE));
+    } else if (ctx->rhs.eddyViscMethod[m_level] > 0) {
+        m_viscousOpPtr->setCoefficients(1.0, -a_gammaDt, a_totalNu);
+    } else if (m_viscousOpPtr->getBeta() != -a_gammaDt) {
+        m_viscousOpPtr->setAlphaAndBeta(1.0, -a_gammaDt);
+    }
+    const std::shared_ptr<Elliptic::ViscousOp>& opPtr = m_viscousOpPtr;
 
     // Create solver
     // Elliptic::MGSolver<LevelData<FluxBox>> solver;
@@ -1125,6 +1181,7 @@ AMRNSLevel::solveScalarDiffusion(
     const std::shared_ptr<BCTools::BCFunction>& a_bcFuncPtr,
     const std::string                           a_scalarName) const
 {
+    PhaseTimer::Scope phaseTimer("Diffusion", m_level);
     const ProblemContext* ctx = ProblemContext::getInstance();
     CH_assert(ctx->rhs.doImplicitDiffusion);
     CH_assert(ctx->rhs.doTemperatureDiffusion);
@@ -1141,16 +1198,38 @@ AMRNSLevel::solveScalarDiffusion(
     }
 
     // Op = D[JgupKappa * G[T]], not scaled by 1/J!
-    std::shared_ptr<Elliptic::DiffusiveOp> opPtr(
-        new Elliptic::DiffusiveOp(*m_levGeoPtr,
-                                  this->getCrseGridsPtr(),
-                                  1.0,        // alpha
-                                  -a_gammaDt, // beta
-                                  a_vKappa,
-                                  a_eddyNu,
-                                  a_vEddyPrandtl,
-                                  a_bcFuncPtr,
-                                  a_phi.nComp()));
+    // Create or update the op. Without an eddy viscosity, the diffusivities
+    // are constant and only gammaDt and the BCs can change between solves.
+    std::shared_ptr<Elliptic::DiffusiveOp>& opPtr = m_diffusiveOpPtrs[a_scalarName];
+    if (!opPtr || opPtr->numComps() != a_phi.nComp()) {
+        opPtr.reset(
+            new Elliptic::DiffusiveOp(*m_levGeoPtr,
+                                      this->getCrseGridsPtr(),
+                                      1.0,        // alpha
+                                      -a_gammaDt, // beta
+                                      a_vKappa,
+                                      a_eddyNu,
+                                      a_vEddyPrandtl,
+                                      a_bcFuncPtr,
+                                      a_phi.nComp(),
+                                      ctx->rhs.diffusionRelaxMethod ==
+                                          RHSParameters::DiffusionRelaxMethod::VERTLINE));
+    } else if (ctx->rhs.eddyViscMethod[m_level] > 0) {
+        opPtr->setCoefficients(1.0,
+                               -a_gammaDt,
+                               a_vKappa,
+                               a_eddyNu,
+                               a_vEddyPrandtl,
+                               a_bcFuncPtr);
+    } else {
+        // The caller may hand us a different BC between solves.
+        if (opPtr->getBCFunction() != a_bcFuncPtr) {
+            opPtr->setBCFunction(a_bcFuncPtr);
+        }
+        if (opPtr->getBeta() != -a_gammaDt) {
+            opPtr->setAlphaAndBeta(1.0, -a_gammaDt);
+        }
+    }
 
     // Solver
     // Elliptic::MGSolver<LevelData<FArrayBox>> solver;
@@ -1250,54 +1329,63 @@ AMRNSLevel::incrementFluxRegisters(const StaggeredFluxLD& a_flux,
     if (RealCmp::isZero(a_refluxDt)) return;
 
     CH_assert(a_flux.getBoxes() == m_levGeoPtr->getBoxes());
-    DataIterator dit(a_flux.getBoxes());
+    if (!m_velFluxRegPtr && m_level == 0) return;
+
+    for (DataIterator dit(a_flux.getBoxes()); dit.ok(); ++dit) {
+        for (int velComp = 0; velComp < SpaceDim; ++velComp) {
+            for (int derivDir = 0; derivDir < SpaceDim; ++derivDir) {
+                this->incrementFluxRegisters(a_flux[derivDir][velComp][dit],
+                                             dit(),
+                                             velComp,
+                                             derivDir,
+                                             a_refluxDt);
+            } // derivDir
+        } // velComp
+    } // dit
+}
+
+
+// -----------------------------------------------------------------------------
+void
+AMRNSLevel::incrementFluxRegisters(const FArrayBox& a_fluxFAB,
+                                   const DataIndex& a_di,
+                                   const int        a_velComp,
+                                   const int        a_derivDir,
+                                   const Real       a_refluxDt)
+{
+    if (RealCmp::isZero(a_refluxDt)) return;
 
     // Increment flux register between this and the finer level.
     if (m_velFluxRegPtr) {
         const RealVect& crseDXi = m_levGeoPtr->getDXi();
-        for (dit.reset(); dit.ok(); ++dit) {
-            for (int velComp = 0; velComp < SpaceDim; ++velComp) {
-                for (int derivDir = 0; derivDir < SpaceDim; ++derivDir) {
-                    const Real scale = a_refluxDt / crseDXi[derivDir];
-                    for (SideIterator sit; sit.ok(); ++sit) {
-                        m_velFluxRegPtr->incrementCoarse(
-                            a_flux[derivDir][velComp][dit],
-                            scale,
-                            dit(),
-                            Interval(0,0),
-                            Interval(0,0),
-                            velComp,
-                            derivDir,
-                            sit());
-                    } // sit
-                } // derivDir
-            } // velComp
-        } // dit
+        const Real      scale   = a_refluxDt / crseDXi[a_derivDir];
+        for (SideIterator sit; sit.ok(); ++sit) {
+            m_velFluxRegPtr->incrementCoarse(a_fluxFAB,
+                                             scale,
+                                             a_di,
+                                             Interval(0,0),
+                                             Interval(0,0),
+                                             a_velComp,
+                                             a_derivDir,
+                                             sit());
+        } // sit
     }
 
     // Increment flux register between this and the coarser level.
     if (m_level > 0) {
         FluxRegisterFace* crseFRPtr = this->crseNSPtr()->m_velFluxRegPtr;
-        const RealVect& crseDXi = this->crseNSPtr()->m_levGeoPtr->getDXi();
-
-        for (dit.reset(); dit.ok(); ++dit) {
-            for (int velComp = 0; velComp < SpaceDim; ++velComp) {
-                for (int derivDir = 0; derivDir < SpaceDim; ++derivDir) {
-                    const Real scale = a_refluxDt / crseDXi[derivDir];
-                    for (SideIterator sit; sit.ok(); ++sit) {
-                        crseFRPtr->incrementFine(
-                            a_flux[derivDir][velComp][dit],
-                            scale,
-                            dit(),
-                            Interval(0,0),
-                            Interval(0,0),
-                            velComp,
-                            derivDir,
-                            sit());
-                    } // sit
-                } // derivDir
-            } // velComp
-        } // dit
+        const RealVect&   crseDXi   = this->crseNSPtr()->m_levGeoPtr->getDXi();
+        const Real        scale     = a_refluxDt / crseDXi[a_derivDir];
+        for (SideIterator sit; sit.ok(); ++sit) {
+            crseFRPtr->incrementFine(a_fluxFAB,
+                                     scale,
+                                     a_di,
+                                     Interval(0,0),
+                                     Interval(0,0),
+                                     a_velComp,
+                                     a_derivDir,
+                                     sit());
+        } // sit
     }
 }
 
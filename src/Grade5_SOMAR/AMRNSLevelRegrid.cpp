@@ -22,10 +22,13 @@
  *  https://github.com/MUON-CFD/SOMAR.
  ******************************************************************************/
 #include "AMRNSLevel.H"
+#include "AMRNSLevelF_F.H"
 #include "LoadBalance.H"
+#include "NodeLoadBalance.H"
 #include "SetValLevel.H"
 #include "Subspace.H"
 #include "Debug.H"
+#include <algorithm>
 #include <chrono>
 
 
@@ -36,6 +39,7 @@ void
 AMRNSLevel::tagCells(IntVectSet& a_tags)
 {
     BEGIN_FLOWCHART();
+    PhaseTimer::Scope phaseTimer("Tagging", m_level);
     TODONOTE("Clean up tagCells and create vorticity tagging.");
 
     // Gather and prepare data structures.
@@ -167,26 +171,40 @@ AMRNSLevel::tagCells(IntVectSet& a_tags)
 
     // Standard tagging...
 
+    // Tags are collected in a dense mask on each box and converted to an
+    // IntVectSet in bulk at the end. Inserting cells into the IntVectSet one
+    // at a time costs far more than evaluating the criteria.
+    // Tags can land one cell outside of the tag region, then growTags more.
+    LayoutData<BaseFab<int>> tagMasks(grids);
+    for (DataIterator dit(grids); dit.ok(); ++dit) {
+        const Box ccTagRegion = grids[dit] & domInteriorBox;
+        if (ccTagRegion.isEmpty()) continue;
+
+        tagMasks[dit].define(grow(ccTagRegion, 1 + Max(growTags, 0)), 1);
+        tagMasks[dit].setVal(0);
+    }
+
     // Tag on velocity differences
     const Real velTagTol = ctx->amr.velTagTol;
     if (velTagTol > 0.0) {
         for (DataIterator dit(grids); dit.ok(); ++dit) {
             const Box ccTagRegion = grids[dit] & domInteriorBox;
+            if (ccTagRegion.isEmpty()) continue;
+
+            BaseFab<int>& maskFAB = tagMasks[dit];
 
             for (int velComp = 0; velComp < SpaceDim; ++velComp) {
                 const IntVect    ef     = BASISV(velComp);
                 const FArrayBox& velFAB = m_statePtr->vel[dit][velComp];
-                const Box fcTagRegion = surroundingNodes(ccTagRegion, velComp);
-                Real vel0, dif;
 
                 if (totalRefRatio[velComp] > 1) {
-                    for(BoxIterator bit(ccTagRegion); bit.ok(); ++bit) {
-                        const IntVect& cc = bit();
-                        dif = abs(velFAB(cc+ef) - velFAB(cc));
-                        if (dif >= velTagTol) {
-                            a_tags |= cc;
-                        }
-                    } // bit
+                    FORT_TAGUNDIVIDEDDIFFERENCES(
+                        CHF_FIA1(maskFAB, 0),
+                        CHF_CONST_FRA1(velFAB, 0),
+                        CHF_CONST_REAL(velTagTol),
+                        CHF_BOX(ccTagRegion),
+                        CHF_CONST_INT(velComp),
+                        CHF_CONST_INTVECT(IntVect::Zero));
                 }
 
                 for (int diffOffset = 1; diffOffset < SpaceDim; ++diffOffset) {
@@ -195,57 +213,62 @@ AMRNSLevel::tagCells(IntVectSet& a_tags)
 
                     if (totalRefRatio[diffDir] == 1) continue; // Skip non-refined dirs.
 
-                    for(BoxIterator bit(fcTagRegion); bit.ok(); ++bit) {
-                        const IntVect& fc = bit();
-                        vel0 = velFAB(fc,0);
-
-                        dif = abs(velFAB(fc+ed) - vel0);
-                        if (dif >= velTagTol) {
-                            a_tags |= fc      + ed;
-                            a_tags |= fc          ;
-                            a_tags |= fc - ef + ed;
-                            a_tags |= fc - ef     ;
-                        }
-
-                        dif = abs(vel0 - velFAB(fc-ed,0));
-                        if (dif >= velTagTol) {
-                            a_tags |= fc          ;
-                            a_tags |= fc      - ed;
-                            a_tags |= fc - ef     ;
-                            a_tags |= fc - ef - ed;
-                        }
-                    } // bit
+                    // A difference between neighboring faces tags the four
+                    // cells that share the edge between them. The faces of
+                    // fcTagRegion are differenced with both neighbors.
+                    Box fcTagRegion = surroundingNodes(ccTagRegion, velComp);
+                    fcTagRegion.growLo(diffDir, 1);
+
+                    const IntVect tagShifts[4] = {IntVect::Zero, ed, -ef, ed - ef};
+                    for (const IntVect& tagShift : tagShifts) {
+                        FORT_TAGUNDIVIDEDDIFFERENCES(
+                            CHF_FIA1(maskFAB, 0),
+                            CHF_CONST_FRA1(velFAB, 0),
+                            CHF_CONST_REAL(velTagTol),
+                            CHF_BOX(fcTagRegion),
+                            CHF_CONST_INT(diffDir),
+                            CHF_CONST_INTVECT(tagShift));
+                    }
                 } // diffOffset, diffDir
             } // velComp
         } // dit
     }
 
     // Function to do tagging on generic CC data holder.
-    auto doQTagging = [&domInteriorBox, &a_tags, &totalRefRatio](
+    auto doQTagging = [&domInteriorBox, &tagMasks, &totalRefRatio](
                           const LevelData<FArrayBox>& a_q,
                           const Real                  a_tagTol) {
         if (a_tagTol > 0.0) {
             for (DataIterator dit = a_q.dataIterator(); dit.ok(); ++dit) {
                 const FArrayBox& qFAB = a_q[dit];
                 const Box tagRegion = a_q.getBoxes()[dit] & domInteriorBox;
+                if (tagRegion.isEmpty()) continue;
 
-                IntVect left, right;
-                Real dif;
+                BaseFab<int>& maskFAB = tagMasks[dit];
 
                 for (int dir = 0; dir < SpaceDim; ++dir) {
                     if (totalRefRatio[dir] == 1) continue; // Skip non-refined dirs.
 
-                    for (BoxIterator bit(tagRegion); bit.ok(); ++bit) {
-                        right = bit();
-                        left  = bit() - BASISV(dir);
-
-                        dif = abs(qFAB(right) - qFAB(left));
-
-                        if (dif >= a_tagTol) {
-                            a_tags |= left;
-                            a_tags |= right;
-                        }
-                    } // end loop over box
+                    // Compare each cell in tagRegion with its left neighbor
+                    // and tag both when they differ too much.
+                    Box leftRegion = tagRegion;
+                    leftRegion.shift(dir, -1);
+
+                    FORT_TAGUNDIVIDEDDIFFERENCES(
+                        CHF_FIA1(maskFAB, 0),
+                        CHF_CONST_FRA1(qFAB, 0),
+                        CHF_CONST_REAL(a_tagTol),
+                        CHF_BOX(leftRegion),
+                        CHF_CONST_INT(dir),
+                        CHF_CONST_INTVECT(IntVect::Zero));
+
+                    FORT_TAGUNDIVIDEDDIFFERENCES(
+                        CHF_FIA1(maskFAB, 0),
+                        CHF_CONST_FRA1(qFAB, 0),
+                        CHF_CONST_REAL(a_tagTol),
+                        CHF_BOX(leftRegion),
+                        CHF_CONST_INT(dir),
+                        CHF_CONST_INTVECT(BASISV(dir)));
                 } // end loop over difference dirs
             } // dit
         } // end if tagTol > 0
@@ -307,7 +330,46 @@ AMRNSLevel::tagCells(IntVectSet& a_tags)
     }
 
     // Finalize.
-    a_tags.grow(growTags);
+    for (DataIterator dit(grids); dit.ok(); ++dit) {
+        BaseFab<int>& maskFAB = tagMasks[dit];
+        const Box     maskBox = maskFAB.box();
+        if (maskBox.isEmpty()) continue;
+
+        // Grow the tags on the mask, one direction at a time.
+        if (growTags > 0) {
+            BaseFab<int> srcFAB(grow(maskBox, growTags), 1);
+            for (int dir = 0; dir < SpaceDim; ++dir) {
+                srcFAB.setVal(0);
+                srcFAB.copy(maskFAB);
+
+                FORT_DILATETAGMASK(CHF_FIA1(maskFAB, 0),
+                                   CHF_CONST_FIA1(srcFAB, 0),
+                                   CHF_BOX(maskBox),
+                                   CHF_CONST_INT(dir),
+                                   CHF_CONST_INT(growTags));
+            }
+        }
+
+        // Convert to an IntVectSet. DenseIntVectSet is a bitmask, so this
+        // is cheap, and a_tags only needs one union per box.
+        const Box denseBox = maskBox & domBox;
+        if (denseBox.isEmpty()) continue;
+
+        DenseIntVectSet boxTags(denseBox, false);
+        for (BoxIterator bit(denseBox); bit.ok(); ++bit) {
+            if (maskFAB(bit()) != 0) {
+                boxTags |= bit();
+            }
+        }
+
+        if (!boxTags.isEmpty()) {
+            a_tags |= IntVectSet(boxTags);
+        }
+    }
+
+    if (growTags < 0) {
+        a_tags.grow(growTags);
+    }
     a_tags &= domBox;
 }
 
@@ -324,6 +386,7 @@ AMRNSLevel::preRegrid(int                        a_lBase,
                       const Vector<Vector<Box>>& a_newGrids)
 {
     BEGIN_FLOWCHART();
+    PhaseTimer::Scope phaseTimer("Regrid", m_level);
 
     if (m_level > a_lBase) {
         if (a_newGrids[m_level].empty() && !this->m_isActivated) {
@@ -343,8 +406,28 @@ AMRNSLevel::preRegrid(int                        a_lBase,
         }
     }
 
+    // Will this level keep its grids? A level is rebuilt whenever a coarser
+    // level is, so every regridded level down to lBase + 1 must be unchanged.
+    m_keepGridsOnRegrid = (m_level > a_lBase && m_isActivated);
+    {
+        const AMRNSLevel* levPtr = this;
+        while (m_keepGridsOnRegrid && levPtr && levPtr->m_level > a_lBase) {
+            Vector<Box> newGrids = a_newGrids[levPtr->m_level];
+            mortonOrdering(newGrids);
+
+            const Vector<Box>& oldGrids = levPtr->m_level_grids;
+            m_keepGridsOnRegrid = (newGrids.size() == oldGrids.size());
+            for (size_t i = 0; m_keepGridsOnRegrid && i < newGrids.size(); ++i) {
+                m_keepGridsOnRegrid = (newGrids[i] == oldGrids[i]);
+            }
+
+            levPtr = levPtr->crseNSPtr();
+        }
+    }
+
     // Save all data that will be regridded.
-    if (m_level > a_lBase && !a_newGrids[m_level].empty() && m_levGeoPtr) {
+    if (m_level > a_lBase && !a_newGrids[m_level].empty() && m_levGeoPtr &&
+        !m_keepGridsOnRegrid) {
         const DisjointBoxLayout& grids = this->getBoxes();
 
         m_oldVelPtr.reset(new LevelData<FluxBox>(grids, m_velPtr->nComp(), m_velPtr->ghostVect()));
@@ -377,6 +460,7 @@ void
 AMRNSLevel::regrid(const Vector<Box>& a_new_grids)
 {
     BEGIN_FLOWCHART();
+    PhaseTimer::Scope phaseTimer("Regrid", m_level);
 
     if (s_verbosity >= 6) {
         pout() << "AMRNSLevel::regrid " << m_level
@@ -387,20 +471,135 @@ AMRNSLevel::regrid(const Vector<Box>& a_new_grids)
     // Check if level is inactive.
     if (a_new_grids.size() == 0) {
         this->deactivateLevel();
+    } else if (m_keepGridsOnRegrid && m_isActivated) {
+        // Nothing moved. The data, geometry, ops, and solvers stay as they are.
+        if (s_verbosity >= 3) {
+            pout() << "AMRNSLevel::regrid " << m_level
+                   << " grids are unchanged. Keeping level as is." << endl;
+        }
     } else {
         // Reallocate data holders, interpolators, etc...
         // WARNING: This deactivates all levels above *this!
         this->activateLevel(a_new_grids);
 
-        // Interpolate coarse-level data.
+        // Find the coarse regions that need to be interpolated. If this level
+        // already existed, only cells that were not covered by the old grids
+        // need coarse data. Everything else will be copied from the old data.
+        const DisjointBoxLayout& grids = this->getBoxes();
+        LayoutData<Vector<Box>>  crseInterpBoxes(grids);
+        long long                numCrseInterpCells = 0;
+        long long                numCrseCells       = 0;
         {
+            const IntVect& refRatio = m_cfInterpPtr->getRefRatio();
+
+            // The old grids' coarse footprints, sorted by their lower end in
+            // the direction they are spread across the most. A new box then
+            // only checks the old boxes that start within one box length of
+            // it in that direction, not every old box.
+            std::vector<Box> crseOldBoxes;
+            int              sweepDir = 0;
+            int              maxLen   = 0;
+            if (m_oldVelPtr) {
+                const DisjointBoxLayout& oldGrids = m_oldVelPtr->getBoxes();
+                for (LayoutIterator lit = oldGrids.layoutIterator(); lit.ok();
+                     ++lit) {
+                    // The old grids were refined from the same coarse
+                    // level, so their coarse footprints are exact.
+                    const Box crseOldBox = coarsen(oldGrids[lit], refRatio);
+                    CH_assert(refine(crseOldBox, refRatio) == oldGrids[lit]);
+                    crseOldBoxes.push_back(crseOldBox);
+                }
+
+                size_t maxNumStarts = 0;
+                for (int dir = 0; dir < SpaceDim; ++dir) {
+                    std::vector<int> starts;
+                    for (const Box& b : crseOldBoxes) {
+                        starts.push_back(b.smallEnd(dir));
+                    }
+                    std::sort(starts.begin(), starts.end());
+                    const size_t numStarts =
+                        std::unique(starts.begin(), starts.end()) - starts.begin();
+                    if (numStarts > maxNumStarts) {
+                        maxNumStarts = numStarts;
+                        sweepDir     = dir;
+                    }
+                }
+
+                std::sort(crseOldBoxes.begin(),
+                          crseOldBoxes.end(),
+                          [sweepDir](const Box& a_lhs, const Box& a_rhs) {
+                              return a_lhs.smallEnd(sweepDir)
+                                   < a_rhs.smallEnd(sweepDir);
+                          });
+                for (const Box& b : crseOldBoxes) {
+                    maxLen = std::max(maxLen, b.size(sweepDir));
+                }
+            }
+
+            for (DataIterator dit(grids); dit.ok(); ++dit) {
+                const Box    crseBox     = coarsen(grids[dit], refRatio);
+                Vector<Box>& interpBoxes = crseInterpBoxes[dit];
+                numCrseCells += crseBox.numPts();
+
+                if (!m_oldVelPtr) {
+                    interpBoxes.push_back(crseBox);
+                } else {
+                    IntVectSet uncovered(crseBox);
+
+                    const int firstStart = crseBox.smallEnd(sweepDir) - maxLen + 1;
+                    const int lastStart  = crseBox.bigEnd(sweepDir);
+                    auto it = std::lower_bound(
+                        crseOldBoxes.begin(),
+                        crseOldBoxes.end(),
+                        firstStart,
+                        [sweepDir](const Box& a_box, const int a_start) {
+                            return a_box.smallEnd(sweepDir) < a_start;
+                        });
+                    for (; it != crseOldBoxes.end() &&
+                           it->smallEnd(sweepDir) <= lastStart;
+                         ++it) {
+                        if (it->intersectsNotEmpty(crseBox)) {
+                            uncovered -= *it;
+                        }
+                    }
+
+                    if (!uncovered.isEmpty()) {
+                        interpBoxes = uncovered.boxes();
+                    }
+                }
+
+                for (const Box& b : interpBoxes) {
+                    numCrseInterpCells += b.numPts();
+                }
+            }
+
+#ifdef CH_MPI
+            long long counts[2] = {numCrseInterpCells, numCrseCells};
+            MPI_Allreduce(MPI_IN_PLACE, counts, 2, MPI_LONG_LONG,
+                          MPI_SUM, Chombo_MPI::comm);
+            numCrseInterpCells = counts[0];
+            numCrseCells       = counts[1];
+#endif
+        }
+
+        if (s_verbosity >= 3) {
+            pout() << "AMRNSLevel::regrid " << m_level
+                   << " interpolating " << numCrseInterpCells << " of "
+                   << numCrseCells << " coarse cells" << endl;
+        }
+
+        debugInitLevel(*m_velPtr);
+        debugInitLevel(*m_pPtr);
+        debugInitLevel(*m_qPtr);
+
+        // Interpolate coarse-level data. The coarse fills are collective, so
+        // this is skipped on all ranks or none.
+        if (numCrseInterpCells > 0) {
+            PhaseTimer::Scope interpTimer("Regrid interp", m_level);
+
             const AMRNSLevel*        crsePtr   = this->crseNSPtr();
             const DisjointBoxLayout& crseGrids = crsePtr->getBoxes();
 
-            debugInitLevel(*m_velPtr);
-            debugInitLevel(*m_pPtr);
-            debugInitLevel(*m_qPtr);
-
             // Get coarse vel and interpolate up.
             // Leave m_velPtr as advecting vel for now.
             {
@@ -410,7 +609,7 @@ AMRNSLevel::regrid(const Vector<Box>& a_new_grids)
                 crsePtr->fillVelocity(crseVel, m_time);
                 crsePtr->sendToAdvectingVelocity(crseVel, crseVel);
 
-                m_cfInterpPtr->refine(*m_velPtr, crseVel);
+                m_cfInterpPtr->refine(*m_velPtr, crseVel, crseInterpBoxes);
             }
 
             // Get coarse P and interpolate up.
@@ -420,7 +619,7 @@ AMRNSLevel::regrid(const Vector<Box>& a_new_grids)
                                            m_pPtr->nComp(),
                                            IntVect::Unit);
                 crsePtr->fillPressure(crseP, m_time, false);
-                m_cfInterpPtr->refine(*m_pPtr, crseP);
+                m_cfInterpPtr->refine(*m_pPtr, crseP, crseInterpBoxes);
             }
 
             // Get coarse Q and interpolate up.
@@ -445,12 +644,14 @@ AMRNSLevel::regrid(const Vector<Box>& a_new_grids)
                 aliasLevelData(crseS, &crseQ, crsePtr->m_statePtr->SInterval);
                 crsePtr->fillSalinity(crseS, m_time);
 
-                m_cfInterpPtr->refine(*m_qPtr, crseQ);
+                m_cfInterpPtr->refine(*m_qPtr, crseQ, crseInterpBoxes);
             }
         } // end interpolate up
 
         // Copy fine-level data where it already existed and free old storage.
         if (m_oldVelPtr) {
+            PhaseTimer::Scope copyTimer("Regrid copy", m_level);
+
             Copier oldToNewCopier;
             {
                 const DisjointBoxLayout& oldGrids = m_oldVelPtr->getBoxes();
@@ -475,6 +676,8 @@ AMRNSLevel::regrid(const Vector<Box>& a_new_grids)
         m_oldPPtr.reset();
         m_oldQPtr.reset();
     }
+
+    m_keepGridsOnRegrid = false;
 }
 
 
@@ -486,6 +689,7 @@ void
 AMRNSLevel::postRegrid(int a_lbase)
 {
     BEGIN_FLOWCHART();
+    PhaseTimer::Scope phaseTimer("Regrid", m_level);
 
     if (s_verbosity >= 3) {
         pout() << "AMRNSLevel::postRegrid on level " << m_level
@@ -494,16 +698,10 @@ AMRNSLevel::postRegrid(int a_lbase)
     const ProblemContext* ctx = ProblemContext::getInstance();
 
     // Validate the ops and solvers.
-    // This is a bit trickier than usual because a level may have been created,
-    // so be safe -- re-validate everything from lbase --> finest.
+    // Levels that were rebuilt, created, or removed have already invalidated
+    // themselves and the coarser levels that depend on them. Levels whose
+    // grids did not change keep their ops, MG hierarchies, and leptic grids.
     if (this->isFinestLevel()) {
-        AMRNSLevel* levPtr = this;
-        while (levPtr) {
-            levPtr->m_amrOpsValid       = false;
-            levPtr->m_levelSolversValid = false;
-            levPtr->m_amrSolversValid   = false;
-            levPtr = levPtr->crseNSPtr();
-        }
         this->coarsestNSPtr()->validateOpsAndSolvers();
     }
 
@@ -542,8 +740,51 @@ AMRNSLevel::loadBalance(const Vector<Box>& a_grids)
                << "  boxes=" << a_grids.size() << endl;
     }
 
+    const ProblemContext* ctx = ProblemContext::getInstance();
+
+    // Collective. Without measurements, the loads are the cell counts.
+    Vector<long long> loads;
+    Real              measuredImbalance;
+    const bool        haveCosts = BoxCostModel::estimateLoads(
+        loads, measuredImbalance, a_grids, m_level);
+
+    const bool byCost = ctx->amr.loadBalanceByCost && haveCosts;
+
     Vector<int> proc_map;
-    LoadBalance(proc_map, a_grids);
+    if (byCost) {
+        LoadBalance(proc_map, loads, a_grids);
+    } else {
+        LoadBalance(proc_map, a_grids);
+    }
+
+    // Collective. Keep neighboring boxes on the same node when we can.
+    if (ctx->amr.loadBalanceByNode) {
+        Vector<int> nodeProcMap;
+        if (byCost) {
+            NodeLoadBalance::balance(nodeProcMap, loads, a_grids);
+        } else {
+            NodeLoadBalance::balance(nodeProcMap, a_grids);
+        }
+
+        if (ctx->amr.reportNodeTraffic) {
+            NodeLoadBalance::printTraffic(pout(),
+                                          "Level " + std::to_string(m_level),
+                                          a_grids,
+                                          proc_map,
+                                          nodeProcMap);
+        }
+        proc_map = nodeProcMap;
+    }
+
+    if (s_verbosity >= 1) {
+        pout() << "Level " << m_level << " load imbalance (max / mean):";
+        if (measuredImbalance > 0.0) {
+            pout() << " measured on old grids = " << measuredImbalance << ",";
+        }
+        pout() << " predicted for new grids = "
+               << BoxCostModel::imbalance(loads, proc_map)
+               << (haveCosts ? " (measured costs)" : " (cell counts)") << endl;
+    }
 
     if (s_verbosity >= 5) {
         pout() << "AMRNSLevel::loadBalance: processor map: " << endl;
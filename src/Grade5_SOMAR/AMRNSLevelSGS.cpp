@@ -22,8 +22,27 @@
  *  https://github.com/MUON-CFD/SOMAR.
  ******************************************************************************/
 #include "AMRNSLevel.H"
+#include "LayoutTools.H"
 #include "AMRNSLevelF_F.H"
 #include "Convert.H"
+#include "ThreadTools.H"
+
+
+// -----------------------------------------------------------------------------
+// Compares LaplacianFilterCommAvoiding with LaplacianFilterPerSweep
+// -----------------------------------------------------------------------------
+#define DO_debugCheckCommAvoidingFilter_IN_DEBUG_MODE
+// #define DO_debugCheckCommAvoidingFilter_IN_RELEASE_MODE
+
+#if defined(NDEBUG)
+#   if defined(DO_debugCheckCommAvoidingFilter_IN_RELEASE_MODE)
+#       define DO_debugCheckCommAvoidingFilter
+#   endif
+#else
+#   if defined(DO_debugCheckCommAvoidingFilter_IN_DEBUG_MODE)
+#       define DO_debugCheckCommAvoidingFilter
+#   endif
+#endif
 
 
 // AMRNSLevel::rateOfStrain(StaggeredFluxLD&          a_Sia,
@@ -167,6 +186,8 @@ AMRNSLevel::computeEddyNu(LevelData<FArrayBox>&     a_eddyNu,
                           const LevelData<FluxBox>& a_cartVel,
                           const Real                a_time) const
 {
+    PhaseTimer::Scope phaseTimer("SGS", m_level);
+
     const auto* ctx            = ProblemContext::getInstance();
     const int   eddyViscMethod = ctx->rhs.eddyViscMethod[m_level];
 
@@ -194,8 +215,8 @@ AMRNSLevel::computeEddyNu(LevelData<FArrayBox>&     a_eddyNu,
     // For now, just extrapolate and exchange.
     // Someday, maybe interp at CFI if needed.
     BCTools::extrapAllGhosts(a_eddyNu, 2);
-    a_eddyNu.exchange(m_statePtr->qExCopier);
-    a_eddyNu.exchange(m_statePtr->qExCornerCopier);
+    LayoutTools::exchange(a_eddyNu, m_statePtr->qExCopier);
+    LayoutTools::exchange(a_eddyNu, m_statePtr->qExCornerCopier);
 }
 
 
@@ -209,6 +230,26 @@ AMRNSLevel::LaplacianFilter(LevelData<FArrayBox>& a_ccCartVel,
     CH_assert(a_ccCartVel.ghostVect() >= IntVect::Unit);
     CH_assert(a_numFilterSweeps > 0);
 
+    if (ProblemContext::getInstance()->rhs.commAvoidingFilter) {
+        this->LaplacianFilterCommAvoiding(
+            a_ccCartVel, a_numFilterSweeps, a_dirScale);
+    } else {
+        this->LaplacianFilterPerSweep(
+            a_ccCartVel, a_numFilterSweeps, a_dirScale);
+    }
+}
+
+
+// -----------------------------------------------------------------------------
+void
+AMRNSLevel::LaplacianFilterPerSweep(LevelData<FArrayBox>& a_ccCartVel,
+                                    const int             a_numFilterSweeps,
+                                    const RealVect&       a_dirScale) const
+{
+    CH_assert(a_ccCartVel.getBoxes() == this->getBoxes());
+    CH_assert(a_ccCartVel.ghostVect() >= IntVect::Unit);
+    CH_assert(a_numFilterSweeps > 0);
+
     const DisjointBoxLayout& grids = this->getBoxes();
 
     LevelData<FArrayBox>* filtVelPtr = &a_ccCartVel;
@@ -231,6 +272,9 @@ AMRNSLevel::LaplacianFilter(LevelData<FArrayBox>& a_ccCartVel,
     //
     // When this block is complete, *filtVelPtr will contain the filtered
     // velocity.
+    const DataIterator dit      = grids.dataIterator();
+    const int          numBoxes = dit.size();
+
     for (int iter = 0; iter < a_numFilterSweeps; ++iter) {
         // Put filtered velocity into *origVelPtr.
         // *filtVelPtr will be overwritten in this iter.
@@ -238,10 +282,13 @@ AMRNSLevel::LaplacianFilter(LevelData<FArrayBox>& a_ccCartVel,
         debugInitLevel(*filtVelPtr);
 
         // Filter once, filling *filtVelPtr.
-        for (DataIterator dit(grids); dit.ok(); ++dit) {
-            FArrayBox&       filtFAB = (*filtVelPtr)[dit];
-            const FArrayBox& origFAB = (*origVelPtr)[dit];
-            const Box&       valid   = grids[dit];
+        OMP_PARALLEL_FOR
+        for (int ibox = 0; ibox < numBoxes; ++ibox) {
+            const DataIndex& di = dit[ibox];
+
+            FArrayBox&       filtFAB = (*filtVelPtr)[di];
+            const FArrayBox& origFAB = (*origVelPtr)[di];
+            const Box&       valid   = grids[di];
 
             FORT_FILTER_LAPLACIAN (
                 CHF_FRA(filtFAB),
@@ -256,9 +303,11 @@ AMRNSLevel::LaplacianFilter(LevelData<FArrayBox>& a_ccCartVel,
 
     // Copy back to user's holder, if needed.
     if (filtVelPtr != &a_ccCartVel) {
-        for (DataIterator dit(grids); dit.ok(); ++dit) {
-            FArrayBox&       destFAB = a_ccCartVel[dit];
-            const FArrayBox& srcFAB  = (*filtVelPtr)[dit];
+        OMP_PARALLEL_FOR
+        for (int ibox = 0; ibox < numBoxes; ++ibox) {
+            const DataIndex& di      = dit[ibox];
+            FArrayBox&       destFAB = a_ccCartVel[di];
+            const FArrayBox& srcFAB  = (*filtVelPtr)[di];
 
             destFAB.copy(srcFAB);
         }
@@ -266,6 +315,149 @@ AMRNSLevel::LaplacianFilter(LevelData<FArrayBox>& a_ccCartVel,
 }
 
 
+// -----------------------------------------------------------------------------
+void
+AMRNSLevel::LaplacianFilterCommAvoiding(LevelData<FArrayBox>& a_ccCartVel,
+                                        const int             a_numFilterSweeps,
+                                        const RealVect&       a_dirScale) const
+{
+    CH_assert(a_ccCartVel.getBoxes() == this->getBoxes());
+    CH_assert(a_ccCartVel.ghostVect() >= IntVect::Unit);
+    CH_assert(a_numFilterSweeps > 0);
+
+    const DisjointBoxLayout& grids = this->getBoxes();
+    const DataIterator       dit      = grids.dataIterator();
+    const int                numBoxes = dit.size();
+    const int                numComps = a_ccCartVel.nComp();
+
+    // A sweep reads 1 cell beyond its region, or 2 cells on the far side of
+    // a BC ghost. Such a ghost can sit in the middle of another box's valid
+    // data (a CFI hole), so each sweep's region must shrink by 2. The final
+    // sweep must fill 1 ghost layer.
+    const int     stencilRadius = 2;
+    const IntVect ghostVect =
+        (stencilRadius * a_numFilterSweeps + 1) * IntVect::Unit;
+
+#ifdef DO_debugCheckCommAvoidingFilter
+    LevelData<FArrayBox> refVel(grids, numComps, a_ccCartVel.ghostVect());
+    for (int ibox = 0; ibox < numBoxes; ++ibox) {
+        const DataIndex& di = dit[ibox];
+        refVel[di].copy(a_ccCartVel[di]);
+    }
+    this->LaplacianFilterPerSweep(refVel, a_numFilterSweeps, a_dirScale);
+#endif
+
+    // The workspace only lives for this call. With wide filters, keeping it
+    // around would cost more memory than the state itself.
+    //
+    // The last component of buf0 is the mask. It is 1 where the filter has
+    // data to work with: valid cells and ghosts that overlap another box's
+    // (or a periodic image's) valid cells. Physical boundary and CFI ghosts
+    // are left at 0. The mask rides along with the velocity's exchange, and
+    // the sweeps never write to it.
+    LevelData<FArrayBox> buf0(grids, numComps + 1, ghostVect);
+    LevelData<FArrayBox> buf1(grids, numComps, ghostVect);
+
+    LevelData<FArrayBox> vel0, mask;
+    aliasLevelData(vel0, &buf0, Interval(0, numComps - 1));
+    aliasLevelData(mask, &buf0, Interval(numComps, numComps));
+
+    LevelData<FArrayBox>* origVelPtr = &vel0;
+    LevelData<FArrayBox>* filtVelPtr = &buf1;
+
+    // This is the only exchange. After this, all sweeps are local.
+    OMP_PARALLEL_FOR
+    for (int ibox = 0; ibox < numBoxes; ++ibox) {
+        const DataIndex& di = dit[ibox];
+        buf0[di].copy(a_ccCartVel[di], grids[di], 0, grids[di], 0, numComps);
+        mask[di].setVal(0.0);
+        mask[di].setVal(1.0, grids[di], 0);
+    }
+    buf0.exchange();
+
+    // Each sweep leaves correct data two layers closer to the valid region.
+    // The mask tells the kernel which neighbors are BC ghosts. There, it uses
+    // the same one-sided second difference that extrapAllGhosts(..., 2)
+    // would have produced in LaplacianFilter.
+    for (int iter = 0; iter < a_numFilterSweeps; ++iter) {
+        if (iter > 0) std::swap(filtVelPtr, origVelPtr);
+        debugInitLevel(*filtVelPtr);
+
+        const int growBy = stencilRadius * (a_numFilterSweeps - 1 - iter) + 1;
+
+        OMP_PARALLEL_FOR
+        for (int ibox = 0; ibox < numBoxes; ++ibox) {
+            const DataIndex& di = dit[ibox];
+
+            FArrayBox&          filtFAB = (*filtVelPtr)[di];
+            const FArrayBox&    origFAB = (*origVelPtr)[di];
+            const FArrayBox&    maskFAB = mask[di];
+            const Box           region  = grow(grids[di], growBy);
+
+            FORT_FILTER_LAPLACIANMASKED (
+                CHF_FRA(filtFAB),
+                CHF_CONST_FRA(origFAB),
+                CHF_CONST_FRA1(maskFAB, 0),
+                CHF_BOX(region),
+                CHF_CONST_REALVECT(a_dirScale));
+        } // end loop over grids (dit)
+    } // end loop over filter iters (iter)
+
+    // Copy back to user's holder. Physical boundary and CFI ghosts are
+    // extrapolated, just as before. The remaining first-layer ghosts were
+    // computed redundantly by the last sweep and replace the final exchange.
+    OMP_PARALLEL_FOR
+    for (int ibox = 0; ibox < numBoxes; ++ibox) {
+        const DataIndex& di = dit[ibox];
+        a_ccCartVel[di].copy((*filtVelPtr)[di], grids[di]);
+    }
+
+    BCTools::extrapAllGhosts(a_ccCartVel, 2);
+
+    OMP_PARALLEL_FOR
+    for (int ibox = 0; ibox < numBoxes; ++ibox) {
+        const DataIndex& di = dit[ibox];
+
+        FArrayBox&          destFAB  = a_ccCartVel[di];
+        const FArrayBox&    srcFAB   = (*filtVelPtr)[di];
+        const FArrayBox&    maskFAB  = mask[di];
+        const Box&          valid    = grids[di];
+        const Box           ghostBox = grow(valid, 1) & destFAB.box();
+
+        for (BoxIterator bit(ghostBox); bit.ok(); ++bit) {
+            const IntVect& cc = bit();
+            if (maskFAB(cc) == 0.0 || valid.contains(cc)) continue;
+
+            for (int comp = 0; comp < numComps; ++comp) {
+                destFAB(cc, comp) = srcFAB(cc, comp);
+            }
+        }
+    }
+
+#ifdef DO_debugCheckCommAvoidingFilter
+    // The kernels group their sums differently, so allow for roundoff.
+    Real maxDiff = 0.0;
+    Real maxVal  = 0.0;
+    for (int ibox = 0; ibox < numBoxes; ++ibox) {
+        const DataIndex& di     = dit[ibox];
+        const Box        region = grow(grids[di], 1) & a_ccCartVel[di].box();
+
+        FArrayBox diffFAB(region, numComps);
+        diffFAB.copy(a_ccCartVel[di]);
+        diffFAB.minus(refVel[di], region, 0, 0, numComps);
+
+        maxDiff = std::max(maxDiff, diffFAB.norm(region, 0, 0, numComps));
+        maxVal  = std::max(maxVal, refVel[di].norm(region, 0, 0, numComps));
+    }
+    if (maxDiff > 1.0e-10 * std::max(maxVal, 1.0)) {
+        MAYDAYERROR("LaplacianFilterCommAvoiding differs from "
+                    "LaplacianFilterPerSweep by "
+                    << maxDiff << " (max |vel| = " << maxVal << ").");
+    }
+#endif
+}
+
+
 // -----------------------------------------------------------------------------
 void
 AMRNSLevel::SGSModel_Ducros(LevelData<FArrayBox>&     a_nuT,
@@ -285,30 +477,39 @@ AMRNSLevel::SGSModel_Ducros(LevelData<FArrayBox>&     a_nuT,
     const RealVect&          dXi   = m_levGeoPtr->getDXi();
     const DisjointBoxLayout& grids = this->getBoxes();
 
+    const DataIterator dit      = grids.dataIterator();
+    const int          numBoxes = dit.size();
+
     // Create CC vel.
     LevelData<FArrayBox> ccVel(grids, SpaceDim, IntVect::Unit);
-    for (DataIterator dit(grids); dit.ok(); ++dit) {
+    OMP_PARALLEL_FOR
+    for (int ibox = 0; ibox < numBoxes; ++ibox) {
+        const DataIndex& di = dit[ibox];
+
         for (int dir = 0; dir < SpaceDim; ++dir) {
-            FArrayBox fcVelCompFAB(a_cartVel[dit][dir].box(), 1);
-            fcVelCompFAB.copy(a_cartVel[dit][dir]);
+            FArrayBox fcVelCompFAB(a_cartVel[di][dir].box(), 1);
+            fcVelCompFAB.copy(a_cartVel[di][dir]);
 
-            m_levGeoPtr->multByJ(fcVelCompFAB, dit());
-            Convert::Simple(ccVel[dit], dir, grids[dit], fcVelCompFAB, 0);
-            m_levGeoPtr->divByJ(ccVel[dit], dit(), dir);
+            m_levGeoPtr->multByJ(fcVelCompFAB, di);
+            Convert::Simple(ccVel[di], dir, grids[di], fcVelCompFAB, 0);
+            m_levGeoPtr->divByJ(ccVel[di], di, dir);
         }
     }
     BCTools::extrapAllGhosts(ccVel, 2);  // Properly setting BCs increases nuT at the CFI.
-    ccVel.exchange();
+    LayoutTools::exchange(ccVel);
 
     // Filter the CC velocity.
     this->LaplacianFilter(ccVel, a_numFilterSweeps, a_dirScale);
 
     // Compute the eddy viscosity.
-    for (DataIterator dit(grids); dit.ok(); ++dit) {
-        FArrayBox&       nuTFAB  = a_nuT[dit];
-        const FArrayBox& velFAB  = ccVel[dit];
-        const FArrayBox& ccJFAB  = m_levGeoPtr->getCCJ()[dit];
-        const Box&       ccValid = grids[dit];
+    OMP_PARALLEL_FOR
+    for (int ibox = 0; ibox < numBoxes; ++ibox) {
+        const DataIndex& di = dit[ibox];
+
+        FArrayBox&       nuTFAB  = a_nuT[di];
+        const FArrayBox& velFAB  = ccVel[di];
+        const FArrayBox& ccJFAB  = m_levGeoPtr->getCCJ()[di];
+        const Box&       ccValid = grids[di];
 
         // In 2D, only vel comps 0 and 1 will be used.
         FORT_SGSMODEL_DUCROS (
@@ -323,6 +524,6 @@ AMRNSLevel::SGSModel_Ducros(LevelData<FArrayBox>&     a_nuT,
     }
 
     BCTools::extrapAllGhosts(a_nuT, 2);
-    a_nuT.exchange();
+    LayoutTools::exchange(a_nuT);
 }
 
@@ -112,6 +112,8 @@ ProjectorParameters::dump() const
     pout() << "bottom_normType = " << bottom_normType << "\n";
     pout() << "bottom_verbosity = " << bottom_verbosity << "\n";
     pout() << "bottom_numSmoothPrecond = " << bottom_numSmoothPrecond << "\n";
+    pout() << "agglomerateBelow = " << agglomerateBelow << "\n";
+    pout() << "agglomerateProcs = " << agglomerateProcs << "\n";
 
     pout() << Format::unindent << std::endl;
 }
@@ -217,6 +219,13 @@ ProjectorParameters::createDefaults()
     s_defPtr->bottom_numSmoothPrecond = 2;
     pp.query("bottom_numSmoothPrecond", s_defPtr->bottom_numSmoothPrecond);
 
+    s_defPtr->agglomerateBelow = -1;
+    pp.query("agglomerateBelow", s_defPtr->agglomerateBelow);
+
+    s_defPtr->agglomerateProcs = 1;
+    pp.query("agglomerateProcs", s_defPtr->agglomerateProcs);
+    CH_verify(s_defPtr->agglomerateProcs >= 1);
+
     // Send defaults to pout.
     s_defPtr->dump();
 }
@@ -88,6 +88,14 @@ RHSParameters::dump() const
 
 
     pout() << "doImplicitDiffusion = " << doImplicitDiffusion << '\n';
+    if (doImplicitDiffusion) {
+        pout() << "diffusionRelaxMethod = ";
+        switch (diffusionRelaxMethod) {
+            case DiffusionRelaxMethod::GSRB:     pout() << "GSRB\n";     break;
+            case DiffusionRelaxMethod::VERTLINE: pout() << "VERTLINE\n"; break;
+            default:                             pout() << "UNKNOWN\n";  break;
+        }
+    }
 
     pout() << "velBCTypeLo = (";
     for (int dir = 0; dir < SpaceDim; ++dir) {
@@ -231,6 +239,8 @@ RHSParameters::dump() const
     pout() << "eddyPrandtlS = " << eddyPrandtlS << "\n";
     pout() << "eddyPrandtlScalars = " << eddyPrandtlScalars << "\n";
     pout() << "eddyScale = " << eddyScale << "\n";
+    pout() << "commAvoidingFilter = "
+           << (commAvoidingFilter ? "true" : "false") << "\n";
 
     if (velReconstruction == Reconstruction::SecondOrder) {
         pout() << "velReconstruction = SecondOrder\n";
@@ -249,6 +259,8 @@ RHSParameters::dump() const
     }
 
     pout() << "momAdvSkewness = " << momAdvSkewness << '\n';
+    pout() << "fuseMomentumAdvection = "
+           << (fuseMomentumAdvection ? "true" : "false") << "\n";
 
     pout() << "doMomentumAdvection = "
            << (doMomentumAdvection ? "true" : "false") << "\n";
@@ -387,6 +399,14 @@ RHSParameters::createDefaults(const BaseParameters& a_baseParams,
     s_defPtr->doImplicitDiffusion = false;
     pp.query("doImplicitDiffusion", s_defPtr->doImplicitDiffusion);
 
+    s_defPtr->diffusionRelaxMethod = DiffusionRelaxMethod::GSRB;
+    pp.query("diffusionRelaxMethod", s_defPtr->diffusionRelaxMethod);
+    if (s_defPtr->diffusionRelaxMethod < 0 ||
+        s_defPtr->diffusionRelaxMethod >=
+            DiffusionRelaxMethod::_NUM_DIFFUSIONRELAXMETHODS) {
+        MAYDAYERROR("rhs.diffusionRelaxMethod must be 0 (GSRB) or 1 (VERTLINE).");
+    }
+
     if (pp.queryarr("coriolisF", vreal, 0, SpaceDim)) {
         s_defPtr->coriolisF = RealVect(vreal);
     } else {
@@ -555,6 +575,9 @@ RHSParameters::createDefaults(const BaseParameters& a_baseParams,
             RealVect(D_DECL(quietNAN, quietNAN, quietNAN));
     }
 
+    s_defPtr->commAvoidingFilter = false;
+    pp.query("commAvoidingFilter", s_defPtr->commAvoidingFilter);
+
     s_defPtr->velReconstruction = Reconstruction::FourthOrder;
     {
         int order = 4;
@@ -592,6 +615,9 @@ RHSParameters::createDefaults(const BaseParameters& a_baseParams,
                          "and 1 (advective form).");
     }
 
+    s_defPtr->fuseMomentumAdvection = true;
+    pp.query("fuseMomentumAdvection", s_defPtr->fuseMomentumAdvection);
+
     s_defPtr->doMomentumAdvection = true;
     pp.query("doMomentumAdvection", s_defPtr->doMomentumAdvection);
 
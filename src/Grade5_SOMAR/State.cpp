@@ -23,6 +23,7 @@
  ******************************************************************************/
 #include "State.H"
 #include "BoxLayoutData.H"
+#include "CopierCache.H"
 #include "Debug.H"
 #include "LoHiSide.H"
 
@@ -282,7 +283,7 @@ State::velDefineExCopier(std::array<StaggeredCopier, CH_SPACEDIM>& a_exCopier,
 {
     for (int d = 0; d < SpaceDim; ++d) {
         constexpr bool doValidCorners = true;
-        a_exCopier[d].defineValidExchange(
+        a_exCopier[d] = *CopierCache::validExchangeCopier(
             a_vel.getBoxes(), a_vel.ghostVect(), d, doValidCorners);
     }
 }
@@ -296,8 +297,8 @@ void
 State::pDefineExCopier(Copier&                     a_exCopier,
                        const LevelData<FArrayBox>& a_p) const
 {
-    a_exCopier.exchangeDefine(a_p.getBoxes(), a_p.ghostVect());
-    a_exCopier.trimEdges(a_p.getBoxes(), a_p.ghostVect());
+    a_exCopier = *CopierCache::trimmedExchangeCopier(a_p.getBoxes(),
+                                                     a_p.ghostVect());
 }
 
 
@@ -309,8 +310,8 @@ void
 State::qDefineExCopier(Copier&                     a_exCopier,
                        const LevelData<FArrayBox>& a_q) const
 {
-    a_exCopier.exchangeDefine(a_q.getBoxes(), a_q.ghostVect());
-    a_exCopier.trimEdges(a_q.getBoxes(), a_q.ghostVect());
+    a_exCopier = *CopierCache::trimmedExchangeCopier(a_q.getBoxes(),
+                                                     a_q.ghostVect());
 }
 
 
@@ -323,7 +324,7 @@ State::velDefineExCornerCopier1(
     const LevelData<FluxBox>&                 a_vel) const
 {
     for (int d = 0; d < SpaceDim; ++d) {
-        a_exCopier[d].defineInvalidCornerExchange1(
+        a_exCopier[d] = *CopierCache::invalidCornerExchangeCopier1(
             a_vel.getBoxes(), a_vel.ghostVect(), d);
     }
 }
@@ -338,7 +339,7 @@ State::velDefineExCornerCopier2(
     const LevelData<FluxBox>&                 a_vel) const
 {
     for (int d = 0; d < SpaceDim; ++d) {
-        a_exCopier[d].defineInvalidCornerExchange2(
+        a_exCopier[d] = *CopierCache::invalidCornerExchangeCopier2(
             a_vel.getBoxes(), a_vel.ghostVect(), d);
     }
 }
@@ -351,11 +352,8 @@ void
 State::pDefineExCornerCopier(CornerCopier&               a_exCopier,
                              const LevelData<FArrayBox>& a_p) const
 {
-    // The underscores prevent shadowing member variables.
-    const DisjointBoxLayout& _grids     = a_p.getBoxes();
-    const ProblemDomain&     _domain    = _grids.physDomain();
-    const IntVect&           _ghostVect = a_p.ghostVect();
-    a_exCopier.define(_grids, _grids, _domain, _ghostVect, true);
+    a_exCopier = *CornerCopier::cachedExchangeCopier(a_p.getBoxes(),
+                                                     a_p.ghostVect());
 }
 
 
@@ -366,9 +364,6 @@ void
 State::qDefineExCornerCopier(CornerCopier&               a_exCopier,
                              const LevelData<FArrayBox>& a_q) const
 {
-    // The underscores prevent shadowing member variables.
-    const DisjointBoxLayout& _grids     = a_q.getBoxes();
-    const ProblemDomain&     _domain    = _grids.physDomain();
-    const IntVect&           _ghostVect = a_q.ghostVect();
-    a_exCopier.define(_grids, _grids, _domain, _ghostVect, true);
+    a_exCopier = *CornerCopier::cachedExchangeCopier(a_q.getBoxes(),
+                                                     a_q.ghostVect());
 }